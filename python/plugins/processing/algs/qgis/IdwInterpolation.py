@@ -50,6 +50,8 @@ class IdwInterpolation(QgisAlgorithm):
 
     INTERPOLATION_DATA = 'INTERPOLATION_DATA'
     DISTANCE_COEFFICIENT = 'DISTANCE_COEFFICIENT'
+    SEARCH_RADIUS = 'SEARCH_RADIUS'
+    MAX_NEIGHBORS = 'MAX_NEIGHBORS'
     PIXEL_SIZE = 'PIXEL_SIZE'
     COLUMNS = 'COLUMNS'
     ROWS = 'ROWS'
@@ -75,6 +77,16 @@ class IdwInterpolation(QgisAlgorithm):
         self.addParameter(QgsProcessingParameterNumber(self.DISTANCE_COEFFICIENT,
                                                        self.tr('Distance coefficient P'), type=QgsProcessingParameterNumber.Double,
                                                        minValue=0.0, maxValue=99.99, defaultValue=2.0))
+        search_radius_param = QgsProcessingParameterNumber(self.SEARCH_RADIUS,
+                                                           self.tr('Search radius (0 to use all points)'), type=QgsProcessingParameterNumber.Double,
+                                                           minValue=0.0, defaultValue=0.0, optional=True)
+        search_radius_param.setFlags(search_radius_param.flags() | QgsProcessingParameterDefinition.FlagAdvanced)
+        self.addParameter(search_radius_param)
+        max_neighbors_param = QgsProcessingParameterNumber(self.MAX_NEIGHBORS,
+                                                           self.tr('Maximum number of nearest points (0 to use all points)'),
+                                                           minValue=0, defaultValue=0, optional=True)
+        max_neighbors_param.setFlags(max_neighbors_param.flags() | QgsProcessingParameterDefinition.FlagAdvanced)
+        self.addParameter(max_neighbors_param)
         self.addParameter(QgsProcessingParameterExtent(self.EXTENT,
                                                        self.tr('Extent'),
                                                        optional=False))
@@ -112,6 +124,8 @@ class IdwInterpolation(QgisAlgorithm):
     def processAlgorithm(self, parameters, context, feedback):
         interpolationData = ParameterInterpolationData.parseValue(parameters[self.INTERPOLATION_DATA])
         coefficient = self.parameterAsDouble(parameters, self.DISTANCE_COEFFICIENT, context)
+        search_radius = self.parameterAsDouble(parameters, self.SEARCH_RADIUS, context)
+        max_neighbors = self.parameterAsInt(parameters, self.MAX_NEIGHBORS, context)
         bbox = self.parameterAsExtent(parameters, self.EXTENT, context)
         pixel_size = self.parameterAsDouble(parameters, self.PIXEL_SIZE, context)
         output = self.parameterAsOutputLayer(parameters, self.OUTPUT, context)
@@ -150,6 +164,8 @@ class IdwInterpolation(QgisAlgorithm):
 
         interpolator = QgsIDWInterpolator(layerData)
         interpolator.setDistanceCoefficient(coefficient)
+        interpolator.setSearchRadius(search_radius)
+        interpolator.setMaximumNeighbors(max_neighbors)
 
         writer = QgsGridFileWriter(interpolator,
                                    output,
@@ -31,7 +31,6 @@ from qgis.PyQt.QtGui import QIcon
 from qgis.PyQt.QtCore import QVariant
 
 from qgis.core import (QgsApplication,
-                       QgsGeometry,
                        QgsFeatureSink,
                        QgsFeatureRequest,
                        QgsFeature,
@@ -141,8 +140,7 @@ class PointsInPolygon(QgisAlgorithm):
             output_feature = QgsFeature()
             if polygon_feature.hasGeometry():
                 geom = polygon_feature.geometry()
-                engine = QgsGeometry.createGeometryEngine(geom.constGet())
-                engine.prepareGeometry()
+                geom.prepare()
 
                 count = 0
                 classes = set()
@@ -153,7 +151,7 @@ class PointsInPolygon(QgisAlgorithm):
                     if feedback.isCanceled():
                         break
 
-                    if engine.contains(point_feature.geometry().constGet()):
+                    if geom.contains(point_feature.geometry()):
                         if weight_field_index >= 0:
                             weight = point_feature[weight_field_index]
                             try:
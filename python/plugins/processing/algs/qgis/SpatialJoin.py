@@ -32,7 +32,6 @@ from qgis.PyQt.QtGui import QIcon
 from qgis.core import (QgsFields,
                        QgsFeatureSink,
                        QgsFeatureRequest,
-                       QgsGeometry,
                        QgsProcessing,
                        QgsProcessingUtils,
                        QgsProcessingException,
@@ -75,7 +74,7 @@ class SpatialJoin(QgisAlgorithm):
         self.predicates = (
             ('intersects', self.tr('intersects')),
             ('contains', self.tr('contains')),
-            ('isEqual', self.tr('equals')),
+            ('isGeosEqual', self.tr('equals')),
             ('touches', self.tr('touches')),
             ('overlaps', self.tr('overlaps')),
             ('within', self.tr('within')),
@@ -83,7 +82,7 @@ class SpatialJoin(QgisAlgorithm):
 
         self.reversed_predicates = {'intersects': 'intersects',
                                     'contains': 'within',
-                                    'isEqual': 'isEqual',
+                                    'isGeosEqual': 'isGeosEqual',
                                     'touches': 'touches',
                                     'overlaps': 'overlaps',
                                     'within': 'contains',
@@ -221,8 +220,9 @@ class SpatialJoin(QgisAlgorithm):
             if not f.hasGeometry():
                 continue
 
-            bbox = f.geometry().boundingBox()
-            engine = None
+            geometry = f.geometry()
+            bbox = geometry.boundingBox()
+            prepared = False
 
             request = QgsFeatureRequest().setFilterRect(bbox)
             for test_feat in source.getFeatures(request):
@@ -236,12 +236,12 @@ class SpatialJoin(QgisAlgorithm):
                 for a in join_field_indexes:
                     join_attributes.append(f[a])
 
-                if engine is None:
-                    engine = QgsGeometry.createGeometryEngine(f.geometry().constGet())
-                    engine.prepareGeometry()
+                if not prepared:
+                    geometry.prepare()
+                    prepared = True
 
                 for predicate in predicates:
-                    if getattr(engine, predicate)(test_feat.geometry().constGet()):
+                    if getattr(geometry, predicate)(test_feat.geometry()):
                         added_set.add(test_feat.id())
 
                         if sink is not None:
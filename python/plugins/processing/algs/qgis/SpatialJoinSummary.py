@@ -37,7 +37,6 @@ from qgis.core import (NULL,
                        QgsFields,
                        QgsFeatureSink,
                        QgsFeatureRequest,
-                       QgsGeometry,
                        QgsCoordinateTransform,
                        QgsStatisticalSummary,
                        QgsDateTimeStatisticalSummary,
@@ -85,7 +84,7 @@ class SpatialJoinSummary(QgisAlgorithm):
         self.predicates = (
             ('intersects', self.tr('intersects')),
             ('contains', self.tr('contains')),
-            ('isEqual', self.tr('equals')),
+            ('isGeosEqual', self.tr('equals')),
             ('touches', self.tr('touches')),
             ('overlaps', self.tr('overlaps')),
             ('within', self.tr('within')),
@@ -294,8 +293,9 @@ class SpatialJoinSummary(QgisAlgorithm):
                     sink.addFeature(f, QgsFeatureSink.FastInsert)
                 continue
 
-            bbox = bbox_transform.transformBoundingBox(f.geometry().boundingBox())
-            engine = None
+            geometry = f.geometry()
+            bbox = bbox_transform.transformBoundingBox(geometry.boundingBox())
+            prepared = False
 
             values = []
 
@@ -308,12 +308,12 @@ class SpatialJoinSummary(QgisAlgorithm):
                 for a in join_field_indexes:
                     join_attributes.append(test_feat[a])
 
-                if engine is None:
-                    engine = QgsGeometry.createGeometryEngine(f.geometry().constGet())
-                    engine.prepareGeometry()
+                if not prepared:
+                    geometry.prepare()
+                    prepared = True
 
                 for predicate in predicates:
-                    if getattr(engine, predicate)(test_feat.geometry().constGet()):
+                    if getattr(geometry, predicate)(test_feat.geometry()):
                         values.append(join_attributes)
                         break
 
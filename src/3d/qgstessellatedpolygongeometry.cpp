@@ -18,6 +18,8 @@
 #include <Qt3DRender/QAttribute>
 #include <Qt3DRender/QBuffer>
 #include <Qt3DRender/QBufferDataGenerator>
+#include <QtConcurrentMap>
+#include <algorithm>
 
 #include "qgstessellator.h"
 
@@ -62,23 +64,55 @@ void QgsTessellatedPolygonGeometry::setPolygons( const QList<QgsPolygon *> &poly
   mTriangleIndexStartingIndices.reserve( polygons.count() );
   mTriangleIndexFids.reserve( polygons.count() );
 
-  QgsTessellator tessellator( origin.x(), origin.y(), mWithNormals, mInvertNormals, mAddBackFaces );
+  // polygons are tessellated in parallel, their triangles are then copied to the vertex buffer in order
+  struct TessellationJob
+  {
+    const QgsPolygon *polygon = nullptr;
+    float extrusionHeight = 0;
+    QVector<float> data;
+  };
+
+  QVector< TessellationJob > jobs( polygons.count() );
   for ( int i = 0; i < polygons.count(); ++i )
   {
-    Q_ASSERT( tessellator.dataVerticesCount() % 3 == 0 );
-    uint startingTriangleIndex = static_cast<uint>( tessellator.dataVerticesCount() / 3 );
+    jobs[i].polygon = polygons.at( i );
+    jobs[i].extrusionHeight = extrusionHeightPerPolygon.isEmpty() ? extrusionHeight : extrusionHeightPerPolygon.at( i );
+  }
+
+  const bool withNormals = mWithNormals;
+  const bool invertNormals = mInvertNormals;
+  const bool addBackFaces = mAddBackFaces;
+  QtConcurrent::blockingMap( jobs, [origin, withNormals, invertNormals, addBackFaces]( TessellationJob & job )
+  {
+    QgsTessellator tessellator( origin.x(), origin.y(), withNormals, invertNormals, addBackFaces );
+    tessellator.addPolygon( *job.polygon, job.extrusionHeight );
+    job.data = tessellator.data();
+  } );
+
+  qDeleteAll( polygons );
+
+  int valueCount = 0;
+  for ( const TessellationJob &job : jobs )
+    valueCount += job.data.count();
+
+  QgsTessellator tmpTess( 0, 0, mWithNormals );
+  const int valuesPerVertex = tmpTess.stride() / sizeof( float );
+
+  QByteArray data( valueCount * sizeof( float ), Qt::Uninitialized );
+  float *dataPtr = reinterpret_cast< float * >( data.data() );
+  uint startingTriangleIndex = 0;
+  for ( int i = 0; i < jobs.count(); ++i )
+  {
     mTriangleIndexStartingIndices.append( startingTriangleIndex );
     mTriangleIndexFids.append( featureIds[i] );
 
-    QgsPolygon *polygon = polygons.at( i );
-    float extr = extrusionHeightPerPolygon.isEmpty() ? extrusionHeight : extrusionHeightPerPolygon.at( i );
-    tessellator.addPolygon( *polygon, extr );
+    const QVector<float> &polygonData = jobs.at( i ).data;
+    dataPtr = std::copy( polygonData.constBegin(), polygonData.constEnd(), dataPtr );
+    Q_ASSERT( polygonData.count() % ( valuesPerVertex * 3 ) == 0 );
+    startingTriangleIndex += static_cast<uint>( polygonData.count() / ( valuesPerVertex * 3 ) );
   }
 
-  qDeleteAll( polygons );
-
-  QByteArray data( ( const char * )tessellator.data().constData(), tessellator.data().count() * sizeof( float ) );
-  int nVerts = data.count() / tessellator.stride();
+  int nVerts = valueCount / valuesPerVertex;
 
   mVertexBuffer->setData( data );
   mPositionAttribute->setCount( nVerts );
@@ -21,6 +21,11 @@
 #include "qgsfeedback.h"
 #include <QFile>
 #include <QFileInfo>
+#include <QtConcurrentMap>
+#include <numeric>
+
+//! Maximum number of cells interpolated at once when interpolating concurrently
+static const int GRID_BAND_CELLS = 1024 * 1024;
 
 QgsGridFileWriter::QgsGridFileWriter( QgsInterpolator *i, const QString &outputPath, const QgsRectangle &extent, int nCols, int nRows )
   : mInterpolator( i )
@@ -51,27 +56,94 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
   outStream.setRealNumberPrecision( 8 );
   writeHeader( outStream );
 
-  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0; //calculate value in the center of the cell
-  double currentXValue;
-  double interpolatedValue;
-
+  // cell center coordinates
+  QVector< double > xValues( mNumColumns );
+  double currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0;
+  for ( int j = 0; j < mNumColumns; ++j )
+  {
+    xValues[j] = currentXValue;
+    currentXValue += mCellSizeX;
+  }
+  QVector< double > yValues( mNumRows );
+  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0;
   for ( int i = 0; i < mNumRows; ++i )
   {
-    currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0; //calculate value in the center of the cell
-    for ( int j = 0; j < mNumColumns; ++j )
+    yValues[i] = currentYValue;
+    currentYValue -= mCellSizeY;
+  }
+
+  // Rows are interpolated by bands, in parallel if the interpolator supports it, and
+  // written in order. The interpolator caches its base data on this thread first.
+  bool concurrent = mInterpolator->canInterpolateConcurrently() && mNumRows > 1 && mNumColumns > 0;
+  if ( concurrent )
+  {
+    switch ( mInterpolator->prepareInterpolation( feedback ) )
+    {
+      case QgsInterpolator::Success:
+        break;
+
+      case QgsInterpolator::Canceled:
+        outputFile.remove();
+        return 3;
+
+      case QgsInterpolator::InvalidSource:
+      case QgsInterpolator::FeatureGeometryError:
+        // the interpolator is not ready, and would try to cache its data again on each call
+        concurrent = false;
+        break;
+    }
+  }
+  const int bandRows = concurrent ? std::max( 1, std::min( mNumRows, GRID_BAND_CELLS / std::max( 1, mNumColumns ) ) ) : 1;
+  QVector< double > values;
+  QVector< bool > valid;
+  QVector< int > rowIndices;
+
+  for ( int firstRow = 0; firstRow < mNumRows; firstRow += bandRows )
+  {
+    const int rows = std::min( bandRows, mNumRows - firstRow );
+    values.resize( rows * mNumColumns );
+    valid.resize( rows * mNumColumns );
+    double *valuesData = values.data();
+    bool *validData = valid.data();
+
+    auto interpolateRow = [&, firstRow, valuesData, validData]( int row )
     {
-      if ( mInterpolator->interpolatePoint( currentXValue, currentYValue, interpolatedValue, feedback ) == 0 )
+      const double y = yValues.at( firstRow + row );
+      for ( int j = 0; j < mNumColumns; ++j )
       {
-        outStream << interpolatedValue << ' ';
+        const int index = row * mNumColumns + j;
+        validData[index] = mInterpolator->interpolatePoint( xValues.at( j ), y, valuesData[index], concurrent ? nullptr : feedback ) == 0;
       }
-      else
+    };
+
+    if ( concurrent )
+    {
+      rowIndices.resize( rows );
+      std::iota( rowIndices.begin(), rowIndices.end(), 0 );
+      QtConcurrent::blockingMap( rowIndices, interpolateRow );
+    }
+    else
+    {
+      for ( int row = 0; row < rows; ++row )
+        interpolateRow( row );
+    }
+
+    for ( int row = 0; row < rows; ++row )
+    {
+      for ( int j = 0; j < mNumColumns; ++j )
       {
-        outStream << "-9999 ";
+        const int index = row * mNumColumns + j;
+        if ( valid.at( index ) )
+        {
+          outStream << values.at( index ) << ' ';
+        }
+        else
+        {
+          outStream << "-9999 ";
+        }
       }
-      currentXValue += mCellSizeX;
+      outStream << endl;
     }
-    outStream << endl;
-    currentYValue -= mCellSizeY;
 
     if ( feedback )
     {
@@ -80,7 +152,7 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
         outputFile.remove();
         return 3;
       }
-      feedback->setProgress( 100.0 * i / static_cast< double >( mNumRows ) );
+      feedback->setProgress( 100.0 * ( firstRow + rows - 1 ) / static_cast< double >( mNumRows ) );
     }
   }
 
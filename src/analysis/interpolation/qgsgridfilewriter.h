@@ -22,6 +22,7 @@
 #include <QString>
 #include <QTextStream>
 #include "qgis_analysis.h"
+#include "qgis_sip.h"
 
 class QgsInterpolator;
 class QgsFeedback;
@@ -48,9 +49,12 @@ class ANALYSIS_EXPORT QgsGridFileWriter
      *
      * An optional \a feedback object can be set for progress reports and cancelation support
      *
+     * If the interpolator supports it (see QgsInterpolator::canInterpolateConcurrently()),
+     * rows are interpolated in parallel.
+     *
      * \returns 0 in case of success
     */
-    int writeFile( QgsFeedback *feedback = nullptr );
+    int writeFile( QgsFeedback *feedback = nullptr ) SIP_RELEASEGIL;
 
   private:
 
@@ -17,13 +17,77 @@
 
 #include "qgsidwinterpolator.h"
 #include "qgis.h"
+#include "qgsconfig.h"
+#include "qgsrectangle.h"
 #include <cmath>
 #include <limits>
+#include <algorithm>
+#include "kdbush.hpp"
+
+///@cond PRIVATE
+
+//! Data point stored in the spatial index: its coordinates and its index in the cached data
+struct QgsIDWIndexedVertex
+{
+  QgsIDWIndexedVertex( double x, double y, int index )
+    : coords( std::make_pair( x, y ) )
+    , index( index )
+  {}
+
+  std::pair<double, double> coords;
+  int index;
+};
+
+//! KD-tree of the cached data points of an IDW interpolator
+class QgsIDWInterpolatorIndex : public kdbush::KDBush< std::pair<double, double>, QgsIDWIndexedVertex, std::size_t >
+{
+  public:
+
+    explicit QgsIDWInterpolatorIndex( const QVector<QgsInterpolatorVertexData> &data )
+    {
+      points.reserve( data.size() );
+      for ( int i = 0; i < data.size(); ++i )
+      {
+        const QgsInterpolatorVertexData &vertex = data.at( i );
+        points.emplace_back( QgsIDWIndexedVertex( vertex.x, vertex.y, i ) );
+        if ( i == 0 )
+          extent = QgsRectangle( vertex.x, vertex.y, vertex.x, vertex.y );
+        else
+          extent.combineExtentWith( vertex.x, vertex.y );
+      }
+
+      if ( !points.empty() )
+        sortKD( 0, points.size() - 1, 0 );
+    }
+
+    std::size_t size() const
+    {
+      return points.size();
+    }
+
+    //! Extent of the data points
+    QgsRectangle extent;
+};
+
+///@endcond
 
 QgsIDWInterpolator::QgsIDWInterpolator( const QList<LayerData> &layerData )
   : QgsInterpolator( layerData )
 {}
 
+QgsInterpolator::Result QgsIDWInterpolator::prepareInterpolation( QgsFeedback *feedback )
+{
+  const Result result = QgsInterpolator::prepareInterpolation( feedback );
+  if ( result != Success )
+    return result;
+
+  if ( ( mSearchRadius > 0 || mMaximumNeighbors > 0 ) && !mIndex )
+  {
+    mIndex = std::make_shared< QgsIDWInterpolatorIndex >( mCachedBaseData );
+  }
+  return Success;
+}
+
 int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, QgsFeedback *feedback )
 {
   if ( !mDataIsCached )
@@ -31,6 +95,11 @@ int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, Qg
     cacheBaseData( feedback );
   }
 
+  if ( mSearchRadius > 0 || mMaximumNeighbors > 0 )
+  {
+    return interpolateFromIndex( x, y, result );
+  }
+
   double sumCounter = 0;
   double sumDenominator = 0;
 
@@ -55,3 +124,94 @@ int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, Qg
   result = sumCounter / sumDenominator;
   return 0;
 }
+
+int QgsIDWInterpolator::interpolateFromIndex( double x, double y, double &result )
+{
+  if ( !mIndex )
+  {
+    mIndex = std::make_shared< QgsIDWInterpolatorIndex >( mCachedBaseData );
+  }
+  if ( mIndex->size() == 0 )
+  {
+    return 1;
+  }
+
+  // squared distance and index of the neighbors
+#ifdef USE_THREAD_LOCAL
+  // reused by the following calls from the same thread
+  static thread_local std::vector< std::pair< double, int > > sNeighbors;
+  std::vector< std::pair< double, int > > &neighbors = sNeighbors;
+#else
+  std::vector< std::pair< double, int > > neighbors;
+#endif
+  auto collect = [this, x, y, &neighbors]( double radius )
+  {
+    neighbors.clear();
+    mIndex->within( x, y, radius, [x, y, &neighbors]( const QgsIDWIndexedVertex & vertex )
+    {
+      const double dx = vertex.coords.first - x;
+      const double dy = vertex.coords.second - y;
+      neighbors.emplace_back( dx * dx + dy * dy, vertex.index );
+    } );
+  };
+
+  const std::size_t maxNeighbors = static_cast< std::size_t >( mMaximumNeighbors );
+  if ( mMaximumNeighbors <= 0 )
+  {
+    collect( mSearchRadius );
+  }
+  else
+  {
+    // grow the search radius until enough neighbors are found, starting with the radius
+    // which would contain the wanted number of points if they were evenly distributed
+    const QgsRectangle &extent = mIndex->extent;
+    const double maxRadius = std::sqrt( std::pow( std::max( std::fabs( x - extent.xMinimum() ), std::fabs( x - extent.xMaximum() ) ), 2 )
+                                        + std::pow( std::max( std::fabs( y - extent.yMinimum() ), std::fabs( y - extent.yMaximum() ) ), 2 ) );
+    double radius = std::sqrt( extent.width() * extent.height() * mMaximumNeighbors / ( M_PI * mIndex->size() ) );
+    if ( !( radius > 0 ) )
+      radius = maxRadius;
+    if ( mSearchRadius > 0 )
+      radius = std::min( radius, mSearchRadius );
+
+    while ( true )
+    {
+      collect( radius );
+      if ( neighbors.size() >= maxNeighbors || radius >= maxRadius || ( mSearchRadius > 0 && radius >= mSearchRadius ) )
+        break;
+
+      radius *= 2;
+      if ( mSearchRadius > 0 )
+        radius = std::min( radius, mSearchRadius );
+    }
+
+    if ( neighbors.size() > maxNeighbors )
+    {
+      std::nth_element( neighbors.begin(), neighbors.begin() + maxNeighbors, neighbors.end() );
+      neighbors.resize( maxNeighbors );
+    }
+  }
+
+  double sumCounter = 0;
+  double sumDenominator = 0;
+  for ( const std::pair< double, int > &neighbor : neighbors )
+  {
+    const QgsInterpolatorVertexData &vertex = mCachedBaseData.at( neighbor.second );
+    double distance = std::sqrt( neighbor.first );
+    if ( qgsDoubleNear( distance, 0.0 ) )
+    {
+      result = vertex.z;
+      return 0;
+    }
+    double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
+    sumCounter += ( currentWeight * vertex.z );
+    sumDenominator += currentWeight;
+  }
+
+  if ( sumDenominator == 0.0 )
+  {
+    return 1;
+  }
+
+  result = sumCounter / sumDenominator;
+  return 0;
+}
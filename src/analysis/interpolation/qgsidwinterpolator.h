@@ -21,6 +21,10 @@
 #include "qgsinterpolator.h"
 #include "qgis_analysis.h"
 
+#include <memory>
+
+class QgsIDWInterpolatorIndex;
+
 /**
  * \ingroup analysis
  * \class QgsIDWInterpolator
@@ -60,11 +64,62 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
     */
     double distanceCoefficient() const { return mDistanceCoefficient; }
 
+    /**
+     * Sets the search \a radius. Only the points within this distance of an interpolated
+     * point are used to calculate its value. Points without any data point within the
+     * radius are not interpolated. A radius of 0 means that all points are used.
+     *
+     * Setting a search radius or a maximum number of neighbors makes the interpolator
+     * use a spatial index of the data points, which is much faster for large datasets.
+     *
+     * \see searchRadius()
+     * \see setMaximumNeighbors()
+     * \since QGIS 3.6
+     */
+    void setSearchRadius( double radius ) { mSearchRadius = radius; }
+
+    /**
+     * Returns the search radius. 0 means that all points are used.
+     * \see setSearchRadius()
+     * \since QGIS 3.6
+     */
+    double searchRadius() const { return mSearchRadius; }
+
+    /**
+     * Sets the maximum number of nearest data points used to calculate the value of
+     * an interpolated point. A value of 0 means that all points are used.
+     *
+     * \see maximumNeighbors()
+     * \see setSearchRadius()
+     * \since QGIS 3.6
+     */
+    void setMaximumNeighbors( int neighbors ) { mMaximumNeighbors = neighbors; }
+
+    /**
+     * Returns the maximum number of nearest data points used to calculate the value
+     * of an interpolated point. 0 means that all points are used.
+     * \see setMaximumNeighbors()
+     * \since QGIS 3.6
+     */
+    int maximumNeighbors() const { return mMaximumNeighbors; }
+
+    bool canInterpolateConcurrently() const override { return true; }
+
+    QgsInterpolator::Result prepareInterpolation( QgsFeedback *feedback = nullptr ) override;
+
   private:
 
     QgsIDWInterpolator() = delete;
 
+    //! Interpolates the value at \a x, \a y from the neighbors found in the spatial index
+    int interpolateFromIndex( double x, double y, double &result );
+
     double mDistanceCoefficient = 2.0;
+    double mSearchRadius = 0.0;
+    int mMaximumNeighbors = 0;
+
+    //! Spatial index of mCachedBaseData, built by prepareInterpolation() or on first use. Read only once built.
+    std::shared_ptr< QgsIDWInterpolatorIndex > mIndex;
 };
 
 #endif
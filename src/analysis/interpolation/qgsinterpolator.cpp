@@ -32,6 +32,7 @@ QgsInterpolator::Result QgsInterpolator::cacheBaseData( QgsFeedback *feedback )
 {
   if ( mLayerData.empty() )
   {
+    mDataIsCached = true;
     return Success;
   }
 
@@ -109,9 +110,18 @@ QgsInterpolator::Result QgsInterpolator::cacheBaseData( QgsFeedback *feedback )
     layerCount++;
   }
 
+  mDataIsCached = true;
   return Success;
 }
 
+QgsInterpolator::Result QgsInterpolator::prepareInterpolation( QgsFeedback *feedback )
+{
+  if ( mDataIsCached )
+    return Success;
+
+  return cacheBaseData( feedback );
+}
+
 bool QgsInterpolator::addVerticesToCache( const QgsGeometry &geom, ValueSource source, double attributeValue )
 {
   if ( geom.isNull() || geom.isEmpty() )
@@ -153,6 +163,5 @@ bool QgsInterpolator::addVerticesToCache( const QgsGeometry &geom, ValueSource s
         break;
     }
   }
-  mDataIsCached = true;
   return true;
 }
@@ -116,6 +116,33 @@ class ANALYSIS_EXPORT QgsInterpolator
      */
     virtual int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) = 0;
 
+    /**
+     * Returns true if interpolatePoint() can be called concurrently from several threads,
+     * once prepareInterpolation() has been called.
+     *
+     * The default implementation returns false.
+     *
+     * \see prepareInterpolation()
+     * \since QGIS 3.6
+     */
+    virtual bool canInterpolateConcurrently() const { return false; }
+
+    /**
+     * Caches the base data and builds everything else interpolatePoint() needs, so that
+     * interpolatePoint() does not modify the interpolator anymore. This must be called
+     * from a single thread, before calling interpolatePoint() concurrently.
+     *
+     * The default implementation caches the base data, if it is not cached yet.
+     *
+     * An optional \a feedback argument may be specified to allow cancelation and
+     * progress reports from the cache operation.
+     *
+     * \returns Success in case of success
+     * \see canInterpolateConcurrently()
+     * \since QGIS 3.6
+     */
+    virtual QgsInterpolator::Result prepareInterpolation( QgsFeedback *feedback = nullptr );
+
     //! \note not available in Python bindings
     QList<LayerData> layerData() const { return mLayerData; } SIP_SKIP
 
@@ -16,7 +16,6 @@
  ***************************************************************************/
 
 #include "qgsalgorithmextractbylocation.h"
-#include "qgsgeometryengine.h"
 #include "qgsvectorlayer.h"
 
 ///@cond PRIVATE
@@ -102,7 +101,6 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
   double step = intersectSource->featureCount() > 0 ? 100.0 / intersectSource->featureCount() : 1;
   int current = 0;
   QgsFeature f;
-  std::unique_ptr< QgsGeometryEngine > engine;
   while ( fIt.nextFeature( f ) )
   {
     if ( feedback->isCanceled() )
@@ -111,9 +109,10 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
     if ( !f.hasGeometry() )
       continue;
 
-    engine.reset();
+    const QgsGeometry geometry = f.geometry();
+    bool prepared = false;
 
-    QgsRectangle bbox = f.geometry().boundingBox();
+    QgsRectangle bbox = geometry.boundingBox();
     request = QgsFeatureRequest().setFilterRect( bbox );
     if ( onlyRequireTargetIds )
       request.setNoAttributes();
@@ -136,43 +135,45 @@ void QgsLocationBasedAlgorithm::process( const QgsProcessingContext &context, Qg
         continue;
       }
 
-      if ( !engine )
+      if ( !prepared )
       {
-        engine.reset( QgsGeometry::createGeometryEngine( f.geometry().constGet() ) );
-        engine->prepareGeometry();
+        geometry.prepare();
+        prepared = true;
       }
 
+      const QgsGeometry testGeometry = testFeature.geometry();
+
       for ( Predicate predicate : qgis::as_const( predicates ) )
       {
         bool isMatch = false;
         switch ( predicate )
         {
           case Intersects:
-            isMatch = engine->intersects( testFeature.geometry().constGet() );
+            isMatch = geometry.intersects( testGeometry );
             break;
           case Contains:
-            isMatch = engine->contains( testFeature.geometry().constGet() );
+            isMatch = geometry.contains( testGeometry );
             break;
           case Disjoint:
-            if ( engine->intersects( testFeature.geometry().constGet() ) )
+            if ( geometry.intersects( testGeometry ) )
             {
               disjointSet.remove( testFeature.id() );
             }
             break;
           case IsEqual:
-            isMatch = engine->isEqual( testFeature.geometry().constGet() );
+            isMatch = geometry.isGeosEqual( testGeometry );
             break;
           case Touches:
-            isMatch = engine->touches( testFeature.geometry().constGet() );
+            isMatch = geometry.touches( testGeometry );
             break;
           case Overlaps:
-            isMatch = engine->overlaps( testFeature.geometry().constGet() );
+            isMatch = geometry.overlaps( testGeometry );
             break;
           case Within:
-            isMatch = engine->within( testFeature.geometry().constGet() );
+            isMatch = geometry.within( testGeometry );
             break;
           case Crosses:
-            isMatch = engine->crosses( testFeature.geometry().constGet() );
+            isMatch = geometry.crosses( testGeometry );
             break;
         }
         if ( isMatch )
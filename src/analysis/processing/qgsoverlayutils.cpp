@@ -53,6 +53,26 @@ bool QgsOverlayUtils::sanitizeIntersectionResult( QgsGeometry &geom, QgsWkbTypes
 }
 
 
+//! Returns the intersection of the geometry of \a engine with \a geom, reusing the GEOS geometry already built by the engine
+static QgsGeometry engineIntersection( QgsGeometryEngine *engine, const QgsGeometry &geom )
+{
+  QString error;
+  std::unique_ptr< QgsAbstractGeometry > result( engine->intersection( geom.constGet(), &error ) );
+  if ( !result )
+    throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: intersection failed." ), error ) );
+  return QgsGeometry( std::move( result ) );
+}
+
+//! Returns the difference of the geometry of \a engine and \a geom, reusing the GEOS geometry already built by the engine
+static QgsGeometry engineDifference( QgsGeometryEngine *engine, const QgsGeometry &geom )
+{
+  QString error;
+  std::unique_ptr< QgsAbstractGeometry > result( engine->difference( geom.constGet(), &error ) );
+  if ( !result )
+    throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: difference failed." ), error ) );
+  return QgsGeometry( std::move( result ) );
+}
+
 //! Makes sure that what came out from difference of two geometries is good to be used in the output
 static bool sanitizeDifferenceResult( QgsGeometry &geom )
 {
@@ -231,7 +251,7 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
       if ( !engine->intersects( tmpGeom.constGet() ) )
         continue;
 
-      QgsGeometry intGeom = geom.intersection( tmpGeom );
+      QgsGeometry intGeom = engineIntersection( engine.get(), tmpGeom );
       if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
         continue;
 
@@ -319,7 +339,7 @@ void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatur
       if ( !g1engine->intersects( g2.constGet() ) )
         continue;
 
-      QgsGeometry geomIntersection = g1.intersection( g2 );
+      QgsGeometry geomIntersection = engineIntersection( g1engine.get(), g2 );
       if ( !sanitizeIntersectionResult( geomIntersection, geometryType ) )
         continue;
 
@@ -355,7 +375,7 @@ void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatur
       // update f1
       //
 
-      QgsGeometry g12 = g1.difference( g2 );
+      QgsGeometry g12 = engineDifference( g1engine.get(), g2 );
 
       index.deleteFeature( f );
       geometries.remove( fid1 );
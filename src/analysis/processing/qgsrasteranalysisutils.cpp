@@ -20,7 +20,11 @@
 #include "qgsrasteriterator.h"
 #include "qgsgeos.h"
 #include "qgsprocessingparameters.h"
+#include "qgscurvepolygon.h"
+#include "qgsgeometrycollection.h"
+#include "qgslinestring.h"
 #include <map>
+#include <algorithm>
 ///@cond PRIVATE
 
 void QgsRasterAnalysisUtils::cellInfoForBBox( const QgsRectangle &rasterBBox, const QgsRectangle &featureBBox, double cellSizeX, double cellSizeY,
@@ -56,14 +60,215 @@ void QgsRasterAnalysisUtils::cellInfoForBBox( const QgsRectangle &rasterBBox, co
                                     rasterBBox.yMaximum() - ( nCellsY + offsetY ) * cellSizeY );
 }
 
+/**
+ * Rasterizes a polygon on a grid of cells, with a scanline algorithm.
+ *
+ * The polygon edges are bucketed by grid row, so that for each row only the
+ * edges crossing it are considered. This makes it possible to find the cells
+ * whose center is inside the polygon, and the cells crossed by the polygon
+ * boundary, without any per-cell geometry test.
+ */
+class QgsPolygonScanline
+{
+  public:
+
+    QgsPolygonScanline( const QgsGeometry &poly, const QgsRectangle &gridExtent, int nCols, int nRows, double cellSizeX, double cellSizeY )
+      : mOriginX( gridExtent.xMinimum() )
+      , mOriginY( gridExtent.yMaximum() )
+      , mCols( nCols )
+      , mRows( nRows )
+      , mCellSizeX( cellSizeX )
+      , mCellSizeY( cellSizeY )
+      , mRowEdges( nRows )
+    {
+      const QgsAbstractGeometry *geom = poly.constGet();
+      if ( !geom )
+        return;
+
+      if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geom ) )
+      {
+        for ( int i = 0; i < collection->numGeometries(); ++i )
+          addPolygon( qgsgeometry_cast< const QgsCurvePolygon * >( collection->geometryN( i ) ) );
+      }
+      else
+      {
+        addPolygon( qgsgeometry_cast< const QgsCurvePolygon * >( geom ) );
+      }
+    }
+
+    /**
+     * Sets \a mask to true for the cells of \a row whose center is strictly inside the polygon
+     * (even-odd rule). Like a GEOS contains test, centers lying on the boundary are outside.
+     */
+    void centerMask( int row, QVector< bool > &mask ) const
+    {
+      mask.fill( false, mCols );
+
+      const double y = mOriginY - ( row + 0.5 ) * mCellSizeY;
+      mCrossings.clear();
+      for ( int index : mRowEdges.at( row ) )
+      {
+        const Edge &edge = mEdges.at( index );
+        // half-open rule, so that vertices shared by two edges are counted once
+        if ( ( edge.y1 <= y ) == ( edge.y2 <= y ) )
+          continue;
+        mCrossings << edge.x1 + ( y - edge.y1 ) * ( edge.x2 - edge.x1 ) / ( edge.y2 - edge.y1 );
+      }
+      std::sort( mCrossings.begin(), mCrossings.end() );
+
+      for ( int i = 0; i + 1 < mCrossings.size(); i += 2 )
+      {
+        // first and last cells whose center is strictly between the two crossings
+        const int firstCol = clampIndex( std::floor( ( mCrossings.at( i ) - mOriginX ) / mCellSizeX - 0.5 ) + 1, mCols );
+        const int lastCol = clampIndex( std::ceil( ( mCrossings.at( i + 1 ) - mOriginX ) / mCellSizeX - 0.5 ) - 1, mCols );
+        for ( int col = std::max( 0, firstCol ); col <= std::min( mCols - 1, lastCol ); ++col )
+          mask[col] = true;
+      }
+
+      // The half-open rule counts centers lying on horizontal edges, or on the lower
+      // vertex of edges, as inside. Remove the centers lying on any edge.
+      for ( int index : mRowEdges.at( row ) )
+      {
+        const Edge &edge = mEdges.at( index );
+        if ( y < std::min( edge.y1, edge.y2 ) || y > std::max( edge.y1, edge.y2 ) )
+          continue;
+
+        double xMin = 0;
+        double xMax = 0;
+        if ( edge.y1 == edge.y2 )
+        {
+          xMin = std::min( edge.x1, edge.x2 );
+          xMax = std::max( edge.x1, edge.x2 );
+        }
+        else
+        {
+          xMin = xMax = edge.x1 + ( y - edge.y1 ) * ( edge.x2 - edge.x1 ) / ( edge.y2 - edge.y1 );
+        }
+
+        const int firstCol = clampIndex( std::ceil( ( xMin - mOriginX ) / mCellSizeX - 0.5 ), mCols );
+        const int lastCol = clampIndex( std::floor( ( xMax - mOriginX ) / mCellSizeX - 0.5 ), mCols );
+        for ( int col = std::max( 0, firstCol ); col <= std::min( mCols - 1, lastCol ); ++col )
+        {
+          if ( cellCenterX( col ) >= xMin && cellCenterX( col ) <= xMax )
+            mask[col] = false;
+        }
+      }
+    }
+
+    /**
+     * Sets \a mask to true for the cells of \a row which are crossed or touched by the
+     * polygon boundary.
+     */
+    void boundaryMask( int row, QVector< bool > &mask ) const
+    {
+      mask.fill( false, mCols );
+
+      const double rowTop = mOriginY - row * mCellSizeY;
+      const double rowBottom = rowTop - mCellSizeY;
+      for ( int index : mRowEdges.at( row ) )
+      {
+        const Edge &edge = mEdges.at( index );
+        double xMin = 0;
+        double xMax = 0;
+        if ( qgsDoubleNear( edge.y1, edge.y2 ) )
+        {
+          xMin = std::min( edge.x1, edge.x2 );
+          xMax = std::max( edge.x1, edge.x2 );
+        }
+        else
+        {
+          // part of the edge within the row
+          const double yStart = std::max( std::min( edge.y1, edge.y2 ), rowBottom );
+          const double yEnd = std::min( std::max( edge.y1, edge.y2 ), rowTop );
+          const double xStart = edge.x1 + ( yStart - edge.y1 ) * ( edge.x2 - edge.x1 ) / ( edge.y2 - edge.y1 );
+          const double xEnd = edge.x1 + ( yEnd - edge.y1 ) * ( edge.x2 - edge.x1 ) / ( edge.y2 - edge.y1 );
+          xMin = std::min( xStart, xEnd );
+          xMax = std::max( xStart, xEnd );
+        }
+
+        const int firstCol = clampIndex( std::floor( ( xMin - mOriginX ) / mCellSizeX ), mCols );
+        const int lastCol = clampIndex( std::floor( ( xMax - mOriginX ) / mCellSizeX ), mCols );
+        for ( int col = std::max( 0, firstCol ); col <= std::min( mCols - 1, lastCol ); ++col )
+          mask[col] = true;
+      }
+    }
+
+  private:
+
+    //! Returns the x coordinate of the center of the cells of column \a col
+    double cellCenterX( int col ) const
+    {
+      return mOriginX + ( col + 0.5 ) * mCellSizeX;
+    }
+
+    //! Converts a row or column \a index to int, clamped to [-1, \a count]
+    static int clampIndex( double index, int count )
+    {
+      return static_cast< int >( std::max( -1.0, std::min( index, static_cast< double >( count ) ) ) );
+    }
+
+    struct Edge
+    {
+      double x1;
+      double y1;
+      double x2;
+      double y2;
+    };
+
+    void addPolygon( const QgsCurvePolygon *polygon )
+    {
+      if ( !polygon || !polygon->exteriorRing() )
+        return;
+
+      addRing( polygon->exteriorRing() );
+      for ( int i = 0; i < polygon->numInteriorRings(); ++i )
+        addRing( polygon->interiorRing( i ) );
+    }
+
+    void addRing( const QgsCurve *ring )
+    {
+      std::unique_ptr< QgsLineString > line( ring->curveToLine() );
+      const int count = line->numPoints();
+      const double *x = line->xData();
+      const double *y = line->yData();
+      for ( int i = 0; i + 1 < count; ++i )
+      {
+        const Edge edge { x[i], y[i], x[i + 1], y[i + 1] };
+        const double yMin = std::min( edge.y1, edge.y2 );
+        const double yMax = std::max( edge.y1, edge.y2 );
+        const double firstRow = std::floor( ( mOriginY - yMax ) / mCellSizeY );
+        const double lastRow = std::floor( ( mOriginY - yMin ) / mCellSizeY );
+        if ( std::isnan( yMin ) || std::isnan( yMax ) || lastRow < 0 || firstRow >= mRows )
+          continue;
+
+        const int index = mEdges.size();
+        mEdges << edge;
+        for ( int row = std::max( 0, clampIndex( firstRow, mRows ) ); row <= std::min( mRows - 1, clampIndex( lastRow, mRows ) ); ++row )
+          mRowEdges[row] << index;
+      }
+    }
+
+    double mOriginX = 0;
+    double mOriginY = 0;
+    int mCols = 0;
+    int mRows = 0;
+    double mCellSizeX = 0;
+    double mCellSizeY = 0;
+    QVector< Edge > mEdges;
+    //! Indices of the edges crossing each row
+    QVector< QVector< int > > mRowEdges;
+    //! Crossings of the current row, kept to avoid an allocation per row
+    mutable QVector< double > mCrossings;
+};
+
 void QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox,  const std::function<void( double )> &addValue, bool skipNodata )
 {
-  std::unique_ptr< QgsGeometryEngine > polyEngine( QgsGeometry::createGeometryEngine( poly.constGet( ) ) );
-  if ( !polyEngine )
+  if ( poly.isNull() || nCellsX <= 0 || nCellsY <= 0 )
   {
     return;
   }
-  polyEngine->prepareGeometry();
+
+  const QgsPolygonScanline scanline( poly, rasterBBox, nCellsX, nCellsY, cellSizeX, cellSizeY );
 
   QgsRasterIterator iter( rasterInterface );
   iter.startRasterRead( rasterBand, nCellsX, nCellsY, rasterBBox );
@@ -74,27 +279,23 @@ void QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( QgsRasterInterface *
   int iterCols = 0;
   int iterRows = 0;
   QgsRectangle blockExtent;
+  QVector< bool > inside;
   while ( iter.readNextRasterPart( rasterBand, iterCols, iterRows, block, iterLeft, iterTop, &blockExtent ) )
   {
-    double cellCenterY = blockExtent.yMaximum() - 0.5 * cellSizeY;
-
     for ( int row = 0; row < iterRows; ++row )
     {
-      double cellCenterX = blockExtent.xMinimum() + 0.5 * cellSizeX;
+      scanline.centerMask( iterTop + row, inside );
       for ( int col = 0; col < iterCols; ++col )
       {
+        if ( !inside.at( iterLeft + col ) )
+          continue;
+
         double pixelValue = block->value( row, col );
         if ( validPixel( pixelValue ) && ( !skipNodata || !block->isNoData( row, col ) ) )
         {
-          QgsPoint cellCenter( cellCenterX, cellCenterY );
-          if ( polyEngine->contains( &cellCenter ) )
-          {
-            addValue( pixelValue );
-          }
+          addValue( pixelValue );
         }
-        cellCenterX += cellSizeX;
       }
-      cellCenterY -= cellSizeY;
     }
   }
 }
@@ -103,11 +304,14 @@ void QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( QgsRasterInterfa
 {
   QgsGeometry pixelRectGeometry;
 
-  double hCellSizeX = cellSizeX / 2.0;
-  double hCellSizeY = cellSizeY / 2.0;
   double pixelArea = cellSizeX * cellSizeY;
   double weight = 0;
 
+  if ( poly.isNull() || nCellsX <= 0 || nCellsY <= 0 )
+  {
+    return;
+  }
+
   std::unique_ptr< QgsGeometryEngine > polyEngine( QgsGeometry::createGeometryEngine( poly.constGet( ) ) );
   if ( !polyEngine )
   {
@@ -115,6 +319,10 @@ void QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( QgsRasterInterfa
   }
   polyEngine->prepareGeometry();
 
+  // Only the cells crossed by the polygon boundary are partially covered. The other
+  // cells are either fully inside or fully outside, depending on their center.
+  const QgsPolygonScanline scanline( poly, rasterBBox, nCellsX, nCellsY, cellSizeX, cellSizeY );
+
   QgsRasterIterator iter( rasterInterface );
   iter.startRasterRead( rasterBand, nCellsX, nCellsY, rasterBBox );
 
@@ -124,36 +332,50 @@ void QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( QgsRasterInterfa
   int iterCols = 0;
   int iterRows = 0;
   QgsRectangle blockExtent;
+  QVector< bool > inside;
+  QVector< bool > boundary;
   while ( iter.readNextRasterPart( rasterBand, iterCols, iterRows, block, iterLeft, iterTop, &blockExtent ) )
   {
-    double currentY = blockExtent.yMaximum() - 0.5 * cellSizeY;
+    double currentY = blockExtent.yMaximum();
     for ( int row = 0; row < iterRows; ++row )
     {
-      double currentX = blockExtent.xMinimum() + 0.5 * cellSizeX;
-      for ( int col = 0; col < iterCols; ++col )
+      scanline.centerMask( iterTop + row, inside );
+      scanline.boundaryMask( iterTop + row, boundary );
+
+      double currentX = blockExtent.xMinimum();
+      for ( int col = 0; col < iterCols; ++col, currentX += cellSizeX )
       {
+        const bool isBoundary = boundary.at( iterLeft + col );
+        if ( !isBoundary && !inside.at( iterLeft + col ) )
+          continue;
+
         double pixelValue = block->value( row, col );
-        if ( validPixel( pixelValue ) && ( !skipNodata || !block->isNoData( row, col ) ) )
+        if ( !validPixel( pixelValue ) || ( skipNodata && block->isNoData( row, col ) ) )
+          continue;
+
+        if ( !isBoundary )
+        {
+          addValue( pixelValue, 1.0 );
+          continue;
+        }
+
+        pixelRectGeometry = QgsGeometry::fromRect( QgsRectangle( currentX, currentY - cellSizeY, currentX + cellSizeX, currentY ) );
+        // GEOS intersects tests on prepared geometry is MAGNITUDES faster than calculating the intersection itself,
+        // so we first test to see if there IS an intersection before doing the actual calculation
+        if ( !pixelRectGeometry.isNull() && polyEngine->intersects( pixelRectGeometry.constGet() ) )
         {
-          pixelRectGeometry = QgsGeometry::fromRect( QgsRectangle( currentX - hCellSizeX, currentY - hCellSizeY, currentX + hCellSizeX, currentY + hCellSizeY ) );
-          // GEOS intersects tests on prepared geometry is MAGNITUDES faster than calculating the intersection itself,
-          // so we first test to see if there IS an intersection before doing the actual calculation
-          if ( !pixelRectGeometry.isNull() && polyEngine->intersects( pixelRectGeometry.constGet() ) )
+          //intersection
+          QgsGeometry intersectGeometry = pixelRectGeometry.intersection( poly );
+          if ( !intersectGeometry.isEmpty() )
           {
-            //intersection
-            QgsGeometry intersectGeometry = pixelRectGeometry.intersection( poly );
-            if ( !intersectGeometry.isEmpty() )
+            double intersectionArea = intersectGeometry.area();
+            if ( intersectionArea > 0.0 )
             {
-              double intersectionArea = intersectGeometry.area();
-              if ( intersectionArea > 0.0 )
-              {
-                weight = intersectionArea / pixelArea;
-                addValue( pixelValue, weight );
-              }
+              weight = intersectionArea / pixelArea;
+              addValue( pixelValue, weight );
             }
           }
         }
-        currentX += cellSizeX;
       }
       currentY -= cellSizeY;
     }
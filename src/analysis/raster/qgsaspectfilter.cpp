@@ -44,3 +44,7 @@ float QgsAspectFilter::processNineCellWindow(
   }
 }
 
+void QgsAspectFilter::processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+{
+  processNineCellRowFor< QgsAspectFilter >( rowAbove, row, rowBelow, result, width );
+}
@@ -36,6 +36,9 @@ class ANALYSIS_EXPORT QgsAspectFilter: public QgsDerivativeFilter
                                  float *x12, float *x22, float *x32,
                                  float *x13, float *x23, float *x33 ) override;
 
+  protected:
+
+    void processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width ) override SIP_SKIP;
 
 #ifdef HAVE_OPENCL
   private:
@@ -82,3 +82,8 @@ void QgsHillshadeFilter::addExtraRasterParams( std::vector<float> &params )
 }
 
 #endif
+
+void QgsHillshadeFilter::processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+{
+  processNineCellRowFor< QgsHillshadeFilter >( rowAbove, row, rowBelow, result, width );
+}
@@ -43,6 +43,10 @@ class ANALYSIS_EXPORT QgsHillshadeFilter: public QgsDerivativeFilter
     float lightAngle() const { return mLightAngle; }
     void setLightAngle( float angle );
 
+  protected:
+
+    void processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width ) override SIP_SKIP;
+
   private:
 
 #ifdef HAVE_OPENCL
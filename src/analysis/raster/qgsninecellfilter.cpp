@@ -30,8 +30,12 @@
 #include <QFile>
 #include <QDebug>
 #include <QFileInfo>
+#include <QtConcurrentMap>
 #include <iterator>
+#include <numeric>
 
+//! Maximum number of cells of a band of rows processed at once
+static const int NINE_CELL_BAND_CELLS = 4 * 1024 * 1024;
 
 
 QgsNineCellFilter::QgsNineCellFilter( const QString &inputFile, const QString &outputFile, const QString &outputFormat )
@@ -350,6 +354,14 @@ int QgsNineCellFilter::processRasterGPU( const QString &source, QgsFeedback *fee
 #endif
 
 
+void QgsNineCellFilter::processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+{
+  processRow( rowAbove, row, rowBelow, result, width, [this]( float * x11, float * x21, float * x31, float * x12, float * x22, float * x32, float * x13, float * x23, float * x33 )
+  {
+    return processNineCellWindow( x11, x21, x31, x12, x22, x32, x13, x23, x33 );
+  } );
+}
+
 // TODO: return an anum instead of an int
 int QgsNineCellFilter::processRasterCPU( QgsFeedback *feedback )
 {
@@ -399,92 +411,96 @@ int QgsNineCellFilter::processRasterCPU( QgsFeedback *feedback )
     return 6;
   }
 
-  //keep only three scanlines in memory at a time, make room for initial and final nodata
-  std::size_t bufferSize( sizeof( float ) * ( xSize + 2 ) );
-  float *scanLine1 = ( float * ) CPLMalloc( bufferSize );
-  float *scanLine2 = ( float * ) CPLMalloc( bufferSize );
-  float *scanLine3 = ( float * ) CPLMalloc( bufferSize );
-
-  float *resultLine = ( float * ) CPLMalloc( sizeof( float ) * xSize );
+  // The raster is processed by bands of rows. Each band is read with one row of halo above
+  // and below, and its rows are computed in parallel. GDAL datasets cannot be shared between
+  // threads, so reading and writing are done on this thread, while the previous and the next
+  // bands are being computed. Make room for initial and final nodata columns.
+  const int lineSize = xSize + 2;
+  const int bandHeight = std::max( 1, std::min( ySize, NINE_CELL_BAND_CELLS / lineSize ) );
+  const int bandCount = ( ySize + bandHeight - 1 ) / bandHeight;
+
+  std::vector< float > inputBuffers[2];
+  std::vector< float > outputBuffers[2];
+  for ( int i = 0; i < 2; ++i )
+  {
+    inputBuffers[i].resize( static_cast< std::size_t >( bandHeight + 2 ) * lineSize );
+    outputBuffers[i].resize( static_cast< std::size_t >( bandHeight ) * xSize );
+  }
 
   //values outside the layer extent (if the 3x3 window is on the border) are sent to the processing method as (input) nodata values
-  for ( int yIndex = 0; yIndex < ySize; ++yIndex )
+  auto readBand = [ =, &inputBuffers ]( int band )
   {
-    if ( feedback && feedback->isCanceled() )
+    const int firstRow = band * bandHeight;
+    const int rows = std::min( bandHeight, ySize - firstRow );
+    float *buffer = inputBuffers[band % 2].data();
+    // the first and last columns, and the rows outside of the raster, stay at nodata
+    std::fill( buffer, buffer + static_cast< std::size_t >( rows + 2 ) * lineSize, mInputNodataValue );
+
+    // rows firstRow - 1 to firstRow + rows, within the raster
+    const int readFirstRow = std::max( 0, firstRow - 1 );
+    const int readLastRow = std::min( ySize - 1, firstRow + rows );
+    float *readStart = buffer + static_cast< std::size_t >( readFirstRow - firstRow + 1 ) * lineSize + 1;
+    if ( GDALRasterIO( rasterBand, GF_Read, 0, readFirstRow, xSize, readLastRow - readFirstRow + 1, readStart, xSize, readLastRow - readFirstRow + 1,
+                       GDT_Float32, sizeof( float ), static_cast< GSpacing >( sizeof( float ) ) * lineSize ) != CE_None )
     {
-      break;
+      QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
     }
+  };
 
-    if ( feedback )
+  auto writeBand = [ =, &outputBuffers ]( int band )
+  {
+    const int firstRow = band * bandHeight;
+    const int rows = std::min( bandHeight, ySize - firstRow );
+    if ( GDALRasterIO( outputRasterBand, GF_Write, 0, firstRow, xSize, rows, outputBuffers[band % 2].data(), xSize, rows, GDT_Float32, 0, 0 ) != CE_None )
     {
-      feedback->setProgress( 100.0 * static_cast< double >( yIndex ) / ySize );
+      QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
     }
+  };
 
-    if ( yIndex == 0 )
-    {
-      //fill scanline 1 with (input) nodata for the values above the first row and feed scanline2 with the first row
-      for ( int a = 0; a < xSize + 2 ; ++a )
-      {
-        scanLine1[a] = mInputNodataValue;
-      }
-      // Read scanline2
-      if ( GDALRasterIO( rasterBand, GF_Read, 0, 0, xSize, 1, &scanLine2[1], xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
-      {
-        QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
-      }
-    }
-    else
+  QVector< int > rowIndices;
+  readBand( 0 );
+  for ( int band = 0; band < bandCount; ++band )
+  {
+    if ( feedback && feedback->isCanceled() )
     {
-      //normally fetch only scanLine3 and release scanline 1 if we move forward one row
-      CPLFree( scanLine1 );
-      scanLine1 = scanLine2;
-      scanLine2 = scanLine3;
-      scanLine3 = ( float * ) CPLMalloc( bufferSize );
+      break;
     }
 
-    // Read scanline 3
-    if ( yIndex == ySize - 1 ) //fill the row below the bottom with nodata values
-    {
-      for ( int a = 0; a < xSize + 2; ++a )
-      {
-        scanLine3[a] = mInputNodataValue;
-      }
-    }
-    else
+    if ( feedback )
     {
-      if ( GDALRasterIO( rasterBand, GF_Read, 0, yIndex + 1, xSize, 1, &scanLine3[1], xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
-      {
-        QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
-      }
+      feedback->setProgress( 100.0 * static_cast< double >( band ) / bandCount );
     }
-    // Set first and last extra columns to nodata
-    scanLine1[0] = scanLine1[xSize + 1] = mInputNodataValue;
-    scanLine2[0] = scanLine2[xSize + 1] = mInputNodataValue;
-    scanLine3[0] = scanLine3[xSize + 1] = mInputNodataValue;
-
 
+    const int rows = std::min( bandHeight, ySize - band * bandHeight );
+    rowIndices.resize( rows );
+    std::iota( rowIndices.begin(), rowIndices.end(), 0 );
 
-    // j is the x axis index, skip 0 and last cell that have been filled with nodata
-    for ( int xIndex = 0; xIndex < xSize ; ++xIndex )
+    float *input = inputBuffers[band % 2].data();
+    float *output = outputBuffers[band % 2].data();
+    QFuture< void > future = QtConcurrent::map( rowIndices, [ = ]( int row )
     {
-      // cells(x, y) x11, x21, x31, x12, x22, x32, x13, x23, x33
-      resultLine[ xIndex ] = processNineCellWindow( &scanLine1[ xIndex ], &scanLine1[ xIndex + 1 ], &scanLine1[ xIndex + 2 ],
-                             &scanLine2[ xIndex ], &scanLine2[ xIndex + 1 ], &scanLine2[ xIndex + 2 ],
-                             &scanLine3[ xIndex ], &scanLine3[ xIndex + 1 ], &scanLine3[ xIndex + 2 ] );
+      processNineCellRow( input + static_cast< std::size_t >( row ) * lineSize,
+                          input + static_cast< std::size_t >( row + 1 ) * lineSize,
+                          input + static_cast< std::size_t >( row + 2 ) * lineSize,
+                          output + static_cast< std::size_t >( row ) * xSize, xSize );
+    } );
 
+    if ( band + 1 < bandCount )
+    {
+      readBand( band + 1 );
+    }
+    if ( band > 0 )
+    {
+      writeBand( band - 1 );
     }
+    future.waitForFinished();
 
-    if ( GDALRasterIO( outputRasterBand, GF_Write, 0, yIndex, xSize, 1, resultLine, xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
+    if ( band == bandCount - 1 )
     {
-      QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
+      writeBand( band );
     }
   }
 
-  CPLFree( resultLine );
-  CPLFree( scanLine1 );
-  CPLFree( scanLine2 );
-  CPLFree( scanLine3 );
-
   if ( feedback && feedback->isCanceled() )
   {
     //delete the dataset without closing (because it is faster)
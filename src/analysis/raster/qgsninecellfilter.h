@@ -19,8 +19,10 @@
 #define QGSNINECELLFILTER_H
 
 #include <QString>
+#include <typeinfo>
 #include "gdal.h"
 #include "qgis_analysis.h"
+#include "qgis_sip.h"
 #include "qgsogrutils.h"
 
 class QgsFeedback;
@@ -43,7 +45,7 @@ class ANALYSIS_EXPORT QgsNineCellFilter
      * \param feedback feedback object that receives update and that is checked for cancelation.
      * \returns 0 in case of success
      */
-    int processRaster( QgsFeedback *feedback = nullptr );
+    int processRaster( QgsFeedback *feedback = nullptr ) SIP_RELEASEGIL;
 
     double cellSizeX() const { return mCellSizeX; }
     void setCellSizeX( double size ) { mCellSizeX = size; }
@@ -65,6 +67,9 @@ class ANALYSIS_EXPORT QgsNineCellFilter
      *
      * First index of the input cell is the row, second index is the column
      *
+     * Since QGIS 3.6, this method may be called concurrently from several threads,
+     * so implementations must not modify the filter state.
+     *
      * \param x11 surrounding cell top left
      * \param x21 surrounding cell central left
      * \param x31 surrounding cell bottom left
@@ -84,6 +89,21 @@ class ANALYSIS_EXPORT QgsNineCellFilter
     //default constructor forbidden. We need input file, output file and format obligatory
     QgsNineCellFilter() = delete;
 
+#ifndef SIP_RUN
+    //! Calls \a window for each cell of a row, see processNineCellRow()
+    template< class Window >
+    static void processRow( float *rowAbove, float *row, float *rowBelow, float *result, int width, const Window &window )
+    {
+      for ( int xIndex = 0; xIndex < width; ++xIndex )
+      {
+        // cells(x, y) x11, x21, x31, x12, x22, x32, x13, x23, x33
+        result[ xIndex ] = window( &rowAbove[ xIndex ], &rowAbove[ xIndex + 1 ], &rowAbove[ xIndex + 2 ],
+                                   &row[ xIndex ], &row[ xIndex + 1 ], &row[ xIndex + 2 ],
+                                   &rowBelow[ xIndex ], &rowBelow[ xIndex + 1 ], &rowBelow[ xIndex + 2 ] );
+      }
+    }
+#endif
+
     //! Opens the input file and returns the dataset handle and the number of pixels in x-/y- direction
     gdal::dataset_unique_ptr openInputFile( int &nCellsX, int &nCellsY );
 
@@ -133,6 +153,48 @@ class ANALYSIS_EXPORT QgsNineCellFilter
 
   protected:
 
+    /**
+     * Calculates the output values of a whole row of cells. \a rowAbove, \a row and \a rowBelow
+     * hold width + 2 input values: the first and last ones are the nodata values outside
+     * of the raster border. \a result receives the \a width output values.
+     *
+     * The default implementation calls processNineCellWindow() for each cell. Subclasses
+     * can reimplement it with processNineCellRowFor() to avoid the virtual call per cell.
+     *
+     * This method may be called concurrently from several threads, for different rows.
+     *
+     * \since QGIS 3.6
+     */
+    virtual void processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width ) SIP_SKIP;
+
+#ifndef SIP_RUN
+
+    /**
+     * Implementation of processNineCellRow() for filters of type \a Filter, which calls
+     * Filter::processNineCellWindow() without virtual dispatch, so that it can be inlined.
+     *
+     * Instances of subclasses of \a Filter may override processNineCellWindow(), so the
+     * default implementation is used for them.
+     *
+     * \since QGIS 3.6
+     */
+    template< class Filter >
+    void processNineCellRowFor( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+    {
+      if ( typeid( *this ) != typeid( Filter ) )
+      {
+        QgsNineCellFilter::processNineCellRow( rowAbove, row, rowBelow, result, width );
+        return;
+      }
+
+      Filter *filter = static_cast< Filter * >( this );
+      processRow( rowAbove, row, rowBelow, result, width, [filter]( float * x11, float * x21, float * x31, float * x12, float * x22, float * x32, float * x13, float * x23, float * x33 )
+      {
+        return filter->Filter::processNineCellWindow( x11, x21, x31, x12, x22, x32, x13, x23, x33 );
+      } );
+    }
+#endif
+
     QString mInputFile;
     QString mOutputFile;
     QString mOutputFormat;
@@ -0,0 +1,261 @@
+/***************************************************************************
+    qgsrastercalcprogram.cpp
+    ---------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgsrastercalcprogram.h"
+#include "qgsrasterblock.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cmath>
+
+QgsRasterCalcProgram::QgsRasterCalcProgram( double nodataValue )
+  : mNodataValue( nodataValue )
+{
+}
+
+bool QgsRasterCalcProgram::compile( const QgsRasterCalcNode *node )
+{
+  mInstructions.clear();
+  mRasterNames.clear();
+  mStackSize = 0;
+
+  if ( !node || !compileNode( node, 0 ) )
+  {
+    mInstructions.clear();
+    mRasterNames.clear();
+    return false;
+  }
+  return true;
+}
+
+bool QgsRasterCalcProgram::compileNode( const QgsRasterCalcNode *node, int depth )
+{
+  switch ( node->mType )
+  {
+    case QgsRasterCalcNode::tNumber:
+      mInstructions.append( { PushNumber, QgsRasterCalcNode::opNONE, -1, node->mNumber } );
+      mStackSize = std::max( mStackSize, depth + 1 );
+      return true;
+
+    case QgsRasterCalcNode::tRasterRef:
+    {
+      int raster = mRasterNames.indexOf( node->mRasterName );
+      if ( raster < 0 )
+      {
+        raster = mRasterNames.size();
+        mRasterNames << node->mRasterName;
+      }
+      mInstructions.append( { PushRaster, QgsRasterCalcNode::opNONE, raster, 0 } );
+      mStackSize = std::max( mStackSize, depth + 1 );
+      return true;
+    }
+
+    case QgsRasterCalcNode::tMatrix:
+      return false;
+
+    case QgsRasterCalcNode::tOperator:
+      break;
+  }
+
+  switch ( node->mOperator )
+  {
+    case QgsRasterCalcNode::opSQRT:
+    case QgsRasterCalcNode::opSIN:
+    case QgsRasterCalcNode::opCOS:
+    case QgsRasterCalcNode::opTAN:
+    case QgsRasterCalcNode::opASIN:
+    case QgsRasterCalcNode::opACOS:
+    case QgsRasterCalcNode::opATAN:
+    case QgsRasterCalcNode::opSIGN:
+    case QgsRasterCalcNode::opLOG:
+    case QgsRasterCalcNode::opLOG10:
+    {
+      if ( !node->mLeft || !compileNode( node->mLeft, depth ) )
+        return false;
+
+      Instruction &operand = mInstructions.last();
+      if ( operand.kind == PushNumber )
+      {
+        // constant folding
+        if ( operand.number != mNodataValue )
+          operand.number = unaryOperation( node->mOperator, operand.number );
+      }
+      else
+      {
+        mInstructions.append( { UnaryOperator, node->mOperator, -1, 0 } );
+      }
+      return true;
+    }
+
+    case QgsRasterCalcNode::opPLUS:
+    case QgsRasterCalcNode::opMINUS:
+    case QgsRasterCalcNode::opMUL:
+    case QgsRasterCalcNode::opDIV:
+    case QgsRasterCalcNode::opPOW:
+    case QgsRasterCalcNode::opEQ:
+    case QgsRasterCalcNode::opNE:
+    case QgsRasterCalcNode::opGT:
+    case QgsRasterCalcNode::opLT:
+    case QgsRasterCalcNode::opGE:
+    case QgsRasterCalcNode::opLE:
+    case QgsRasterCalcNode::opAND:
+    case QgsRasterCalcNode::opOR:
+    {
+      if ( !node->mLeft || !node->mRight )
+        return false;
+      if ( !compileNode( node->mLeft, depth ) || !compileNode( node->mRight, depth + 1 ) )
+        return false;
+
+      // the right operand is always the last instruction when it is a constant, and
+      // a constant left operand is then the one just before
+      const int count = mInstructions.size();
+      if ( mInstructions.at( count - 1 ).kind == PushNumber && mInstructions.at( count - 2 ).kind == PushNumber )
+      {
+        // constant folding
+        const double arg1 = mInstructions.at( count - 2 ).number;
+        const double arg2 = mInstructions.at( count - 1 ).number;
+        mInstructions.removeLast();
+        mInstructions.last().number = ( arg1 == mNodataValue || arg2 == mNodataValue ) ? mNodataValue : binaryOperation( node->mOperator, arg1, arg2 );
+      }
+      else
+      {
+        mInstructions.append( { BinaryOperator, node->mOperator, -1, 0 } );
+      }
+      return true;
+    }
+
+    case QgsRasterCalcNode::opNONE:
+      break;
+  }
+  return false;
+}
+
+double QgsRasterCalcProgram::evaluate( const QVector< const QgsRasterBlock * > &blocks, qgssize index ) const
+{
+  QVarLengthArray< double, 32 > stack( mStackSize );
+  return run( blocks, index, stack.data() );
+}
+
+void QgsRasterCalcProgram::evaluate( const QVector< const QgsRasterBlock * > &blocks, qgssize index, int count, float *result ) const
+{
+  QVarLengthArray< double, 32 > stack( mStackSize );
+  for ( int i = 0; i < count; ++i )
+  {
+    result[i] = static_cast< float >( run( blocks, index + i, stack.data() ) );
+  }
+}
+
+double QgsRasterCalcProgram::run( const QVector< const QgsRasterBlock * > &blocks, qgssize index, double *stack ) const
+{
+  double *top = stack - 1;
+  for ( const Instruction &instruction : mInstructions )
+  {
+    switch ( instruction.kind )
+    {
+      case PushNumber:
+        *++top = instruction.number;
+        break;
+
+      case PushRaster:
+      {
+        const QgsRasterBlock *block = blocks.at( instruction.raster );
+        *++top = block->isNoData( index ) ? mNodataValue : block->value( index );
+        break;
+      }
+
+      case UnaryOperator:
+        if ( *top != mNodataValue )
+          *top = unaryOperation( instruction.op, *top );
+        break;
+
+      case BinaryOperator:
+      {
+        const double arg2 = *top--;
+        const double arg1 = *top;
+        *top = ( arg1 == mNodataValue || arg2 == mNodataValue ) ? mNodataValue : binaryOperation( instruction.op, arg1, arg2 );
+        break;
+      }
+    }
+  }
+  return *top;
+}
+
+double QgsRasterCalcProgram::unaryOperation( QgsRasterCalcNode::Operator op, double value ) const
+{
+  // must match QgsRasterMatrix::oneArgumentOperation()
+  switch ( op )
+  {
+    case QgsRasterCalcNode::opSQRT:
+      return value < 0 ? mNodataValue : std::sqrt( value );
+    case QgsRasterCalcNode::opSIN:
+      return std::sin( value );
+    case QgsRasterCalcNode::opCOS:
+      return std::cos( value );
+    case QgsRasterCalcNode::opTAN:
+      return std::tan( value );
+    case QgsRasterCalcNode::opASIN:
+      return std::asin( value );
+    case QgsRasterCalcNode::opACOS:
+      return std::acos( value );
+    case QgsRasterCalcNode::opATAN:
+      return std::atan( value );
+    case QgsRasterCalcNode::opSIGN:
+      return -value;
+    case QgsRasterCalcNode::opLOG:
+      return value <= 0 ? mNodataValue : std::log( value );
+    case QgsRasterCalcNode::opLOG10:
+      return value <= 0 ? mNodataValue : std::log10( value );
+    default:
+      break;
+  }
+  return mNodataValue;
+}
+
+double QgsRasterCalcProgram::binaryOperation( QgsRasterCalcNode::Operator op, double arg1, double arg2 ) const
+{
+  // must match QgsRasterMatrix::calculateTwoArgumentOp()
+  switch ( op )
+  {
+    case QgsRasterCalcNode::opPLUS:
+      return arg1 + arg2;
+    case QgsRasterCalcNode::opMINUS:
+      return arg1 - arg2;
+    case QgsRasterCalcNode::opMUL:
+      return arg1 * arg2;
+    case QgsRasterCalcNode::opDIV:
+      return arg2 == 0 ? mNodataValue : arg1 / arg2;
+    case QgsRasterCalcNode::opPOW:
+      if ( ( arg1 == 0 && arg2 < 0 ) || ( arg1 < 0 && ( arg2 - std::floor( arg2 ) ) > 0 ) )
+        return mNodataValue;
+      return std::pow( arg1, arg2 );
+    case QgsRasterCalcNode::opEQ:
+      return arg1 == arg2 ? 1.0 : 0.0;
+    case QgsRasterCalcNode::opNE:
+      return arg1 == arg2 ? 0.0 : 1.0;
+    case QgsRasterCalcNode::opGT:
+      return arg1 > arg2 ? 1.0 : 0.0;
+    case QgsRasterCalcNode::opLT:
+      return arg1 < arg2 ? 1.0 : 0.0;
+    case QgsRasterCalcNode::opGE:
+      return arg1 >= arg2 ? 1.0 : 0.0;
+    case QgsRasterCalcNode::opLE:
+      return arg1 <= arg2 ? 1.0 : 0.0;
+    case QgsRasterCalcNode::opAND:
+      return arg1 && arg2 ? 1.0 : 0.0;
+    case QgsRasterCalcNode::opOR:
+      return arg1 || arg2 ? 1.0 : 0.0;
+    default:
+      break;
+  }
+  return mNodataValue;
+}
@@ -0,0 +1,120 @@
+/***************************************************************************
+                          qgsrastercalcprogram.h
+            Compiled form of a raster calculator expression
+                          --------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSRASTERCALCPROGRAM_H
+#define QGSRASTERCALCPROGRAM_H
+
+#define SIP_NO_FILE
+
+#include "qgis_analysis.h"
+#include "qgsrastercalcnode.h"
+
+#include <QStringList>
+#include <QVector>
+
+class QgsRasterBlock;
+
+/**
+ * \ingroup analysis
+ * \class QgsRasterCalcProgram
+ * \brief A raster calculator expression compiled to a flat list of instructions.
+ *
+ * The expression tree of a QgsRasterCalcNode is flattened to a postfix program which
+ * is evaluated pixel by pixel on a small value stack, reading the input values straight
+ * from the raster blocks in their native data type. Contrary to QgsRasterCalcNode::calculate(),
+ * no intermediate matrix is allocated for the nodes of the tree, and subexpressions
+ * made of constants only are folded when compiling.
+ *
+ * The results (including the handling of no data values) are identical to the ones
+ * of QgsRasterCalcNode::calculate(). Expressions containing matrix nodes cannot be compiled.
+ *
+ * Evaluation does not modify the program, so a compiled program can be evaluated
+ * concurrently from several threads.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+class ANALYSIS_EXPORT QgsRasterCalcProgram
+{
+  public:
+
+    /**
+     * Constructor for QgsRasterCalcProgram, using \a nodataValue as the no data value
+     * of the results.
+     */
+    explicit QgsRasterCalcProgram( double nodataValue = -1 );
+
+    /**
+     * Compiles the expression tree starting at \a node. Returns false if the expression
+     * cannot be compiled, e.g. if it contains matrix nodes.
+     */
+    bool compile( const QgsRasterCalcNode *node );
+
+    //! Returns true if a valid expression has been compiled
+    bool isValid() const { return !mInstructions.isEmpty(); }
+
+    //! Returns the no data value of the results
+    double nodataValue() const { return mNodataValue; }
+
+    /**
+     * Returns the names of the rasters referenced by the expression. Blocks passed
+     * to evaluate() must follow the same order.
+     */
+    QStringList rasterNames() const { return mRasterNames; }
+
+    /**
+     * Evaluates the program for the pixel at \a index of the input \a blocks.
+     */
+    double evaluate( const QVector< const QgsRasterBlock * > &blocks, qgssize index ) const;
+
+    /**
+     * Evaluates the program for the \a count pixels starting at \a index of the input
+     * \a blocks, and stores the results in \a result.
+     */
+    void evaluate( const QVector< const QgsRasterBlock * > &blocks, qgssize index, int count, float *result ) const;
+
+  private:
+
+    //! Kind of a program instruction
+    enum Kind
+    {
+      PushNumber,
+      PushRaster,
+      UnaryOperator,
+      BinaryOperator,
+    };
+
+    struct Instruction
+    {
+      Kind kind;
+      QgsRasterCalcNode::Operator op;
+      int raster;
+      double number;
+    };
+
+    double mNodataValue = -1;
+    QVector< Instruction > mInstructions;
+    QStringList mRasterNames;
+    int mStackSize = 0;
+
+    bool compileNode( const QgsRasterCalcNode *node, int depth );
+    double run( const QVector< const QgsRasterBlock * > &blocks, qgssize index, double *stack ) const;
+    double unaryOperation( QgsRasterCalcNode::Operator op, double value ) const;
+    double binaryOperation( QgsRasterCalcNode::Operator op, double arg1, double arg2 ) const;
+};
+
+#endif // QGSRASTERCALCPROGRAM_H
@@ -17,6 +17,7 @@
 
 #include "qgsgdalutils.h"
 #include "qgsrastercalculator.h"
+#include "qgsrastercalcprogram.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasterinterface.h"
 #include "qgsrasterlayer.h"
@@ -27,6 +28,10 @@
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <numeric>
 
 #include <cpl_string.h>
 #include <gdalwarper.h>
@@ -36,6 +41,9 @@
 #include "qgsgdalutils.h"
 #endif
 
+//! Maximum number of cells of the output bands computed in parallel by the CPU route
+static const int RASTER_CALC_BAND_CELLS = 1024 * 1024;
+
 QgsRasterCalculator::QgsRasterCalculator( const QString &formulaString, const QString &outputFile, const QString &outputFormat,
     const QgsRectangle &outputExtent, int nOutputColumns, int nOutputRows, const QVector<QgsRasterCalculatorEntry> &rasterEntries )
   : mFormulaString( formulaString )
@@ -123,90 +131,142 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
   // in the expression
   bool requiresMatrix = ! calcNode->findNodes( QgsRasterCalcNode::Type::tMatrix ).isEmpty();
 
-  // Take the fast route (process one line at a time) if we can
+  // Take the fast route (process bands of lines) if we can
   if ( ! requiresMatrix )
   {
-    // Map of raster names -> blocks
-    std::map<QString, std::unique_ptr<QgsRasterBlock>> inputBlocks;
-    std::map<QString, QgsRasterCalculatorEntry> uniqueRasterEntries;
-    for ( const auto &r : calcNode->findNodes( QgsRasterCalcNode::Type::tRasterRef ) )
+    // The expression is compiled to a flat program evaluated pixel by pixel, which avoids
+    // allocating one matrix per node and per line
+    QgsRasterCalcProgram program( outputNodataValue );
+    if ( !program.compile( calcNode.get() ) )
+    {
+      mLastError = QObject::tr( "Could not compile expression %1" ).arg( mFormulaString );
+      gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
+      return ParserError;
+    }
+
+    QVector< QgsRasterCalculatorEntry > inputEntries;
+    std::vector< std::unique_ptr< QgsRasterProjector > > projectors;
+    const QStringList rasterNames = program.rasterNames();
+    for ( const QString &rasterName : rasterNames )
     {
-      QString layerRef( r->toString().remove( 0, 1 ) );
-      layerRef.chop( 1 );
-      if ( ! inputBlocks.count( layerRef ) )
+      auto entryIt = std::find_if( mRasterEntries.constBegin(), mRasterEntries.constEnd(), [&rasterName]( const QgsRasterCalculatorEntry & entry )
       {
-        for ( const auto &ref : mRasterEntries )
+        return entry.ref == rasterName;
+      } );
+      if ( entryIt == mRasterEntries.constEnd() )
+      {
+        mLastError = QObject::tr( "No raster layer for entry %1" ).arg( rasterName );
+        gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
+        return InputLayerError;
+      }
+      inputEntries << *entryIt;
+
+      std::unique_ptr< QgsRasterProjector > proj;
+      if ( entryIt->raster->crs() != mOutputCrs )
+      {
+        proj = qgis::make_unique< QgsRasterProjector >();
+        proj->setCrs( entryIt->raster->crs(), mOutputCrs );
+        proj->setInput( entryIt->raster->dataProvider() );
+        proj->setPrecision( QgsRasterProjector::Exact );
+      }
+      projectors.push_back( std::move( proj ) );
+    }
+
+    // Lines are processed by bands, whose lines are computed in parallel. Data providers and
+    // GDAL datasets cannot be shared between threads, so inputs are read and results written
+    // on this thread, while the previous and the next bands are being computed. Inputs are
+    // still requested one line at a time, so that they are resampled exactly as before.
+    const int inputCount = inputEntries.size();
+    const int bandHeight = std::max( 1, std::min( mNumOutputRows, RASTER_CALC_BAND_CELLS / std::max( 1, mNumOutputColumns ) ) );
+    const int bandCount = ( mNumOutputRows + bandHeight - 1 ) / bandHeight;
+    const double rowHeight = mOutputRectangle.height() / mNumOutputRows;
+
+    std::vector< std::unique_ptr< QgsRasterBlock > > inputBlocks[2];
+    QVector< QVector< const QgsRasterBlock * > > lineBlocks[2];
+    std::vector< float > outputBuffers[2];
+    for ( int i = 0; i < 2; ++i )
+    {
+      inputBlocks[i].resize( static_cast< std::size_t >( bandHeight ) * inputCount );
+      lineBlocks[i].resize( bandHeight );
+      outputBuffers[i].resize( static_cast< std::size_t >( bandHeight ) * mNumOutputColumns );
+    }
+
+    auto readBand = [ &, bandHeight ]( int band )
+    {
+      const int firstRow = band * bandHeight;
+      const int rows = std::min( bandHeight, mNumOutputRows - firstRow );
+      for ( int row = 0; row < rows; ++row )
+      {
+        // Calculates the rect for a single row read
+        QgsRectangle rect( mOutputRectangle );
+        rect.setYMaximum( rect.yMaximum() - rowHeight * ( firstRow + row ) );
+        rect.setYMinimum( rect.yMaximum() - rowHeight );
+
+        QVector< const QgsRasterBlock * > &blocks = lineBlocks[band % 2][row];
+        blocks.resize( inputCount );
+        for ( int input = 0; input < inputCount; ++input )
         {
-          if ( ref.ref == layerRef )
-          {
-            uniqueRasterEntries[layerRef] = ref;
-            inputBlocks[layerRef ] = qgis::make_unique<QgsRasterBlock>();
-          }
+          const QgsRasterCalculatorEntry &ref = inputEntries.at( input );
+          std::unique_ptr< QgsRasterBlock > &block = inputBlocks[band % 2][static_cast< std::size_t >( row ) * inputCount + input];
+          if ( projectors[input] )
+            block.reset( projectors[input]->block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
+          else
+            block.reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
+          blocks[input] = block.get();
         }
       }
-    }
+    };
 
-    //read / write line by line
-    QMap<QString, QgsRasterBlock * > _rasterData;
-    // Cast to float
-    std::vector<float> castedResult;
-    castedResult.reserve( static_cast<size_t>( mNumOutputColumns ) );
-    auto rowHeight = mOutputRectangle.height() / mNumOutputRows;
-    for ( size_t row = 0; row < static_cast<size_t>( mNumOutputRows ); ++row )
+    auto writeBand = [ &, bandHeight ]( int band )
     {
-      if ( feedback )
+      const int firstRow = band * bandHeight;
+      const int rows = std::min( bandHeight, mNumOutputRows - firstRow );
+      if ( GDALRasterIO( outputRasterBand, GF_Write, 0, firstRow, mNumOutputColumns, rows, outputBuffers[band % 2].data(), mNumOutputColumns, rows, GDT_Float32, 0, 0 ) != CE_None )
       {
-        feedback->setProgress( 100.0 * static_cast< double >( row ) / mNumOutputRows );
+        QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
       }
+    };
 
+    QVector< int > rowIndices;
+    if ( !feedback || !feedback->isCanceled() )
+      readBand( 0 );
+    for ( int band = 0; band < bandCount; ++band )
+    {
       if ( feedback && feedback->isCanceled() )
       {
         break;
       }
 
-      // Calculates the rect for a single row read
-      QgsRectangle rect( mOutputRectangle );
-      rect.setYMaximum( rect.yMaximum() - rowHeight * row );
-      rect.setYMinimum( rect.yMaximum() - rowHeight );
-
-      // Read rows into input blocks
-      for ( auto &layerRef : inputBlocks )
+      if ( feedback )
       {
-        QgsRasterCalculatorEntry ref = uniqueRasterEntries[layerRef.first];
-        if ( uniqueRasterEntries[layerRef.first].raster->crs() != mOutputCrs )
-        {
-          QgsRasterProjector proj;
-          proj.setCrs( ref.raster->crs(), mOutputCrs );
-          proj.setInput( ref.raster->dataProvider() );
-          proj.setPrecision( QgsRasterProjector::Exact );
-          layerRef.second.reset( proj.block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
-        }
-        else
-        {
-          inputBlocks[layerRef.first].reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
-        }
+        feedback->setProgress( 100.0 * static_cast< double >( band ) / bandCount );
       }
 
-      QgsRasterMatrix resultMatrix;
-      resultMatrix.setNodataValue( outputNodataValue );
+      const int rows = std::min( bandHeight, mNumOutputRows - band * bandHeight );
+      rowIndices.resize( rows );
+      std::iota( rowIndices.begin(), rowIndices.end(), 0 );
 
-      _rasterData.clear();
-      for ( const auto &layerRef : inputBlocks )
+      const QVector< QVector< const QgsRasterBlock * > > &blocks = lineBlocks[band % 2];
+      float *output = outputBuffers[band % 2].data();
+      const int columns = mNumOutputColumns;
+      QFuture< void > future = QtConcurrent::map( rowIndices, [ =, &program, &blocks ]( int row )
       {
-        _rasterData.insert( layerRef.first, inputBlocks[layerRef.first].get() );
+        program.evaluate( blocks.at( row ), 0, columns, output + static_cast< std::size_t >( row ) * columns );
+      } );
+
+      if ( band + 1 < bandCount )
+      {
+        readBand( band + 1 );
       }
+      if ( band > 0 )
+      {
+        writeBand( band - 1 );
+      }
+      future.waitForFinished();
 
-      if ( calcNode->calculate( _rasterData, resultMatrix, 0 ) )
+      if ( band == bandCount - 1 )
       {
-        // write scanline to the dataset
-        for ( size_t i = 0; i < static_cast<size_t>( mNumOutputColumns ); i++ )
-        {
-          castedResult[i] = static_cast<float>( resultMatrix.data()[i] );
-        }
-        if ( GDALRasterIO( outputRasterBand, GF_Write, 0, row, mNumOutputColumns, 1, castedResult.data(), mNumOutputColumns, 1, GDT_Float32, 0, 0 ) != CE_None )
-        {
-          QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
-        }
+        writeBand( band );
       }
     }
 
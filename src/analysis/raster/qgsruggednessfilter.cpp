@@ -84,3 +84,7 @@ float QgsRuggednessFilter::processNineCellWindow( float *x11, float *x21, float
   return std::sqrt( sum );
 }
 
+void QgsRuggednessFilter::processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+{
+  processNineCellRowFor< QgsRuggednessFilter >( rowAbove, row, rowBelow, result, width );
+}
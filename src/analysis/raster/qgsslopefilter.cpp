@@ -40,3 +40,7 @@ float QgsSlopeFilter::processNineCellWindow(
   return std::atan( std::sqrt( derX * derX + derY * derY ) ) * 180.0 / M_PI;
 }
 
+void QgsSlopeFilter::processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+{
+  processNineCellRowFor< QgsSlopeFilter >( rowAbove, row, rowBelow, result, width );
+}
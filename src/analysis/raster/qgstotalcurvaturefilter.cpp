@@ -41,3 +41,8 @@ float QgsTotalCurvatureFilter::processNineCellWindow( float *x11, float *x21, fl
 
   return dxx * dxx + 2 * dxy * dxy + dyy * dyy;
 }
+
+void QgsTotalCurvatureFilter::processNineCellRow( float *rowAbove, float *row, float *rowBelow, float *result, int width )
+{
+  processNineCellRowFor< QgsTotalCurvatureFilter >( rowAbove, row, rowBelow, result, width );
+}
@@ -58,6 +58,8 @@ void QgsGeometryFollowBoundariesCheck::collectErrors( const QMap<QString, QgsFea
     geomt.transform( crst );
 
     std::unique_ptr< QgsGeometryEngine > geomEngine = QgsGeometryCheckerUtils::createGeomEngine( geomt.constGet(), mContext->tolerance );
+    // tested against all the reference features in its bounding box
+    geomEngine->prepareGeometry();
 
     // Get potential reference features
     QgsRectangle searchBounds = geomt.constGet()->boundingBox();
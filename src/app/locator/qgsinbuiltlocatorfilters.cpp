@@ -249,13 +249,21 @@ void QgsActiveLayerFeaturesLocatorFilter::prepare( const QString &string, const
     }
   }
 
-  QString expression = QStringLiteral( "(%1)" ).arg( expressionParts.join( QStringLiteral( " ) OR ( " ) ) );
+  // the text index only covers string fields, numeric searches still go through the provider
+  mIndex.reset();
+  if ( !allowNumeric )
+    mIndex = QgsFeatureTextIndex::indexForLayer( layer, QgsFeatureTextIndex::DisplayExpressionAndStringFields )->index();
 
-  QgsFeatureRequest req;
-  req.setFlags( QgsFeatureRequest::NoGeometry );
-  req.setFilterExpression( expression );
-  req.setLimit( 30 );
-  mIterator = layer->getFeatures( req );
+  if ( !mIndex )
+  {
+    QString expression = QStringLiteral( "(%1)" ).arg( expressionParts.join( QStringLiteral( " ) OR ( " ) ) );
+
+    QgsFeatureRequest req;
+    req.setFlags( QgsFeatureRequest::NoGeometry );
+    req.setFilterExpression( expression );
+    req.setLimit( 30 );
+    mIterator = layer->getFeatures( req );
+  }
 
   mLayerId = layer->id();
   mLayerIcon = QgsMapLayerModel::iconForLayer( layer );
@@ -268,6 +276,29 @@ void QgsActiveLayerFeaturesLocatorFilter::prepare( const QString &string, const
 
 void QgsActiveLayerFeaturesLocatorFilter::fetchResults( const QString &string, const QgsLocatorContext &, QgsFeedback *feedback )
 {
+  if ( mIndex )
+  {
+    const QVector< QgsFeatureTextIndex::Entry > entries = mIndex->search( QStringList() << string, false, 30 );
+    for ( const QgsFeatureTextIndex::Entry &entry : entries )
+    {
+      if ( feedback->isCanceled() )
+        return;
+
+      QgsLocatorResult result;
+      if ( entry.field < mAttributeAliases.count() )
+        result.displayString = QStringLiteral( "%1 (%2)" ).arg( entry.text, mAttributeAliases[entry.field] );
+      else
+        result.displayString = entry.text;
+      result.description = mIndex->displayText( entry.id );
+
+      result.userData = QVariantList() << entry.id << mLayerId;
+      result.icon = mLayerIcon;
+      result.score = static_cast< double >( string.length() ) / result.displayString.size();
+      emit resultFetched( result );
+    }
+    return;
+  }
+
   int found = 0;
   QgsFeature f;
 
@@ -358,25 +389,31 @@ void QgsAllLayersFeaturesLocatorFilter::prepare( const QString &string, const Qg
     context.appendScopes( QgsExpressionContextUtils::globalProjectLayerScopes( layer ) );
     expression.prepare( &context );
 
-    QgsFeatureRequest req;
-    req.setSubsetOfAttributes( expression.referencedAttributeIndexes( layer->fields() ).toList() );
-    if ( !expression.needsGeometry() )
-      req.setFlags( QgsFeatureRequest::NoGeometry );
-    QString enhancedSearch = string;
-    enhancedSearch.replace( ' ', '%' );
-    req.setFilterExpression( QStringLiteral( "%1 ILIKE '%%2%'" )
-                             .arg( layer->displayExpression(), enhancedSearch ) );
-    req.setLimit( 30 );
-
     std::shared_ptr<PreparedLayer> preparedLayer( new PreparedLayer() );
-    preparedLayer->expression = expression;
-    preparedLayer->context = context;
     preparedLayer->layerId = layer->id();
     preparedLayer->layerName = layer->name();
-    preparedLayer->featureSource.reset( new QgsVectorLayerFeatureSource( layer ) );
-    preparedLayer->request = req;
     preparedLayer->layerIcon = QgsMapLayerModel::iconForLayer( layer );
 
+    // search the text index of the layer once it is built, and the provider meanwhile
+    preparedLayer->index = QgsFeatureTextIndex::indexForLayer( layer, QgsFeatureTextIndex::DisplayExpressionOnly )->index();
+    if ( !preparedLayer->index )
+    {
+      QgsFeatureRequest req;
+      req.setSubsetOfAttributes( expression.referencedAttributeIndexes( layer->fields() ).toList() );
+      if ( !expression.needsGeometry() )
+        req.setFlags( QgsFeatureRequest::NoGeometry );
+      QString enhancedSearch = string;
+      enhancedSearch.replace( ' ', '%' );
+      req.setFilterExpression( QStringLiteral( "%1 ILIKE '%%2%'" )
+                               .arg( layer->displayExpression(), enhancedSearch ) );
+      req.setLimit( 30 );
+
+      preparedLayer->expression = expression;
+      preparedLayer->context = context;
+      preparedLayer->featureSource.reset( new QgsVectorLayerFeatureSource( layer ) );
+      preparedLayer->request = req;
+    }
+
     mPreparedLayers.append( preparedLayer );
   }
 }
@@ -391,6 +428,31 @@ void QgsAllLayersFeaturesLocatorFilter::fetchResults( const QString &string, con
   for ( auto preparedLayer : qgis::as_const( mPreparedLayers ) )
   {
     foundInCurrentLayer = 0;
+    if ( preparedLayer->index )
+    {
+      const QVector< QgsFeatureTextIndex::Entry > entries = preparedLayer->index->search( string.split( ' ', QString::SkipEmptyParts ), true, mMaxResultsPerLayer );
+      for ( const QgsFeatureTextIndex::Entry &entry : entries )
+      {
+        if ( feedback->isCanceled() )
+          return;
+
+        QgsLocatorResult result;
+        result.group = preparedLayer->layerName;
+        result.displayString = entry.text;
+        result.userData = QVariantList() << entry.id << preparedLayer->layerId;
+        result.icon = preparedLayer->layerIcon;
+        result.score = static_cast< double >( string.length() ) / result.displayString.size();
+
+        result.actions << QgsLocatorResult::ResultAction( OpenForm, tr( "Open form…" ) );
+        emit resultFetched( result );
+
+        foundInTotal++;
+      }
+      if ( foundInTotal >= mMaxTotalResults )
+        break;
+      continue;
+    }
+
     QgsFeatureIterator it = preparedLayer->featureSource->getFeatures( preparedLayer->request );
     while ( it.nextFeature( f ) )
     {
@@ -21,6 +21,7 @@
 #include "qgis_app.h"
 #include "qgslocatorfilter.h"
 #include "qgsexpressioncontext.h"
+#include "qgsfeaturetextindex.h"
 #include "qgsfeatureiterator.h"
 #include "qgsvectorlayerfeatureiterator.h"
 
@@ -111,6 +112,7 @@ class APP_EXPORT QgsActiveLayerFeaturesLocatorFilter : public QgsLocatorFilter
     QgsExpression mDispExpression;
     QgsExpressionContext mContext;
     QgsFeatureIterator mIterator;
+    std::shared_ptr< const QgsFeatureTextIndex::Index > mIndex;
     QString mLayerId;
     QIcon mLayerIcon;
     QStringList mAttributeAliases;
@@ -134,6 +136,7 @@ class APP_EXPORT QgsAllLayersFeaturesLocatorFilter : public QgsLocatorFilter
         QgsExpressionContext context;
         std::unique_ptr<QgsVectorLayerFeatureSource> featureSource;
         QgsFeatureRequest request;
+        std::shared_ptr< const QgsFeatureTextIndex::Index > index;
         QString layerName;
         QString layerId;
         QIcon layerIcon;
@@ -1302,6 +1302,7 @@ int main( int argc, char *argv[] )
   // set max. thread count
   // this should be done in QgsApplication::init() but it doesn't know the settings dir.
   QgsApplication::setMaxThreads( settings.value( QStringLiteral( "qgis/max_threads" ), -1 ).toInt() );
+  QgsApplication::setMaxConcurrentConnectionsPerPool( settings.value( QStringLiteral( "qgis/max_concurrent_connections_per_pool" ), -1 ).toInt() );
 
   QgisApp *qgis = new QgisApp( mypSplash, myRestorePlugins, mySkipVersionCheck, rootProfileFolder, profileName ); // "QgisApp" used to find canonical instance
   qgis->setObjectName( QStringLiteral( "QgisApp" ) );
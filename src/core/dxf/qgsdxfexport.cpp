@@ -553,6 +553,10 @@ int QgsDxfExport::writeToFile( QIODevice *d, const QString &encoding )
   writeEntities();
   writeEndFile();
 
+  // the device may not outlive the export: write everything now and release it
+  mTextStream.flush();
+  mTextStream.setDevice( nullptr );
+
   return 0;
 }
 
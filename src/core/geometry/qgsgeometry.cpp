@@ -18,6 +18,8 @@ email                : morb at ozemail dot com dot au
 #include <cstdio>
 #include <cmath>
 
+#include <QMutex>
+
 #include "qgis.h"
 #include "qgsgeometry.h"
 #include "qgsgeometryeditutils.h"
@@ -32,6 +34,7 @@ email                : morb at ozemail dot com dot au
 #include "qgsmessagelog.h"
 #include "qgspointxy.h"
 #include "qgsrectangle.h"
+#include "qgswkbptr.h"
 
 #include "qgsvectorlayer.h"
 #include "qgsgeometryvalidator.h"
@@ -47,13 +50,284 @@ email                : morb at ozemail dot com dot au
 #include "qgscircle.h"
 #include "qgscurve.h"
 
+/**
+ * Computes the bounding box of a linear WKB geometry by scanning its coordinates,
+ * without building the geometry tree. Returns false for geometries whose extent
+ * cannot be derived that way (curves, triangles, empty points), for malformed WKB,
+ * or for parts which the geometry parser would reject, i.e. whose flat type is not
+ * \a partType (if different from QgsWkbTypes::Unknown).
+ */
+static bool wkbBoundingBox( QgsConstWkbPtr &wkbPtr, QgsRectangle &rect, bool &hasRect, QgsWkbTypes::Type partType = QgsWkbTypes::Unknown )
+{
+  const QgsWkbTypes::Type type = wkbPtr.readHeader();
+  if ( partType != QgsWkbTypes::Unknown && QgsWkbTypes::flatType( type ) != partType )
+    return false;
+  const int extraDims = ( QgsWkbTypes::hasZ( type ) ? 1 : 0 ) + ( QgsWkbTypes::hasM( type ) ? 1 : 0 );
+  const int extraBytes = extraDims * static_cast< int >( sizeof( double ) );
+
+  auto includePoint = [&rect, &hasRect]( double x, double y )
+  {
+    if ( !hasRect )
+    {
+      rect = QgsRectangle( x, y, x, y );
+      hasRect = true;
+    }
+    else
+    {
+      rect.include( QgsPointXY( x, y ) );
+    }
+  };
+
+  auto readPoints = [&wkbPtr, &includePoint, extraBytes]( int count )
+  {
+    double x, y;
+    for ( int i = 0; i < count; ++i )
+    {
+      wkbPtr >> x >> y;
+      wkbPtr += extraBytes;
+      includePoint( x, y );
+    }
+  };
+
+  switch ( QgsWkbTypes::flatType( type ) )
+  {
+    case QgsWkbTypes::Point:
+    {
+      double x, y;
+      wkbPtr >> x >> y;
+      wkbPtr += extraBytes;
+      // empty points are stored with NaN coordinates
+      if ( std::isnan( x ) || std::isnan( y ) )
+        return false;
+      includePoint( x, y );
+      return true;
+    }
+
+    case QgsWkbTypes::LineString:
+    {
+      int count;
+      wkbPtr >> count;
+      if ( count < 0 )
+        return false;
+      readPoints( count );
+      return true;
+    }
+
+    case QgsWkbTypes::Polygon:
+    {
+      int rings;
+      wkbPtr >> rings;
+      if ( rings < 0 )
+        return false;
+      for ( int ring = 0; ring < rings; ++ring )
+      {
+        int count;
+        wkbPtr >> count;
+        if ( count < 0 )
+          return false;
+        readPoints( count );
+      }
+      return true;
+    }
+
+    case QgsWkbTypes::MultiPoint:
+    case QgsWkbTypes::MultiLineString:
+    case QgsWkbTypes::MultiPolygon:
+    case QgsWkbTypes::GeometryCollection:
+    {
+      // multi geometries only accept parts of their single type
+      const QgsWkbTypes::Type collectionPartType = QgsWkbTypes::flatType( type ) == QgsWkbTypes::GeometryCollection
+          ? QgsWkbTypes::Unknown : QgsWkbTypes::singleType( QgsWkbTypes::flatType( type ) );
+      int parts;
+      wkbPtr >> parts;
+      if ( parts < 0 )
+        return false;
+      for ( int part = 0; part < parts; ++part )
+      {
+        if ( !wkbBoundingBox( wkbPtr, rect, hasRect, collectionPartType ) )
+          return false;
+      }
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * Computes the bounding box of a WKB geometry if it can be done by a plain coordinate
+ * scan. This also checks that the WKB is well formed and has no trailing bytes.
+ * Returns false if the geometry must be parsed instead.
+ */
+static bool wkbEnvelope( const QByteArray &wkb, QgsRectangle &rect )
+{
+  QgsConstWkbPtr wkbPtr( wkb );
+  bool hasRect = false;
+  try
+  {
+    if ( !wkbBoundingBox( wkbPtr, rect, hasRect ) )
+      return false;
+  }
+  catch ( const QgsWkbException & )
+  {
+    return false;
+  }
+  if ( wkbPtr.remaining() != 0 )
+    return false;
+  if ( !hasRect )
+    rect = QgsRectangle();
+  return true;
+}
+
+/**
+ * Holds the geometry tree of a QgsGeometry.
+ *
+ * Geometries created from WKB keep the WKB, and only parse it the first time the
+ * geometry tree is accessed. Consumers which only need the WKB, the geometry type or
+ * the bounding box never pay for building the tree. The WKB is released once parsed,
+ * so that a geometry never holds both.
+ *
+ * The pending WKB lives out of line, and geometries which are not lazy only pay for
+ * an empty pointer. The pointer-like interface mirrors std::unique_ptr, so QgsGeometry
+ * code can use it the same way.
+ */
+class QgsLazyGeometry
+{
+  public:
+
+    //! WKB waiting to be parsed
+    struct Wkb
+    {
+      QByteArray wkb;
+      QgsWkbTypes::Type type = QgsWkbTypes::Unknown;
+      QgsRectangle envelope;
+      //! Serializes the parsing of the WKB by concurrent readers of a shared geometry
+      QMutex mutex;
+      bool parsed = false;
+    };
+
+    QgsLazyGeometry() = default;
+
+    /**
+     * Sets the WKB to lazily build the geometry from, with its precomputed \a envelope.
+     * The WKB must be in native byte order and well formed (see wkbEnvelope()).
+     */
+    void setWkb( const QByteArray &wkb, const QgsRectangle &envelope )
+    {
+      std::shared_ptr< Wkb > pending = std::make_shared< Wkb >();
+      pending->wkb = wkb;
+      pending->type = QgsConstWkbPtr( wkb ).readHeader();
+      pending->envelope = envelope;
+      mGeometry.reset();
+      std::atomic_store( &mWkb, pending );
+    }
+
+    /**
+     * Returns the WKB waiting to be parsed, or nullptr if the geometry tree is built.
+     * The returned object stays valid even if another thread parses the WKB meanwhile.
+     */
+    std::shared_ptr< const Wkb > pendingWkb() const { return std::atomic_load( &mWkb ); }
+
+    QgsAbstractGeometry *get() const
+    {
+      materialize();
+      return mGeometry.get();
+    }
+
+    QgsAbstractGeometry *operator->() const { return get(); }
+    QgsAbstractGeometry &operator*() const { return *get(); }
+
+    explicit operator bool() const
+    {
+      // a well formed WKB always gives a geometry once parsed
+      if ( std::atomic_load( &mWkb ) )
+        return true;
+      return static_cast< bool >( mGeometry );
+    }
+
+    QgsLazyGeometry &operator=( std::unique_ptr< QgsAbstractGeometry > geometry )
+    {
+      std::atomic_store( &mWkb, std::shared_ptr< Wkb >() );
+      mGeometry = std::move( geometry );
+      return *this;
+    }
+
+    void reset( QgsAbstractGeometry *geometry = nullptr )
+    {
+      *this = std::unique_ptr< QgsAbstractGeometry >( geometry );
+    }
+
+    QgsAbstractGeometry *release()
+    {
+      materialize();
+      return mGeometry.release();
+    }
+
+  private:
+
+    void materialize() const
+    {
+      const std::shared_ptr< Wkb > pending = std::atomic_load( &mWkb );
+      if ( !pending )
+        return;
+
+      QMutexLocker locker( &pending->mutex );
+      if ( pending->parsed )
+        return;
+      QgsConstWkbPtr wkbPtr( pending->wkb );
+      mGeometry = QgsGeometryFactory::geomFromWkb( wkbPtr );
+      pending->parsed = true;
+      std::atomic_store( &mWkb, std::shared_ptr< Wkb >() );
+    }
+
+    mutable std::unique_ptr< QgsAbstractGeometry > mGeometry;
+    mutable std::shared_ptr< Wkb > mWkb;
+};
+
 struct QgsGeometryPrivate
 {
   QgsGeometryPrivate(): ref( 1 ) {}
   QAtomicInt ref;
-  std::unique_ptr< QgsAbstractGeometry > geometry;
+  QgsLazyGeometry geometry;
+
+  //! Prepared geometry engine, built by QgsGeometry::prepare(). Protected by preparedEngineMutex
+  std::unique_ptr< QgsGeometryEngine > preparedEngine;
+  QMutex preparedEngineMutex;
+
+  //! Discards the prepared engine, which must be done whenever the geometry is modified
+  void clearPreparedEngine()
+  {
+    QMutexLocker locker( &preparedEngineMutex );
+    preparedEngine.reset();
+  }
 };
 
+/**
+ * Evaluates a spatial \a predicate with \a d as first geometry.
+ *
+ * The prepared engine is used if the geometry was prepared with QgsGeometry::prepare(),
+ * otherwise a temporary engine is created for this test only. If another thread is
+ * already using the prepared engine, a temporary engine is used too.
+ */
+template<typename Predicate>
+static bool evaluatePredicate( QgsGeometryPrivate *d, const Predicate &predicate )
+{
+  if ( d->preparedEngineMutex.tryLock() )
+  {
+    if ( d->preparedEngine )
+    {
+      const bool result = predicate( *d->preparedEngine );
+      d->preparedEngineMutex.unlock();
+      return result;
+    }
+    d->preparedEngineMutex.unlock();
+  }
+
+  QgsGeos geos( d->geometry.get() );
+  return predicate( geos );
+}
+
 QgsGeometry::QgsGeometry()
   : d( new QgsGeometryPrivate() )
 {
@@ -102,7 +376,11 @@ QgsGeometry &QgsGeometry::operator=( QgsGeometry const &other )
 void QgsGeometry::detach()
 {
   if ( d->ref <= 1 )
+  {
+    // the caller is about to modify the geometry, so the prepared engine becomes stale
+    d->clearPreparedEngine();
     return;
+  }
 
   std::unique_ptr< QgsAbstractGeometry > cGeom;
   if ( d->geometry )
@@ -118,6 +396,10 @@ void QgsGeometry::reset( std::unique_ptr<QgsAbstractGeometry> newGeometry )
     ( void )d->ref.deref();
     d = new QgsGeometryPrivate();
   }
+  else
+  {
+    d->clearPreparedEngine();
+  }
   d->geometry = std::move( newGeometry );
 }
 
@@ -317,20 +599,35 @@ QgsGeometry QgsGeometry::createWedgeBuffer( const QgsPoint &center, const double
 
 void QgsGeometry::fromWkb( unsigned char *wkb, int length )
 {
-  QgsConstWkbPtr ptr( wkb, length );
-  reset( QgsGeometryFactory::geomFromWkb( ptr ) );
+  fromWkb( QByteArray( reinterpret_cast< const char * >( wkb ), length ) );
   delete [] wkb;
 }
 
 void QgsGeometry::fromWkb( const QByteArray &wkb )
 {
+  // Keep the WKB as is, and only parse it when the geometry tree is needed.
+  // Only do that for native byte order WKB of linear types, whose bounding box
+  // can be computed by scanning the coordinates, so that asWkb() and boundingBox()
+  // return the same content as for a parsed geometry.
+  QgsRectangle envelope;
+  if ( wkb.size() >= 5 && wkb.at( 0 ) == QgsApplication::endian() && wkbEnvelope( wkb, envelope ) )
+  {
+    reset( nullptr );
+    d->geometry.setWkb( wkb, envelope );
+    return;
+  }
+
   QgsConstWkbPtr ptr( wkb );
   reset( QgsGeometryFactory::geomFromWkb( ptr ) );
 }
 
 QgsWkbTypes::Type QgsGeometry::wkbType() const
 {
-  if ( !d->geometry )
+  if ( const std::shared_ptr< const QgsLazyGeometry::Wkb > pending = d->geometry.pendingWkb() )
+  {
+    return pending->type;
+  }
+  else if ( !d->geometry )
   {
     return QgsWkbTypes::Unknown;
   }
@@ -347,7 +644,7 @@ QgsWkbTypes::GeometryType QgsGeometry::type() const
   {
     return QgsWkbTypes::UnknownGeometry;
   }
-  return static_cast< QgsWkbTypes::GeometryType >( QgsWkbTypes::geometryType( d->geometry->wkbType() ) );
+  return static_cast< QgsWkbTypes::GeometryType >( QgsWkbTypes::geometryType( wkbType() ) );
 }
 
 bool QgsGeometry::isEmpty() const
@@ -366,7 +663,7 @@ bool QgsGeometry::isMultipart() const
   {
     return false;
   }
-  return QgsWkbTypes::isMultiType( d->geometry->wkbType() );
+  return QgsWkbTypes::isMultiType( wkbType() );
 }
 
 QgsPointXY QgsGeometry::closestVertex( const QgsPointXY &point, int &atVertex, int &beforeVertex, int &afterVertex, double &sqrDist ) const
@@ -932,6 +1229,10 @@ QgsGeometry QgsGeometry::makeDifference( const QgsGeometry &other ) const
 
 QgsRectangle QgsGeometry::boundingBox() const
 {
+  if ( const std::shared_ptr< const QgsLazyGeometry::Wkb > pending = d->geometry.pendingWkb() )
+  {
+    return pending->envelope;
+  }
   if ( d->geometry )
   {
     return d->geometry->boundingBox();
@@ -1118,6 +1419,19 @@ bool QgsGeometry::intersects( const QgsRectangle &r ) const
   return intersects( g );
 }
 
+void QgsGeometry::prepare() const
+{
+  if ( !d->geometry )
+    return;
+
+  QMutexLocker locker( &d->preparedEngineMutex );
+  if ( d->preparedEngine )
+    return;
+
+  d->preparedEngine.reset( new QgsGeos( d->geometry.get() ) );
+  d->preparedEngine->prepareGeometry();
+}
+
 bool QgsGeometry::intersects( const QgsGeometry &geometry ) const
 {
   if ( !d->geometry || geometry.isNull() )
@@ -1125,9 +1439,12 @@ bool QgsGeometry::intersects( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.intersects( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.intersects( other, &mLastError );
+  } );
 }
 
 bool QgsGeometry::boundingBoxIntersects( const QgsRectangle &rectangle ) const
@@ -1158,9 +1475,11 @@ bool QgsGeometry::contains( const QgsPointXY *p ) const
   }
 
   QgsPoint pt( p->x(), p->y() );
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.contains( &pt, &mLastError );
+  return evaluatePredicate( d, [&pt, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.contains( &pt, &mLastError );
+  } );
 }
 
 bool QgsGeometry::contains( const QgsGeometry &geometry ) const
@@ -1170,9 +1489,12 @@ bool QgsGeometry::contains( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.contains( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.contains( other, &mLastError );
+  } );
 }
 
 bool QgsGeometry::disjoint( const QgsGeometry &geometry ) const
@@ -1182,9 +1504,12 @@ bool QgsGeometry::disjoint( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.disjoint( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.disjoint( other, &mLastError );
+  } );
 }
 
 bool QgsGeometry::equals( const QgsGeometry &geometry ) const
@@ -1209,9 +1534,12 @@ bool QgsGeometry::touches( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.touches( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.touches( other, &mLastError );
+  } );
 }
 
 bool QgsGeometry::overlaps( const QgsGeometry &geometry ) const
@@ -1221,9 +1549,12 @@ bool QgsGeometry::overlaps( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.overlaps( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.overlaps( other, &mLastError );
+  } );
 }
 
 bool QgsGeometry::within( const QgsGeometry &geometry ) const
@@ -1233,9 +1564,12 @@ bool QgsGeometry::within( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.within( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.within( other, &mLastError );
+  } );
 }
 
 bool QgsGeometry::crosses( const QgsGeometry &geometry ) const
@@ -1245,9 +1579,12 @@ bool QgsGeometry::crosses( const QgsGeometry &geometry ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.crosses( geometry.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = geometry.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.crosses( other, &mLastError );
+  } );
 }
 
 QString QgsGeometry::asWkt( int precision ) const
@@ -2292,6 +2629,8 @@ QgsGeometry QgsGeometry::extrude( double x, double y )
 
 QByteArray QgsGeometry::asWkb() const
 {
+  if ( const std::shared_ptr< const QgsLazyGeometry::Wkb > pending = d->geometry.pendingWkb() )
+    return pending->wkb;
   return d->geometry ? d->geometry->asWkb() : QByteArray();
 }
 
@@ -2497,9 +2836,12 @@ bool QgsGeometry::isGeosEqual( const QgsGeometry &g ) const
     return false;
   }
 
-  QgsGeos geos( d->geometry.get() );
   mLastError.clear();
-  return geos.isEqual( g.d->geometry.get(), &mLastError );
+  const QgsAbstractGeometry *other = g.d->geometry.get();
+  return evaluatePredicate( d, [other, this]( const QgsGeometryEngine & engine )
+  {
+    return engine.isEqual( other, &mLastError );
+  } );
 }
 
 QgsGeometry QgsGeometry::unaryUnion( const QVector<QgsGeometry> &geometries )
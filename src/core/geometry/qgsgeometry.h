@@ -278,6 +278,11 @@ class CORE_EXPORT QgsGeometry
 
     /**
      * Set the geometry, feeding in the buffer containing OGC Well-Known Binary
+     *
+     * Since QGIS 3.6, the WKB is only parsed the first time the geometry's vertices are
+     * accessed. Until then, asWkb(), wkbType() and boundingBox() are answered directly
+     * from the WKB.
+     *
      * \since QGIS 3.0
      */
     void fromWkb( const QByteArray &wkb );
@@ -945,6 +950,19 @@ class CORE_EXPORT QgsGeometry
      */
     bool intersects( const QgsRectangle &rectangle ) const;
 
+    /**
+     * Prepares the geometry, so that subsequent spatial predicate tests against it
+     * (such as intersects(), contains(), disjoint(), touches(), overlaps(), within() or crosses())
+     * are faster.
+     *
+     * Preparing a geometry is more expensive than a single predicate test, and the prepared
+     * geometry is kept in memory until the geometry is modified, so this should only be called
+     * for geometries which are tested against many other geometries.
+     *
+     * \since QGIS 3.6
+     */
+    void prepare() const;
+
     /**
      * Returns true if this geometry exactly intersects with another \a geometry. This test is exact
      * and can be slow for complex geometries.
@@ -1379,6 +1397,10 @@ class CORE_EXPORT QgsGeometry
 
     /**
      * Export the geometry to WKB
+     *
+     * If the geometry was created with fromWkb() and has not been modified since, the
+     * original WKB is returned without any copy.
+     *
      * \since QGIS 3.0
      */
     QByteArray asWkb() const;
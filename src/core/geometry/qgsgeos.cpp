@@ -30,6 +30,11 @@ email                : marco.hugentobler at sourcepole dot com
 
 #define DEFAULT_QUADRANT_SEGMENTS 8
 
+// GEOS >= 3.10 copies whole coordinate sequences from and to arrays
+#if GEOS_VERSION_MAJOR>3 || ( GEOS_VERSION_MAJOR==3 && GEOS_VERSION_MINOR>=10 )
+#define HAVE_GEOS_COORDSEQ_ARRAYS
+#endif
+
 #define CATCH_GEOS(r) \
   catch (GEOSException &) \
   { \
@@ -1219,6 +1224,10 @@ std::unique_ptr<QgsLineString> QgsGeos::sequenceToLinestring( const GEOSGeometry
   double *y = yOut.data();
   double *z = zOut.data();
   double *m = mOut.data();
+#ifdef HAVE_GEOS_COORDSEQ_ARRAYS
+  // copy the whole sequence in one go
+  GEOSCoordSeq_copyToArrays_r( geosinit.ctxt, cs, x, y, hasZ ? z : nullptr, hasM ? m : nullptr );
+#else
   for ( unsigned int i = 0; i < nPoints; ++i )
   {
     GEOSCoordSeq_getX_r( geosinit.ctxt, cs, i, x++ );
@@ -1232,6 +1241,7 @@ std::unique_ptr<QgsLineString> QgsGeos::sequenceToLinestring( const GEOSGeometry
       GEOSCoordSeq_getOrdinate_r( geosinit.ctxt, cs, i, 3, m++ );
     }
   }
+#endif
   std::unique_ptr< QgsLineString > line( new QgsLineString( xOut, yOut, zOut, mOut ) );
   return line;
 }
@@ -1759,6 +1769,40 @@ GEOSCoordSequence *QgsGeos::createCoordinateSequence( const QgsCurve *curve, dou
   GEOSCoordSequence *coordSeq = nullptr;
   try
   {
+#ifdef HAVE_GEOS_COORDSEQ_ARRAYS
+    if ( precision <= 0. && numOutPoints == numPoints )
+    {
+      // copy the coordinate arrays of the line in one go
+      coordSeq = GEOSCoordSeq_copyFromArrays_r( geosinit.ctxt, line->xData(), line->yData(), hasZ ? line->zData() : nullptr,
+                 hasM ? line->mData() : nullptr, numPoints );
+    }
+    else
+    {
+      // round and close the line in temporary arrays, which are then copied in one go
+      QVector< double > x( numOutPoints );
+      QVector< double > y( numOutPoints );
+      QVector< double > z( hasZ ? numOutPoints : 0 );
+      QVector< double > m( hasM ? numOutPoints : 0 );
+      for ( int i = 0; i < numOutPoints; ++i )
+      {
+        // start reading back from start of line for the closing point
+        int index = i < numPoints ? i : 0;
+        x[i] = precision > 0. ? std::round( line->xAt( index ) / precision ) * precision : line->xAt( index );
+        y[i] = precision > 0. ? std::round( line->yAt( index ) / precision ) * precision : line->yAt( index );
+        if ( hasZ )
+          z[i] = precision > 0. ? std::round( line->zAt( index ) / precision ) * precision : line->zAt( index );
+        if ( hasM )
+          m[i] = line->mAt( index );
+      }
+      coordSeq = GEOSCoordSeq_copyFromArrays_r( geosinit.ctxt, x.constData(), y.constData(), hasZ ? z.constData() : nullptr,
+                 hasM ? m.constData() : nullptr, numOutPoints );
+    }
+    if ( !coordSeq )
+    {
+      QgsDebugMsg( QStringLiteral( "GEOS Exception: Could not create coordinate sequence for %1 points in %2 dimensions" ).arg( numPoints ).arg( coordDims ) );
+      return nullptr;
+    }
+#else
     coordSeq = GEOSCoordSeq_create_r( geosinit.ctxt, numOutPoints, coordDims );
     if ( !coordSeq )
     {
@@ -1819,6 +1863,7 @@ GEOSCoordSequence *QgsGeos::createCoordinateSequence( const QgsCurve *curve, dou
         }
       }
     }
+#endif
   }
   CATCH_GEOS( nullptr )
 
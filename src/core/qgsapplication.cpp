@@ -117,6 +117,7 @@ QString ABISYM( QgsApplication::mCfgIntDir );
 QString ABISYM( QgsApplication::mBuildOutputPath );
 QStringList ABISYM( QgsApplication::mGdalSkipList );
 int ABISYM( QgsApplication::mMaxThreads );
+int QgsApplication::sMaxConcurrentConnectionsPerPool = CONN_POOL_MAX_CONCURRENT_CONNS;
 QString ABISYM( QgsApplication::mAuthDbDirPath );
 
 QString QgsApplication::sUserName;
@@ -1559,9 +1560,14 @@ void QgsApplication::setCustomVariable( const QString &name, const QVariant &val
   emit instance()->customVariablesChanged();
 }
 
-int QgsApplication::maxConcurrentConnectionsPerPool() const
+int QgsApplication::maxConcurrentConnectionsPerPool()
 {
-  return CONN_POOL_MAX_CONCURRENT_CONNS;
+  return sMaxConcurrentConnectionsPerPool;
+}
+
+void QgsApplication::setMaxConcurrentConnectionsPerPool( int connections )
+{
+  sMaxConcurrentConnectionsPerPool = connections < 1 ? CONN_POOL_MAX_CONCURRENT_CONNS : connections;
 }
 
 void QgsApplication::collectTranslatableObjects( QgsTranslationContext *translationContext )
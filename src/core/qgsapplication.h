@@ -756,10 +756,27 @@ class CORE_EXPORT QgsApplication : public QApplication
      *
      * \note QGIS may in some situations allocate more than this amount
      *       of connections to avoid deadlocks.
+     * \note Prior to QGIS 3.6 this was a non-static member function.
      *
-     * \since QGIS 3.4
+     * \see setMaxConcurrentConnectionsPerPool()
+     * \since QGIS 3.6
+     */
+    static int maxConcurrentConnectionsPerPool();
+
+    /**
+     * Sets the maximum number of concurrent connections per connections pool.
+     *
+     * Raising this value allows more feature iterators to read concurrently
+     * from the same data source, each one on its own connection (e.g. a dedicated
+     * GDAL dataset handle for the OGR provider). A value smaller than 1 restores
+     * the default.
+     *
+     * \note Only pools created after the call are affected.
+     *
+     * \see maxConcurrentConnectionsPerPool()
+     * \since QGIS 3.6
      */
-    int maxConcurrentConnectionsPerPool() const;
+    static void setMaxConcurrentConnectionsPerPool( int connections );
 
     /**
      * Set translation
@@ -852,6 +869,8 @@ class CORE_EXPORT QgsApplication : public QApplication
      * \since QGIS 2.12 */
     static QString ABISYM( mAuthDbDirPath );
 
+    static int sMaxConcurrentConnectionsPerPool;
+
     static QString sUserName;
     static QString sUserFullName;
     static QString sPlatformName;
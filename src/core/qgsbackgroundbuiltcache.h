@@ -0,0 +1,205 @@
+/***************************************************************************
+                         qgsbackgroundbuiltcache.h
+                         -------------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSBACKGROUNDBUILTCACHE_H
+#define QGSBACKGROUNDBUILTCACHE_H
+
+#define SIP_NO_FILE
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QMutex>
+#include <QtConcurrentRun>
+#include <functional>
+#include <memory>
+
+/**
+ * \ingroup core
+ * \class QgsBackgroundBuiltCache
+ * \brief Holds a value of type T which is built in a background thread the first time it is
+ * requested, such as an in-memory index of the features of a layer.
+ *
+ * Built values are immutable, and are shared with the callers. The value is dropped by
+ * invalidate(), e.g. after a change of the layer data, and rebuilt on the next request. A build
+ * which is running when the value is invalidated or the cache is deleted is abandoned: it
+ * should check Build::isCanceled() regularly, and its result is discarded.
+ *
+ * A value may also be unavailable, e.g. for a layer which is too large to be indexed. No build
+ * is started for an unavailable value until it is invalidated.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+template< class T >
+class QgsBackgroundBuiltCache
+{
+  private:
+
+    struct State;
+
+  public:
+
+    /**
+     * A build of the value, given to the function building it.
+     */
+    class Build
+    {
+      public:
+
+        /**
+         * Returns true if the value was invalidated or the cache deleted since the build
+         * started, in which case the build result is discarded.
+         */
+        bool isCanceled() const { return mState->generation.load() != mGeneration; }
+
+      private:
+
+        Build( const std::shared_ptr< State > &state, int generation )
+          : mState( state )
+          , mGeneration( generation )
+        {}
+
+        std::shared_ptr< State > mState;
+        int mGeneration = 0;
+
+        friend class QgsBackgroundBuiltCache;
+    };
+
+    /**
+     * Function building the value in a background thread. Returns nullptr if the value is
+     * unavailable, or if the build is canceled.
+     */
+    typedef std::function< std::shared_ptr< T >( const Build & ) > BuildFunction;
+
+    //! Constructor for QgsBackgroundBuiltCache
+    QgsBackgroundBuiltCache()
+      : mState( std::make_shared< State >() )
+    {}
+
+    ~QgsBackgroundBuiltCache()
+    {
+      // a running build stops at its next check, and keeps the state alive until then
+      mState->generation.ref();
+    }
+
+    //! QgsBackgroundBuiltCache cannot be copied
+    QgsBackgroundBuiltCache( const QgsBackgroundBuiltCache &rh ) = delete;
+    //! QgsBackgroundBuiltCache cannot be copied
+    QgsBackgroundBuiltCache &operator=( const QgsBackgroundBuiltCache &rh ) = delete;
+
+    /**
+     * Returns the built value, or nullptr if it is not built yet or unavailable. If the value
+     * is not built yet and no build is running, \a prepare is called on the calling thread to
+     * capture the state needed by the build, and the BuildFunction it returns is run in a
+     * background thread. If \a prepare returns an empty function, the value is unavailable.
+     */
+    std::shared_ptr< const T > value( const std::function< BuildFunction() > &prepare )
+    {
+      int generation = 0;
+      {
+        QMutexLocker locker( &mState->mutex );
+        if ( mState->value || mState->building || mState->unavailable )
+          return mState->value;
+
+        mState->building = true;
+        generation = mState->generation.load();
+      }
+
+      const BuildFunction build = prepare();
+      if ( !build )
+      {
+        QMutexLocker locker( &mState->mutex );
+        if ( mState->generation.load() == generation )
+        {
+          mState->unavailable = true;
+          mState->building = false;
+        }
+        return nullptr;
+      }
+
+      std::shared_ptr< State > state = mState;
+      mBuild = QtConcurrent::run( [state, generation, build]
+      {
+        const std::shared_ptr< T > value = build( Build( state, generation ) );
+
+        QMutexLocker locker( &state->mutex );
+        if ( state->generation.load() != generation )
+          return;
+
+        state->value = value;
+        state->unavailable = !value;
+        state->building = false;
+      } );
+      return nullptr;
+    }
+
+    /**
+     * Returns true if the value is being built in the background.
+     */
+    bool isBuilding() const
+    {
+      QMutexLocker locker( &mState->mutex );
+      return mState->building;
+    }
+
+    /**
+     * Returns true if the value is unavailable. This is checked again after the value is invalidated.
+     */
+    bool isUnavailable() const
+    {
+      QMutexLocker locker( &mState->mutex );
+      return mState->unavailable;
+    }
+
+    /**
+     * Blocks until the background build of the value, if any, is finished.
+     */
+    void waitForFinished()
+    {
+      mBuild.waitForFinished();
+    }
+
+    /**
+     * Drops the value, which is then rebuilt on the next request. Any running build
+     * is abandoned.
+     */
+    void invalidate()
+    {
+      QMutexLocker locker( &mState->mutex );
+      mState->generation.ref();
+      mState->building = false;
+      mState->unavailable = false;
+      mState->value.reset();
+    }
+
+  private:
+
+    //! Shared between the cache and its background builds, which may outlive the cache
+    struct State
+    {
+      QMutex mutex;
+      std::shared_ptr< const T > value;
+      bool building = false;
+      bool unavailable = false;
+      //! Incremented when the value is invalidated, so that builds of an older generation are dropped
+      QAtomicInt generation;
+    };
+
+    std::shared_ptr< State > mState;
+    QFuture< void > mBuild;
+};
+
+#endif // QGSBACKGROUNDBUILTCACHE_H
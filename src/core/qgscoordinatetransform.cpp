@@ -621,6 +621,10 @@ void QgsCoordinateTransform::transformCoords( int numPoints, double *x, double *
     QgsDebugMsgLevel( QStringLiteral( "No QgsCoordinateTransformContext context set for transform" ), 4 );
 #endif
 
+  // common pairs of CRS are transformed analytically, without proj
+  if ( d->fastPathTransform( numPoints, x, y, direction == ReverseTransform ) )
+    return;
+
   // use proj4 to do the transform
 
   // if the source/destination projection is lat/long, convert the points to radians
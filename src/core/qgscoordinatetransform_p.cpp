@@ -30,6 +30,7 @@ extern "C"
 #include <sqlite3.h>
 
 #include <QStringList>
+#include <cmath>
 
 /// @cond PRIVATE
 
@@ -213,9 +214,71 @@ bool QgsCoordinateTransformPrivate::initialize()
     mShortCircuit = false;
     QgsDebugMsgLevel( QStringLiteral( "Source/Dest CRS not equal, shortcircuit is not set." ), 3 );
   }
+
+  mFastPath = mIsValid && !mShortCircuit && useDefaultDatumTransform ? fastPath() : NoFastPath;
   return mIsValid;
 }
 
+QgsCoordinateTransformPrivate::FastPath QgsCoordinateTransformPrivate::fastPath() const
+{
+  // the proj strings are checked too, in case the CRS definitions were customized
+  static const QString GEOGRAPHIC_PROJ = QStringLiteral( "+proj=longlat +datum=WGS84 +no_defs" );
+  static const QString WEB_MERCATOR_PROJ = QStringLiteral( "+proj=merc +a=6378137 +b=6378137 +lat_ts=0.0 +lon_0=0.0 +x_0=0.0 +y_0=0 +k=1.0 +units=m +nadgrids=@null +wktext +no_defs" );
+
+  const QString sourceProj = mSourceProjString.simplified();
+  const QString destProj = mDestProjString.simplified();
+  if ( mSourceCRS.authid() == QLatin1String( "EPSG:4326" ) && sourceProj == GEOGRAPHIC_PROJ
+       && mDestCRS.authid() == QLatin1String( "EPSG:3857" ) && destProj == WEB_MERCATOR_PROJ )
+    return GeographicToWebMercator;
+  if ( mSourceCRS.authid() == QLatin1String( "EPSG:3857" ) && sourceProj == WEB_MERCATOR_PROJ
+       && mDestCRS.authid() == QLatin1String( "EPSG:4326" ) && destProj == GEOGRAPHIC_PROJ )
+    return WebMercatorToGeographic;
+  return NoFastPath;
+}
+
+bool QgsCoordinateTransformPrivate::fastPathTransform( int numPoints, double *x, double *y, bool reverse ) const
+{
+  if ( mFastPath == NoFastPath )
+    return false;
+
+  // radius of the sphere of EPSG:3857
+  static const double RADIUS = 6378137.0;
+  // outside of these limits proj wraps the longitudes or fails, leave these points to proj
+  static const double MAXIMUM_LATITUDE = 90.0 - 1e-8;
+  static const double MAXIMUM_MERCATOR_X = M_PI * RADIUS;
+
+  // same formulas as the spherical Mercator projection of proj. The checks are done
+  // in a separate pass, so that the transform loops are free of branches
+  if ( ( mFastPath == GeographicToWebMercator ) != reverse )
+  {
+    for ( int i = 0; i < numPoints; ++i )
+    {
+      // written so that NaN fails
+      if ( !( std::fabs( x[i] ) <= 180.0 && std::fabs( y[i] ) < MAXIMUM_LATITUDE ) )
+        return false;
+    }
+    for ( int i = 0; i < numPoints; ++i )
+    {
+      x[i] = RADIUS * ( x[i] * DEG_TO_RAD );
+      y[i] = RADIUS * std::log( std::tan( M_PI_4 + 0.5 * ( y[i] * DEG_TO_RAD ) ) );
+    }
+  }
+  else
+  {
+    for ( int i = 0; i < numPoints; ++i )
+    {
+      if ( !( std::fabs( x[i] ) <= MAXIMUM_MERCATOR_X && std::isfinite( y[i] ) ) )
+        return false;
+    }
+    for ( int i = 0; i < numPoints; ++i )
+    {
+      x[i] = ( x[i] / RADIUS ) * RAD_TO_DEG;
+      y[i] = std::atan( std::sinh( y[i] / RADIUS ) ) * RAD_TO_DEG;
+    }
+  }
+  return true;
+}
+
 void QgsCoordinateTransformPrivate::calculateTransforms( const QgsCoordinateTransformContext &context )
 {
   // recalculate datum transforms from context
@@ -91,6 +91,14 @@ class QgsCoordinateTransformPrivate : public QSharedData
 
     QPair< projPJ, projPJ > threadLocalProjData();
 
+    /**
+     * Transforms the coordinates with the analytic transform selected for the pair of CRS,
+     * in the reverse direction if \a reverse is true. Returns false, leaving the coordinates
+     * unchanged, if there is no such transform or if a coordinate lies outside the domain
+     * where it gives the same results as proj.
+     */
+    bool fastPathTransform( int numPoints, double *x, double *y, bool reverse ) const;
+
     /**
      * Flag to indicate whether the transform is valid (ie has a valid
      * source and destination crs)
@@ -115,6 +123,17 @@ class QgsCoordinateTransformPrivate : public QSharedData
     int mSourceDatumTransform = -1;
     int mDestinationDatumTransform = -1;
 
+    //! Analytic transforms used instead of proj for common pairs of CRS
+    enum FastPath
+    {
+      NoFastPath, //!< Coordinates are transformed by proj
+      GeographicToWebMercator, //!< From WGS 84 (EPSG:4326) to Pseudo Mercator (EPSG:3857)
+      WebMercatorToGeographic, //!< From Pseudo Mercator (EPSG:3857) to WGS 84 (EPSG:4326)
+    };
+
+    //! Analytic transform for the pair of CRS, selected on initialization
+    FastPath mFastPath = NoFastPath;
+
     /**
      * Thread local proj context storage. A new proj context will be created
      * for every thread.
@@ -138,6 +157,9 @@ class QgsCoordinateTransformPrivate : public QSharedData
 
     void setFinder();
 
+    //! Returns the analytic transform matching the CRS and proj strings, if any
+    FastPath fastPath() const;
+
     void freeProj();
 };
 
@@ -0,0 +1,274 @@
+/***************************************************************************
+                         qgsfeaturebatch.cpp
+                         -------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsfeaturebatch.h"
+#include "qgsgeometryfactory.h"
+#include "qgswkbptr.h"
+
+//
+// QgsFeatureBatch::Column
+//
+
+QgsFeatureBatch::Column::Column( QVariant::Type type )
+  : mType( type )
+{
+  switch ( type )
+  {
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      mStorage = Integer;
+      break;
+
+    case QVariant::Double:
+      mStorage = Double;
+      break;
+
+    case QVariant::String:
+      mStorage = String;
+      break;
+
+    default:
+      mStorage = Variant;
+      break;
+  }
+}
+
+QVariant QgsFeatureBatch::Column::value( int row ) const
+{
+  if ( mNull.at( row ) )
+    return QVariant( mType );
+
+  switch ( mStorage )
+  {
+    case Integer:
+    {
+      QVariant v( mIntegers.at( row ) );
+      if ( mType != QVariant::LongLong )
+        v.convert( mType );
+      return v;
+    }
+    case Double:
+      return QVariant( mDoubles.at( row ) );
+    case String:
+      return QVariant( mStrings.at( row ) );
+    case Variant:
+      return mVariants.at( row );
+  }
+  return QVariant();
+}
+
+void QgsFeatureBatch::Column::appendNull()
+{
+  mNull.append( true );
+  switch ( mStorage )
+  {
+    case Integer:
+      mIntegers.append( 0 );
+      break;
+    case Double:
+      mDoubles.append( 0 );
+      break;
+    case String:
+      mStrings.append( QString() );
+      break;
+    case Variant:
+      mVariants.append( QVariant( mType ) );
+      break;
+  }
+}
+
+void QgsFeatureBatch::Column::appendInteger( qlonglong value )
+{
+  Q_ASSERT( mStorage == Integer );
+  mNull.append( false );
+  mIntegers.append( value );
+}
+
+void QgsFeatureBatch::Column::appendDouble( double value )
+{
+  Q_ASSERT( mStorage == Double );
+  mNull.append( false );
+  mDoubles.append( value );
+}
+
+void QgsFeatureBatch::Column::appendString( const QString &value )
+{
+  Q_ASSERT( mStorage == String );
+  mNull.append( false );
+  mStrings.append( value );
+}
+
+void QgsFeatureBatch::Column::appendVariant( const QVariant &value )
+{
+  if ( value.isNull() )
+  {
+    appendNull();
+    return;
+  }
+
+  switch ( mStorage )
+  {
+    case Integer:
+    {
+      bool ok = false;
+      const qlonglong v = value.toLongLong( &ok );
+      if ( ok )
+        appendInteger( v );
+      else
+        appendNull();
+      break;
+    }
+    case Double:
+    {
+      bool ok = false;
+      const double v = value.toDouble( &ok );
+      if ( ok )
+        appendDouble( v );
+      else
+        appendNull();
+      break;
+    }
+    case String:
+      appendString( value.toString() );
+      break;
+    case Variant:
+      mNull.append( false );
+      mVariants.append( value );
+      break;
+  }
+}
+
+void QgsFeatureBatch::Column::clear()
+{
+  mNull.resize( 0 );
+  mIntegers.resize( 0 );
+  mDoubles.resize( 0 );
+  mStrings.resize( 0 );
+  mVariants.resize( 0 );
+}
+
+void QgsFeatureBatch::Column::reserve( int size )
+{
+  mNull.reserve( size );
+  switch ( mStorage )
+  {
+    case Integer:
+      mIntegers.reserve( size );
+      break;
+    case Double:
+      mDoubles.reserve( size );
+      break;
+    case String:
+      mStrings.reserve( size );
+      break;
+    case Variant:
+      mVariants.reserve( size );
+      break;
+  }
+}
+
+//
+// QgsFeatureBatch
+//
+
+QgsFeatureBatch::QgsFeatureBatch( const QgsFields &fields )
+{
+  setFields( fields );
+}
+
+void QgsFeatureBatch::setFields( const QgsFields &fields )
+{
+  mFields = fields;
+  mColumns.clear();
+  mColumns.reserve( fields.count() );
+  for ( int i = 0; i < fields.count(); ++i )
+    mColumns.append( Column( fields.at( i ).type() ) );
+  clear();
+}
+
+void QgsFeatureBatch::clear()
+{
+  mIds.resize( 0 );
+  for ( Column &column : mColumns )
+    column.clear();
+  mWkb.truncate( 0 );
+  mWkbOffsets.resize( 1 );
+  mWkbOffsets[0] = 0;
+}
+
+void QgsFeatureBatch::reserve( int size )
+{
+  mIds.reserve( size );
+  mWkbOffsets.reserve( size + 1 );
+  for ( Column &column : mColumns )
+    column.reserve( size );
+}
+
+QgsGeometry QgsFeatureBatch::geometry( int row ) const
+{
+  const int begin = mWkbOffsets.at( row );
+  const int size = mWkbOffsets.at( row + 1 ) - begin;
+  if ( size <= 0 )
+    return QgsGeometry();
+
+  QgsConstWkbPtr wkbPtr( reinterpret_cast< const unsigned char * >( mWkb.constData() ) + begin, size );
+  return QgsGeometry( QgsGeometryFactory::geomFromWkb( wkbPtr ) );
+}
+
+QgsFeature QgsFeatureBatch::feature( int row ) const
+{
+  QgsFeature f( mFields, mIds.at( row ) );
+  QgsAttributes attributes( mColumns.size() );
+  for ( int i = 0; i < mColumns.size(); ++i )
+    attributes[i] = mColumns.at( i ).value( row );
+  f.setAttributes( attributes );
+  f.setGeometry( geometry( row ) );
+  f.setValid( true );
+  return f;
+}
+
+void QgsFeatureBatch::appendFeature( const QgsFeature &feature )
+{
+  beginFeature( feature.id() );
+  const QgsAttributes attributes = feature.attributes();
+  for ( int i = 0; i < mColumns.size(); ++i )
+    mColumns[i].appendVariant( attributes.value( i ) );
+
+  if ( feature.hasGeometry() )
+  {
+    const QByteArray wkb = feature.geometry().asWkb();
+    if ( !wkb.isEmpty() )
+      memcpy( allocateWkb( wkb.size() ), wkb.constData(), wkb.size() );
+  }
+}
+
+void QgsFeatureBatch::beginFeature( QgsFeatureId id )
+{
+  mIds.append( id );
+  mWkbOffsets.append( mWkb.size() );
+}
+
+unsigned char *QgsFeatureBatch::allocateWkb( int size )
+{
+  Q_ASSERT( !mIds.isEmpty() );
+  const int offset = mWkb.size();
+  mWkb.resize( offset + size );
+  mWkbOffsets.last() = mWkb.size();
+  return reinterpret_cast< unsigned char * >( mWkb.data() ) + offset;
+}
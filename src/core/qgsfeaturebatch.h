@@ -0,0 +1,229 @@
+/***************************************************************************
+                         qgsfeaturebatch.h
+                         -----------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSFEATUREBATCH_H
+#define QGSFEATUREBATCH_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgsfields.h"
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * \ingroup core
+ * \class QgsFeatureBatch
+ * \brief A block of features stored column by column.
+ *
+ * Attribute values are stored in typed arrays (one per field of the batch fields), and
+ * geometries are stored as consecutive WKB blobs in a single buffer, indexed by an
+ * offset table. Batches are filled by QgsFeatureIterator::nextBatch(), which lets data
+ * providers write values straight into the arrays without building intermediate
+ * QgsFeature and QgsGeometry objects.
+ *
+ * A batch can be reused for successive calls to QgsFeatureIterator::nextBatch(): the
+ * allocated storage is kept between calls.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+class CORE_EXPORT QgsFeatureBatch
+{
+  public:
+
+    /**
+     * Storage of the values of one attribute column.
+     */
+    class CORE_EXPORT Column
+    {
+      public:
+
+        //! Physical storage used by a column
+        enum Storage
+        {
+          Integer, //!< Values stored as qlonglong (integer and boolean fields)
+          Double, //!< Values stored as double
+          String, //!< Values stored as QString
+          Variant, //!< Values stored as QVariant (any other field type)
+        };
+
+        /**
+         * Constructor for a column holding values of a field of the specified \a type.
+         */
+        explicit Column( QVariant::Type type = QVariant::Invalid );
+
+        //! Returns the field type of the column
+        QVariant::Type type() const { return mType; }
+
+        //! Returns the physical storage of the column
+        Storage storage() const { return mStorage; }
+
+        //! Returns the number of values in the column
+        int size() const { return mNull.size(); }
+
+        //! Returns true if the value at \a row is NULL
+        bool isNull( int row ) const { return mNull.at( row ); }
+
+        /**
+         * Returns the integer values. Only filled for Integer storage.
+         * Values for NULL rows are undefined.
+         */
+        const QVector<qlonglong> &integers() const { return mIntegers; }
+
+        /**
+         * Returns the double values. Only filled for Double storage.
+         * Values for NULL rows are undefined.
+         */
+        const QVector<double> &doubles() const { return mDoubles; }
+
+        /**
+         * Returns the string values. Only filled for String storage.
+         */
+        const QVector<QString> &strings() const { return mStrings; }
+
+        //! Returns the value at \a row, converted to the field type
+        QVariant value( int row ) const;
+
+        //! Appends a NULL value
+        void appendNull();
+
+        //! Appends an integer value. Only valid for Integer storage.
+        void appendInteger( qlonglong value );
+
+        //! Appends a double value. Only valid for Double storage.
+        void appendDouble( double value );
+
+        //! Appends a string value. Only valid for String storage.
+        void appendString( const QString &value );
+
+        //! Appends a value of any type, converting it to the column storage
+        void appendVariant( const QVariant &value );
+
+        //! Removes all values, keeping the allocated storage
+        void clear();
+
+        //! Reserves storage for \a size values
+        void reserve( int size );
+
+      private:
+
+        QVariant::Type mType = QVariant::Invalid;
+        Storage mStorage = Variant;
+        QVector<bool> mNull;
+        QVector<qlonglong> mIntegers;
+        QVector<double> mDoubles;
+        QVector<QString> mStrings;
+        QVector<QVariant> mVariants;
+    };
+
+    QgsFeatureBatch() = default;
+
+    /**
+     * Constructor for a batch storing attributes of the specified \a fields.
+     */
+    explicit QgsFeatureBatch( const QgsFields &fields );
+
+    /**
+     * Sets the \a fields of the batch. One column is created for each field.
+     * Any stored feature is removed.
+     */
+    void setFields( const QgsFields &fields );
+
+    //! Returns the fields of the batch
+    QgsFields fields() const { return mFields; }
+
+    //! Returns the number of features in the batch
+    int size() const { return mIds.size(); }
+
+    //! Returns true if the batch does not contain any feature
+    bool isEmpty() const { return mIds.isEmpty(); }
+
+    //! Removes all features from the batch, keeping the allocated storage
+    void clear();
+
+    //! Reserves storage for \a size features
+    void reserve( int size );
+
+    //! Returns the feature ids
+    const QVector<QgsFeatureId> &ids() const { return mIds; }
+
+    //! Returns the number of attribute columns, i.e. the number of fields
+    int columnCount() const { return mColumns.size(); }
+
+    //! Returns the attribute column for the field at \a index
+    const Column &column( int index ) const { return mColumns.at( index ); }
+
+    /**
+     * Returns the attribute column for the field at \a index, for filling by
+     * feature iterators.
+     */
+    Column &column( int index ) { return mColumns[index]; }
+
+    /**
+     * Returns the buffer with the WKB of all geometries of the batch.
+     * \see wkbOffsets()
+     */
+    const QByteArray &wkbBuffer() const { return mWkb; }
+
+    /**
+     * Returns the offsets of the geometries in wkbBuffer(). The WKB of the feature
+     * at row \a i spans from offset i to offset i + 1, so this vector has size() + 1
+     * elements. Features without geometry have an empty WKB.
+     */
+    const QVector<int> &wkbOffsets() const { return mWkbOffsets; }
+
+    //! Returns true if the feature at \a row has a geometry
+    bool hasGeometry( int row ) const { return mWkbOffsets.at( row + 1 ) > mWkbOffsets.at( row ); }
+
+    //! Returns the geometry of the feature at \a row, parsed from its WKB
+    QgsGeometry geometry( int row ) const;
+
+    //! Returns the feature at \a row
+    QgsFeature feature( int row ) const;
+
+    /**
+     * Appends a feature to the batch. Attributes of \a feature are matched
+     * to the batch fields by index.
+     */
+    void appendFeature( const QgsFeature &feature );
+
+    /**
+     * Starts a new feature with the specified \a id, for filling by feature iterators.
+     * One value must then be appended to each column, and the geometry set with either
+     * allocateWkb() or nothing (no geometry).
+     */
+    void beginFeature( QgsFeatureId id );
+
+    /**
+     * Allocates \a size bytes in the WKB buffer for the geometry of the last feature
+     * started with beginFeature(), and returns a pointer to them. The pointer is only
+     * valid until the next modification of the batch.
+     */
+    unsigned char *allocateWkb( int size );
+
+  private:
+
+    QgsFields mFields;
+    QVector<QgsFeatureId> mIds;
+    QVector<Column> mColumns;
+    QByteArray mWkb;
+    QVector<int> mWkbOffsets = QVector<int>() << 0;
+};
+
+#endif // QGSFEATUREBATCH_H
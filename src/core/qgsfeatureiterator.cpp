@@ -18,6 +18,7 @@
 #include "qgssimplifymethod.h"
 #include "qgsexception.h"
 #include "qgsexpressionsorter.h"
+#include "qgsfeaturebatch.h"
 
 QgsAbstractFeatureIterator::QgsAbstractFeatureIterator( const QgsFeatureRequest &request )
   : mRequest( request )
@@ -71,6 +72,18 @@ bool QgsAbstractFeatureIterator::nextFeature( QgsFeature &f )
   return dataOk;
 }
 
+bool QgsAbstractFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxSize )
+{
+  batch.clear();
+  batch.reserve( maxSize );
+  QgsFeature f;
+  while ( batch.size() < maxSize && nextFeature( f ) )
+  {
+    batch.appendFeature( f );
+  }
+  return !batch.isEmpty();
+}
+
 bool QgsAbstractFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   while ( fetchFeature( f ) )
@@ -20,6 +20,7 @@
 #include "qgsindexedfeature.h"
 
 class QgsFeedback;
+class QgsFeatureBatch;
 
 /**
  * \ingroup core
@@ -46,6 +47,19 @@ class CORE_EXPORT QgsAbstractFeatureIterator
     //! fetch next feature, return true on success
     virtual bool nextFeature( QgsFeature &f );
 
+    /**
+     * Fetches up to \a maxSize next features into \a batch, stored column by column.
+     * The batch is cleared first, and its fields must have been set by the caller.
+     * Returns false when no more features are available.
+     *
+     * The default implementation appends features returned by nextFeature(). Iterators
+     * can reimplement it to fill the batch directly from their data source.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.6
+     */
+    virtual bool nextBatch( QgsFeatureBatch &batch, int maxSize ) SIP_SKIP;
+
     //! reset the iterator to the starting position
     virtual bool rewind() = 0;
     //! end of iterating: free the resources / lock
@@ -298,6 +312,21 @@ class CORE_EXPORT QgsFeatureIterator
     QgsFeatureIterator &operator=( const QgsFeatureIterator &other );
 
     bool nextFeature( QgsFeature &f );
+
+    /**
+     * Fetches up to \a maxSize next features into \a batch, stored column by column.
+     * The batch is cleared first, and its fields must have been set by the caller
+     * (usually to the fields of the layer or source the iterator comes from).
+     * Returns false when no more features are available.
+     *
+     * Batches let consumers which process many features avoid the per-feature
+     * overhead of nextFeature(), when the data provider supports it.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.6
+     */
+    bool nextBatch( QgsFeatureBatch &batch, int maxSize ) SIP_SKIP;
+
     bool rewind();
     bool close();
 
@@ -375,6 +404,11 @@ inline bool QgsFeatureIterator::nextFeature( QgsFeature &f )
   return mIter ? mIter->nextFeature( f ) : false;
 }
 
+inline bool QgsFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxSize )
+{
+  return mIter ? mIter->nextBatch( batch, maxSize ) : false;
+}
+
 inline bool QgsFeatureIterator::rewind()
 {
   if ( mIter )
@@ -0,0 +1,243 @@
+/***************************************************************************
+                         qgsfeaturetextindex.cpp
+                         -----------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsfeaturetextindex.h"
+#include "qgsexpression.h"
+#include "qgsfeatureiterator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+
+//! Returns the key of the trigram starting at \a c
+static quint64 trigramKey( const QChar *c )
+{
+  return ( static_cast< quint64 >( c[0].unicode() ) << 32 ) | ( static_cast< quint64 >( c[1].unicode() ) << 16 ) | c[2].unicode();
+}
+
+QVector< QgsFeatureTextIndex::Entry > QgsFeatureTextIndex::Index::search( const QStringList &parts, bool displayExpression, int limit ) const
+{
+  QVector< Entry > results;
+
+  QStringList foldedParts;
+  for ( const QString &part : parts )
+  {
+    if ( !part.isEmpty() )
+      foldedParts << part.toCaseFolded();
+  }
+  if ( foldedParts.isEmpty() || limit <= 0 )
+    return results;
+
+  // candidates are the entries containing the rarest trigram of the parts, or all
+  // entries if all parts are shorter than a trigram
+  const QVector< int > *candidates = nullptr;
+  for ( const QString &part : qgis::as_const( foldedParts ) )
+  {
+    for ( int i = 0; i + 2 < part.length(); ++i )
+    {
+      auto it = mPostings.constFind( trigramKey( part.constData() + i ) );
+      if ( it == mPostings.constEnd() )
+        return results;
+
+      if ( !candidates || it.value().size() < candidates->size() )
+        candidates = &it.value();
+    }
+  }
+
+  const int candidateCount = candidates ? candidates->size() : mEntries.size();
+  bool hasLastId = false;
+  QgsFeatureId lastId = FID_NULL;
+  for ( int i = 0; i < candidateCount; ++i )
+  {
+    const int position = candidates ? candidates->at( i ) : i;
+    const Entry &entry = mEntries.at( position );
+    if ( displayExpression != ( entry.field == DISPLAY_EXPRESSION ) )
+      continue;
+
+    // only the first matching field of a feature is returned
+    if ( !displayExpression && hasLastId && entry.id == lastId )
+      continue;
+
+    // case insensitive matching compares case folded characters, like the trigrams
+    int from = 0;
+    bool matches = true;
+    for ( const QString &part : qgis::as_const( foldedParts ) )
+    {
+      const int index = entry.text.indexOf( part, from, Qt::CaseInsensitive );
+      if ( index < 0 )
+      {
+        matches = false;
+        break;
+      }
+      from = index + part.length();
+    }
+    if ( !matches )
+      continue;
+
+    results << entry;
+    hasLastId = true;
+    lastId = entry.id;
+    if ( results.size() >= limit )
+      break;
+  }
+  return results;
+}
+
+QString QgsFeatureTextIndex::Index::displayText( QgsFeatureId id ) const
+{
+  const int position = mDisplayPositions.value( id, -1 );
+  return position < 0 ? QString() : mEntries.at( position ).text;
+}
+
+void QgsFeatureTextIndex::Index::addEntry( const Entry &entry )
+{
+  const int position = mEntries.size();
+  if ( entry.field == DISPLAY_EXPRESSION )
+    mDisplayPositions.insert( entry.id, position );
+  mEntries << entry;
+
+  const QString text = entry.text.toCaseFolded();
+  for ( int i = 0; i + 2 < text.length(); ++i )
+  {
+    QVector< int > &positions = mPostings[ trigramKey( text.constData() + i )];
+    // a text may contain the same trigram several times
+    if ( positions.isEmpty() || positions.last() != position )
+      positions << position;
+  }
+}
+
+QgsFeatureTextIndex *QgsFeatureTextIndex::indexForLayer( QgsVectorLayer *layer, Content content )
+{
+  const QList< QgsFeatureTextIndex * > indexes = layer->findChildren< QgsFeatureTextIndex * >( QString(), Qt::FindDirectChildrenOnly );
+  for ( QgsFeatureTextIndex *index : indexes )
+  {
+    if ( index->content() == content )
+      return index;
+  }
+  return new QgsFeatureTextIndex( layer, content );
+}
+
+QgsFeatureTextIndex::QgsFeatureTextIndex( QgsVectorLayer *layer, Content content )
+  : QObject( layer )
+  , mLayer( layer )
+  , mContent( content )
+{
+  connect( layer, &QgsVectorLayer::dataChanged, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::featureAdded, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::featureDeleted, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::attributeValueChanged, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::geometryChanged, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::editingStopped, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::subsetStringChanged, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::updatedFields, this, &QgsFeatureTextIndex::invalidate );
+  connect( layer, &QgsVectorLayer::displayExpressionChanged, this, &QgsFeatureTextIndex::invalidate );
+}
+
+QgsFeatureTextIndex::~QgsFeatureTextIndex() = default;
+
+std::shared_ptr< const QgsFeatureTextIndex::Index > QgsFeatureTextIndex::index()
+{
+  return mIndex.value( [this]() -> QgsBackgroundBuiltCache< Index >::BuildFunction
+  {
+    // the feature count may be unknown, in which case the build checks it
+    if ( mLayer->featureCount() > MAXIMUM_FEATURE_COUNT )
+      return nullptr;
+
+    std::shared_ptr< QgsAbstractFeatureSource > source = std::make_shared< QgsVectorLayerFeatureSource >( mLayer );
+    const QString displayExpression = mLayer->displayExpression();
+    const QgsExpressionContext context( QgsExpressionContextUtils::globalProjectLayerScopes( mLayer ) );
+    const QgsFields fields = mLayer->fields();
+    const Content content = mContent;
+    return [source, displayExpression, context, fields, content]( const QgsBackgroundBuiltCache< Index >::Build & build )
+    {
+      return buildIndex( build, source, displayExpression, context, fields, content );
+    };
+  } );
+}
+
+bool QgsFeatureTextIndex::isBuilding() const
+{
+  return mIndex.isBuilding();
+}
+
+bool QgsFeatureTextIndex::isTooLarge() const
+{
+  return mIndex.isUnavailable();
+}
+
+void QgsFeatureTextIndex::waitForFinished()
+{
+  mIndex.waitForFinished();
+}
+
+void QgsFeatureTextIndex::invalidate()
+{
+  mIndex.invalidate();
+}
+
+std::shared_ptr< QgsFeatureTextIndex::Index > QgsFeatureTextIndex::buildIndex( const QgsBackgroundBuiltCache< Index >::Build &build, const std::shared_ptr< QgsAbstractFeatureSource > &source,
+    const QString &displayExpression, QgsExpressionContext context, const QgsFields &fields, Content content )
+{
+  std::shared_ptr< Index > index = std::make_shared< Index >();
+
+  QgsExpression expression( displayExpression );
+  expression.prepare( &context );
+
+  QgsAttributeList stringFields;
+  for ( int i = 0; content == DisplayExpressionAndStringFields && i < fields.count(); ++i )
+  {
+    if ( fields.at( i ).type() == QVariant::String )
+      stringFields << i;
+  }
+
+  QgsFeatureRequest request;
+  QSet< int > attributes = expression.referencedAttributeIndexes( fields );
+  attributes.unite( stringFields.toSet() );
+  request.setSubsetOfAttributes( attributes.toList() );
+  if ( !expression.needsGeometry() )
+    request.setFlags( QgsFeatureRequest::NoGeometry );
+
+  QgsFeatureIterator it = source->getFeatures( request );
+  QgsFeature f;
+  Entry entry;
+  long featureCount = 0;
+  while ( it.nextFeature( f ) )
+  {
+    if ( build.isCanceled() )
+      return nullptr;
+
+    // the layer is too large to be indexed
+    if ( ++featureCount > MAXIMUM_FEATURE_COUNT )
+      return nullptr;
+
+    context.setFeature( f );
+    entry.id = f.id();
+    entry.field = DISPLAY_EXPRESSION;
+    entry.text = expression.evaluate( &context ).toString();
+    index->addEntry( entry );
+
+    for ( int field : qgis::as_const( stringFields ) )
+    {
+      const QVariant value = f.attribute( field );
+      if ( value.isNull() )
+        continue;
+
+      entry.field = field;
+      entry.text = value.toString();
+      index->addEntry( entry );
+    }
+  }
+
+  return index;
+}
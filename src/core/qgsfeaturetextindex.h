@@ -0,0 +1,185 @@
+/***************************************************************************
+                         qgsfeaturetextindex.h
+                         ---------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSFEATURETEXTINDEX_H
+#define QGSFEATURETEXTINDEX_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsbackgroundbuiltcache.h"
+#include "qgsexpressioncontext.h"
+#include "qgsfeatureid.h"
+#include "qgsfields.h"
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+class QgsAbstractFeatureSource;
+class QgsVectorLayer;
+
+/**
+ * \ingroup core
+ * \class QgsFeatureTextIndex
+ * \brief In-memory trigram index over the texts of the features of a vector layer, used for
+ * infix searches such as the ones of the locator.
+ *
+ * The index holds, for every feature, the value of the display expression of the layer and,
+ * depending on its content, the values of its string fields, and maps every trigram of these
+ * (case folded) texts to the texts containing it. A search for a text then only checks the texts
+ * containing its rarest trigram, instead of fetching and filtering all features of the layer.
+ *
+ * The index is built in a background thread the first time it is requested, and is rebuilt
+ * after the data, the fields or the display expression of the layer change. Built indexes are
+ * immutable and can be searched from any thread. Layers with more than MAXIMUM_FEATURE_COUNT
+ * features are not indexed.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+class CORE_EXPORT QgsFeatureTextIndex : public QObject
+{
+    Q_OBJECT
+
+  public:
+
+    //! Text of the display expression of a feature
+    static const int DISPLAY_EXPRESSION = -1;
+
+    //! Maximum number of features of an indexed layer
+    static const long MAXIMUM_FEATURE_COUNT = 1000000;
+
+    //! Texts held by an index
+    enum Content
+    {
+      DisplayExpressionOnly, //!< Only the display expression texts
+      DisplayExpressionAndStringFields, //!< The display expression texts and the values of the string fields
+    };
+
+    //! A text of a feature
+    struct Entry
+    {
+      //! Feature id
+      QgsFeatureId id = FID_NULL;
+
+      //! Index of the field of the text, or DISPLAY_EXPRESSION
+      int field = DISPLAY_EXPRESSION;
+
+      //! Text, as returned by QVariant::toString()
+      QString text;
+    };
+
+    /**
+     * A built index. Entries are sorted by feature, in the order of the data provider,
+     * then by field, starting with the display expression.
+     */
+    class CORE_EXPORT Index
+    {
+      public:
+
+        /**
+         * Returns the entries whose text contains all \a parts, in this order and ignoring case,
+         * like "text ILIKE '%part1%part2%'". If \a displayExpression is true, only the display
+         * expression texts are searched. Otherwise only the field texts are searched, and at most one
+         * entry is returned per feature, for its first matching field. At most \a limit entries are
+         * returned, in the order of the index.
+         */
+        QVector< Entry > search( const QStringList &parts, bool displayExpression, int limit ) const;
+
+        //! Returns the display expression text of the feature with the specified \a id
+        QString displayText( QgsFeatureId id ) const;
+
+        //! Returns the number of entries of the index
+        int count() const { return mEntries.count(); }
+
+      private:
+
+        QVector< Entry > mEntries;
+
+        //! Positions of the display expression entries of the features
+        QHash< QgsFeatureId, int > mDisplayPositions;
+
+        //! Sorted positions of the entries containing each trigram
+        QHash< quint64, QVector< int > > mPostings;
+
+        void addEntry( const Entry &entry );
+
+        friend class QgsFeatureTextIndex;
+    };
+
+    /**
+     * Returns the index of \a layer holding the specified \a content, created the first time it
+     * is requested. The index is owned by the layer.
+     */
+    static QgsFeatureTextIndex *indexForLayer( QgsVectorLayer *layer, Content content );
+
+    /**
+     * Constructor for QgsFeatureTextIndex, indexing the specified \a content of the features of
+     * \a layer. The index is a child of the layer.
+     */
+    QgsFeatureTextIndex( QgsVectorLayer *layer, Content content );
+
+    ~QgsFeatureTextIndex() override;
+
+    //! Returns the texts held by the index
+    Content content() const { return mContent; }
+
+    /**
+     * Returns the built index, or nullptr if it is not built yet or if the layer has too many
+     * features to be indexed. In the former case, a background build of the index is started.
+     *
+     * Must be called from the thread of the layer.
+     */
+    std::shared_ptr< const Index > index();
+
+    /**
+     * Returns true if the index is being built in the background.
+     */
+    bool isBuilding() const;
+
+    /**
+     * Returns true if the layer has more than MAXIMUM_FEATURE_COUNT features, and is not indexed.
+     * This is checked again after the index is invalidated.
+     */
+    bool isTooLarge() const;
+
+    /**
+     * Blocks until the background build of the index, if any, is finished.
+     */
+    void waitForFinished();
+
+  public slots:
+
+    /**
+     * Drops the built index, which is then rebuilt on the next request.
+     */
+    void invalidate();
+
+  private:
+
+    static std::shared_ptr< Index > buildIndex( const QgsBackgroundBuiltCache< Index >::Build &build, const std::shared_ptr< QgsAbstractFeatureSource > &source,
+        const QString &displayExpression, QgsExpressionContext context, const QgsFields &fields, Content content );
+
+    QgsVectorLayer *mLayer = nullptr;
+    Content mContent = DisplayExpressionAndStringFields;
+    QgsBackgroundBuiltCache< Index > mIndex;
+};
+
+#endif // QGSFEATURETEXTINDEX_H
@@ -0,0 +1,222 @@
+/***************************************************************************
+                         qgsgeneralizedgeometrycache.cpp
+                         -------------------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsgeneralizedgeometrycache.h"
+#include "qgsexception.h"
+#include "qgsmaptopixelgeometrysimplifier.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+
+#include <algorithm>
+
+///@cond PRIVATE
+
+/**
+ * Iterates over the features of a level of QgsGeneralizedGeometryCache.
+ * Expression and feature id filters as well as ordering are handled by QgsAbstractFeatureIterator.
+ */
+class QgsGeneralizedGeometryFeatureIterator : public QgsAbstractFeatureIterator
+{
+  public:
+    QgsGeneralizedGeometryFeatureIterator( const std::shared_ptr< const QgsGeneralizedGeometryCache::Level > &level, const QgsFeatureRequest &request )
+      : QgsAbstractFeatureIterator( request )
+      , mLevel( level )
+    {
+      if ( mRequest.destinationCrs().isValid() && mRequest.destinationCrs() != mLevel->crs )
+      {
+        mTransform = QgsCoordinateTransform( mLevel->crs, mRequest.destinationCrs(), mRequest.transformContext() );
+      }
+      try
+      {
+        mFilterRect = filterRectToSourceCrs( mTransform );
+      }
+      catch ( QgsCsException & )
+      {
+        // can't reproject mFilterRect
+        close();
+        return;
+      }
+
+      if ( mRequest.filterType() == QgsFeatureRequest::FilterFid )
+      {
+        for ( int i = 0; i < mLevel->features.size(); ++i )
+        {
+          if ( mLevel->features.at( i ).id() == mRequest.filterFid() )
+          {
+            mPositions << i;
+            break;
+          }
+        }
+      }
+      else if ( !mFilterRect.isNull() )
+      {
+        const QList< QgsFeatureId > positions = mLevel->index.intersects( mFilterRect );
+        mPositions.reserve( positions.size() );
+        for ( QgsFeatureId position : positions )
+          mPositions << static_cast< int >( position );
+        // keep the order of the data provider
+        std::sort( mPositions.begin(), mPositions.end() );
+      }
+      else
+      {
+        mPositions.reserve( mLevel->features.size() );
+        for ( int i = 0; i < mLevel->features.size(); ++i )
+          mPositions << i;
+      }
+    }
+
+    bool rewind() override
+    {
+      if ( mClosed )
+        return false;
+      mCurrent = 0;
+      return true;
+    }
+
+    bool close() override
+    {
+      mClosed = true;
+      mPositions.clear();
+      return true;
+    }
+
+  protected:
+    bool fetchFeature( QgsFeature &f ) override
+    {
+      f.setValid( false );
+
+      if ( mClosed )
+        return false;
+
+      while ( mCurrent < mPositions.size() )
+      {
+        f = mLevel->features.at( mPositions.at( mCurrent++ ) );
+        if ( !mFilterRect.isNull() && ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
+             && ( !f.hasGeometry() || !f.geometry().intersects( mFilterRect ) ) )
+          continue;
+
+        f.setValid( true );
+        geometryToDestinationCrs( f, mTransform );
+        return true;
+      }
+      close();
+      return false;
+    }
+
+  private:
+    std::shared_ptr< const QgsGeneralizedGeometryCache::Level > mLevel;
+    QVector< int > mPositions;
+    int mCurrent = 0;
+    QgsCoordinateTransform mTransform;
+    QgsRectangle mFilterRect;
+};
+
+///@endcond
+
+QgsGeneralizedGeometryCache::QgsGeneralizedGeometryCache( QgsVectorLayer *layer )
+  : mLayer( layer )
+{
+}
+
+QgsGeneralizedGeometryCache::~QgsGeneralizedGeometryCache() = default;
+
+std::shared_ptr< const QgsGeneralizedGeometryCache::Level > QgsGeneralizedGeometryCache::level( double tolerance )
+{
+  const QgsRectangle extent = mLayer->extent();
+  const double extentSize = std::max( extent.width(), extent.height() );
+  // no level would be detailed enough, there is no need to build them
+  if ( tolerance < levelTolerance( LEVEL_COUNT - 1, extentSize ) )
+    return nullptr;
+
+  const std::shared_ptr< const Levels > levels = mLevels.value( [this, extentSize]
+  {
+    std::shared_ptr< QgsAbstractFeatureSource > source = std::make_shared< QgsVectorLayerFeatureSource >( mLayer );
+    const QgsCoordinateReferenceSystem crs = mLayer->crs();
+    return [source, crs, extentSize]( const QgsBackgroundBuiltCache< Levels >::Build & build )
+    {
+      return buildLevels( build, source, crs, extentSize );
+    };
+  } );
+  if ( !levels )
+    return nullptr;
+
+  // levels are sorted from the coarsest to the finest one
+  for ( int i = 0; i < LEVEL_COUNT; ++i )
+  {
+    if ( levels->levels[i]->tolerance <= tolerance )
+      return levels->levels[i];
+  }
+  return nullptr;
+}
+
+bool QgsGeneralizedGeometryCache::isBuilding() const
+{
+  return mLevels.isBuilding();
+}
+
+void QgsGeneralizedGeometryCache::waitForFinished()
+{
+  mLevels.waitForFinished();
+}
+
+void QgsGeneralizedGeometryCache::invalidate()
+{
+  mLevels.invalidate();
+}
+
+QgsFeatureIterator QgsGeneralizedGeometryCache::getFeatures( const std::shared_ptr< const Level > &level, const QgsFeatureRequest &request )
+{
+  return QgsFeatureIterator( new QgsGeneralizedGeometryFeatureIterator( level, request ) );
+}
+
+std::shared_ptr< QgsGeneralizedGeometryCache::Levels > QgsGeneralizedGeometryCache::buildLevels( const QgsBackgroundBuiltCache< Levels >::Build &build, const std::shared_ptr< QgsAbstractFeatureSource > &source,
+    const QgsCoordinateReferenceSystem &crs, double extentSize )
+{
+  std::shared_ptr< Level > levels[LEVEL_COUNT];
+  std::vector< QgsMapToPixelSimplifier > simplifiers;
+  simplifiers.reserve( LEVEL_COUNT );
+  for ( int i = 0; i < LEVEL_COUNT; ++i )
+  {
+    levels[i] = std::make_shared< Level >();
+    levels[i]->tolerance = levelTolerance( i, extentSize );
+    levels[i]->crs = crs;
+    simplifiers.emplace_back( QgsMapToPixelSimplifier::SimplifyGeometry, levels[i]->tolerance, QgsMapToPixelSimplifier::Distance );
+  }
+
+  QgsFeatureIterator it = source->getFeatures( QgsFeatureRequest() );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    if ( build.isCanceled() )
+      return nullptr;
+
+    for ( int i = 0; i < LEVEL_COUNT; ++i )
+    {
+      QgsFeature generalized( f );
+      if ( f.hasGeometry() )
+      {
+        generalized.setGeometry( simplifiers[i].simplify( f.geometry() ) );
+        levels[i]->index.addFeature( levels[i]->features.size(), generalized.geometry().boundingBox() );
+      }
+      levels[i]->features << generalized;
+    }
+  }
+
+  std::shared_ptr< Levels > result = std::make_shared< Levels >();
+  for ( int i = 0; i < LEVEL_COUNT; ++i )
+    result->levels[i] = levels[i];
+  return result;
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+                         qgsgeneralizedgeometrycache.h
+                         -----------------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSGENERALIZEDGEOMETRYCACHE_H
+#define QGSGENERALIZEDGEOMETRYCACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsbackgroundbuiltcache.h"
+#include "qgscoordinatereferencesystem.h"
+#include "qgsfeature.h"
+#include "qgsfeatureiterator.h"
+#include "qgsspatialindex.h"
+
+#include <QVector>
+#include <memory>
+
+class QgsAbstractFeatureSource;
+class QgsVectorLayer;
+
+/**
+ * \ingroup core
+ * \class QgsGeneralizedGeometryCache
+ * \brief In-memory cache of generalized geometries of a vector layer, used when rendering at small scales.
+ *
+ * The cache holds LEVEL_COUNT levels of generalization of the layer features. The tolerance
+ * of the coarsest level is 1/256 of the size of the layer extent, and the tolerance is halved
+ * from one level to the next one. All levels are built at once in a background thread, the
+ * first time a level is requested, reading the layer features only once.
+ *
+ * QgsVectorLayerRenderer asks for the coarsest level whose tolerance does not exceed the
+ * simplification tolerance of the map. Features are then read from memory, with geometries
+ * which already have about the detail visible on screen, instead of being fetched
+ * and simplified again from the data provider at each redraw.
+ *
+ * The levels are dropped when the layer data changes, and rebuilt on the next request.
+ * Built levels are immutable and can be shared by several render jobs.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+class CORE_EXPORT QgsGeneralizedGeometryCache
+{
+  public:
+
+    //! Number of levels of generalization
+    static const int LEVEL_COUNT = 6;
+
+    /**
+     * A level of generalization: all layer features, with geometries simplified
+     * to the level tolerance, and a spatial index over them.
+     */
+    struct Level
+    {
+      //! Simplification tolerance of the geometries, in layer units
+      double tolerance = 0;
+
+      //! CRS of the geometries, i.e. the layer CRS
+      QgsCoordinateReferenceSystem crs;
+
+      //! Features of the level, in the order of the data provider
+      QVector< QgsFeature > features;
+
+      //! Spatial index over the features, using the positions in features as ids
+      QgsSpatialIndex index;
+    };
+
+    /**
+     * Constructor for QgsGeneralizedGeometryCache, caching features of the specified \a layer.
+     */
+    explicit QgsGeneralizedGeometryCache( QgsVectorLayer *layer );
+
+    ~QgsGeneralizedGeometryCache();
+
+    //! QgsGeneralizedGeometryCache cannot be copied
+    QgsGeneralizedGeometryCache( const QgsGeneralizedGeometryCache &rh ) = delete;
+    //! QgsGeneralizedGeometryCache cannot be copied
+    QgsGeneralizedGeometryCache &operator=( const QgsGeneralizedGeometryCache &rh ) = delete;
+
+    /**
+     * Returns the coarsest level whose tolerance does not exceed \a tolerance (in layer units),
+     * or nullptr if there is no such level or if levels are not built yet. In the latter case,
+     * a background build of the levels is started, unless \a tolerance is below the one of
+     * the finest level.
+     *
+     * Must be called from the thread of the layer.
+     */
+    std::shared_ptr< const Level > level( double tolerance );
+
+    /**
+     * Returns true if the levels are being built in the background.
+     */
+    bool isBuilding() const;
+
+    /**
+     * Blocks until the background build of the levels, if any, is finished.
+     */
+    void waitForFinished();
+
+    /**
+     * Drops all levels, e.g. after a change of the layer data. Any running build
+     * is abandoned.
+     */
+    void invalidate();
+
+    /**
+     * Returns an iterator over the features of \a level matching \a request. The iterator
+     * keeps a reference to the level.
+     */
+    static QgsFeatureIterator getFeatures( const std::shared_ptr< const Level > &level, const QgsFeatureRequest &request );
+
+  private:
+
+    //! All levels, from the coarsest to the finest one
+    struct Levels
+    {
+      std::shared_ptr< const Level > levels[LEVEL_COUNT];
+    };
+
+    //! Returns the tolerance of the level \a index, for a layer extent of size \a extentSize
+    static double levelTolerance( int index, double extentSize ) { return extentSize / ( 256 << index ); }
+
+    static std::shared_ptr< Levels > buildLevels( const QgsBackgroundBuiltCache< Levels >::Build &build, const std::shared_ptr< QgsAbstractFeatureSource > &source,
+        const QgsCoordinateReferenceSystem &crs, double extentSize );
+
+    QgsVectorLayer *mLayer = nullptr;
+    QgsBackgroundBuiltCache< Levels > mLevels;
+};
+
+#endif // QGSGENERALIZEDGEOMETRYCACHE_H
@@ -275,7 +275,20 @@ bool QgsMapLayer::readLayerXml( const QDomElement &layerElement, QgsReadWriteCon
   QgsReadWriteContextCategoryPopper p = context.enterCategory( tr( "Layer" ), mne.text() );
 
   // now let the children grab what they need from the Dom node.
-  layerError = !readXml( layerElement, context );
+  mLoadingDeferred = mDeferLoading;
+  if ( mLoadingDeferred )
+  {
+    // keep a copy of the element, the children will read it when the loading is completed
+    mDeferredDocument = QDomDocument();
+    mDeferredDocument.appendChild( mDeferredDocument.importNode( layerElement, true ) );
+    mDeferredPathResolver = context.pathResolver();
+    mDeferredProjectTranslator = mDeferredProject && context.projectTranslator() == mDeferredProject.data();
+    layerError = !readDeferredXml( layerElement, context );
+  }
+  else
+  {
+    layerError = !readXml( layerElement, context );
+  }
 
   // overwrite CRS with what we read from project file before the raster/vector
   // file reading functions changed it. They will if projections is specified in the file.
@@ -394,9 +407,75 @@ bool QgsMapLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &cont
   return true;
 } // void QgsMapLayer::readXml
 
+bool QgsMapLayer::readDeferredXml( const QDomNode &layerNode, QgsReadWriteContext &context )
+{
+  Q_UNUSED( context );
+
+  const QDomElement extentElem = layerNode.firstChildElement( QStringLiteral( "extent" ) );
+  if ( !extentElem.isNull() )
+  {
+    mExtent = QgsXmlUtils::readRectangle( extentElem );
+  }
+
+  // styles and custom properties do not depend on the data provider, and are read again
+  // by readXml() when the loading is completed
+  readStyleManager( layerNode );
+  readCustomProperties( layerNode );
+
+  // trust the project, the data provider is checked when the loading is completed
+  mValid = true;
+  return true;
+}
+
+void QgsMapLayer::setDeferredLoading( bool deferred, QgsProject *project )
+{
+  mDeferLoading = deferred;
+  mDeferredProject = project;
+}
+
+bool QgsMapLayer::completeDeferredLoading()
+{
+  if ( !mLoadingDeferred )
+    return mValid;
+
+  // reset first, as reading the layer may call methods which complete the loading
+  mLoadingDeferred = false;
+  const QDomDocument document = mDeferredDocument;
+  mDeferredDocument = QDomDocument();
+
+  // the read context is rebuilt from the settings of the one the layer was read with
+  QgsReadWriteContext context;
+  context.setPathResolver( mDeferredPathResolver );
+  if ( mDeferredProjectTranslator && mDeferredProject )
+    context.setProjectTranslator( mDeferredProject.data() );
+
+  // as in readLayerXml(), the CRS stored in the project wins over the one of the data source
+  const QgsCoordinateReferenceSystem savedCrs = mCRS;
+  const CUSTOM_CRS_VALIDATION savedValidation = QgsCoordinateReferenceSystem::customCrsValidation();
+  QgsCoordinateReferenceSystem::setCustomCrsValidation( nullptr );
+
+  const bool result = readXml( document.documentElement(), context );
+
+  QgsCoordinateReferenceSystem::setCustomCrsValidation( savedValidation );
+  mCRS = savedCrs;
+
+  if ( mDeferredProject )
+    resolveReferences( mDeferredProject );
+
+  if ( !result )
+    mValid = false;
+
+  QgsDebugMsgLevel( QStringLiteral( "Completed deferred loading of layer %1" ).arg( mID ), 2 );
+  emit deferredLoadingCompleted();
+  return mValid;
+}
+
 
 bool QgsMapLayer::writeLayerXml( QDomElement &layerElement, QDomDocument &document, const QgsReadWriteContext &context ) const
 {
+  // the state specific to the layer type is only known once the loading is completed
+  ensureLoaded();
+
   if ( !extent().isNull() )
   {
     layerElement.appendChild( QgsXmlUtils::writeRectangle( mExtent, document ) );
@@ -618,6 +697,31 @@ QString QgsMapLayer::decodedSource( const QString &source, const QString &dataPr
   return source;
 }
 
+QString QgsMapLayer::decodedLayerSource( const QDomElement &layerElement, const QString &providerKey, const QgsReadWriteContext &context ) const
+{
+  const QString source = layerElement.namedItem( QStringLiteral( "datasource" ) ).toElement().text();
+  return decodedSource( source, providerKey, context );
+}
+
+void QgsMapLayer::setPreloadedDataProvider( const QString &providerKey, const QString &dataSource, QgsDataProvider *provider )
+{
+  mPreloadedProvider.reset( provider );
+  mPreloadedProviderKey = providerKey;
+  mPreloadedDataSource = dataSource;
+}
+
+QgsDataProvider *QgsMapLayer::createDataProvider( const QString &providerKey, const QString &dataSource, const QgsDataProvider::ProviderOptions &options )
+{
+  if ( mPreloadedProvider )
+  {
+    // the preloaded provider is only used once, a mismatching one is discarded
+    std::unique_ptr< QgsDataProvider > provider = std::move( mPreloadedProvider );
+    if ( providerKey == mPreloadedProviderKey && dataSource == mPreloadedDataSource )
+      return provider.release();
+  }
+  return QgsProviderRegistry::instance()->createProvider( providerKey, dataSource, options );
+}
+
 void QgsMapLayer::resolveReferences( QgsProject *project )
 {
   if ( m3DRenderer )
@@ -20,10 +20,12 @@
 
 #include "qgis_core.h"
 #include <QDateTime>
+#include <QDomDocument>
 #include <QDomNode>
 #include <QImage>
 #include <QObject>
 #include <QPainter>
+#include <QPointer>
 #include <QUndoStack>
 #include <QVariant>
 #include <QIcon>
@@ -559,6 +561,70 @@ class CORE_EXPORT QgsMapLayer : public QObject
      */
     virtual void resolveReferences( QgsProject *project );
 
+    /**
+     * Sets whether the next call to readLayerXml() defers the loading of the layer.
+     *
+     * A deferred layer only reads its generic properties (name, CRS, extent, metadata,
+     * styles, legend, custom properties...) from the DOM element, and is considered valid
+     * without creating its data provider. The data provider and the properties specific to
+     * the layer type are loaded by completeDeferredLoading(), which is called automatically
+     * by the layer the first time its data is accessed.
+     *
+     * References to other layers are resolved against the \a project the layer is read
+     * for, when the loading is completed.
+     *
+     * \see isLoadingDeferred()
+     * \since QGIS 3.6
+     */
+    void setDeferredLoading( bool deferred, QgsProject *project = nullptr );
+
+    /**
+     * Returns true if the loading of the layer has been deferred by readLayerXml() and has
+     * not been completed yet.
+     * \see setDeferredLoading()
+     * \see completeDeferredLoading()
+     * \since QGIS 3.6
+     */
+    bool isLoadingDeferred() const { return mLoadingDeferred; }
+
+    /**
+     * Completes the loading of a layer deferred by readLayerXml(), creating its data provider.
+     * References to other layers are resolved against the project set with setDeferredLoading().
+     *
+     * Does nothing if the loading of the layer has not been deferred.
+     *
+     * \returns true if the layer is valid
+     * \see isLoadingDeferred()
+     * \since QGIS 3.6
+     */
+    bool completeDeferredLoading();
+
+    /**
+     * Returns the data source stored in the DOM \a layerElement, decoded for the
+     * data provider \a providerKey as readLayerXml() does. This lets callers
+     * create the data provider of the layer in advance.
+     *
+     * \see setPreloadedDataProvider()
+     * \note not available in Python bindings
+     * \since QGIS 3.6
+     */
+    QString decodedLayerSource( const QDomElement &layerElement, const QString &providerKey, const QgsReadWriteContext &context ) const SIP_SKIP;
+
+    /**
+     * Sets a data \a provider created in advance for the specified \a providerKey and
+     * \a dataSource, e.g. on a worker thread while reading a project. The next time the
+     * layer needs a provider with the same key and data source (usually in readLayerXml()),
+     * it takes \a provider instead of instantiating a new one. The provider must live
+     * in the thread of the layer.
+     *
+     * Ownership of \a provider is transferred to the layer.
+     *
+     * \see decodedLayerSource()
+     * \note not available in Python bindings
+     * \since QGIS 3.6
+     */
+    void setPreloadedDataProvider( const QString &providerKey, const QString &dataSource, QgsDataProvider *provider ) SIP_SKIP;
+
     /**
      * Returns list of all keys within custom properties. Properties are stored in a map and saved in project file.
      * \see customProperty()
@@ -1305,6 +1371,16 @@ class CORE_EXPORT QgsMapLayer : public QObject
      */
     void dataSourceChanged();
 
+    /**
+     * Emitted when the deferred loading of the layer has been completed, i.e. once its
+     * data provider has been created.
+     *
+     * \see completeDeferredLoading()
+     *
+     * \since QGIS 3.6
+     */
+    void deferredLoadingCompleted();
+
   private slots:
 
     void onNotifiedTriggerRepaint( const QString &message );
@@ -1330,6 +1406,29 @@ class CORE_EXPORT QgsMapLayer : public QObject
      */
     virtual bool readXml( const QDomNode &layer_node, QgsReadWriteContext &context );
 
+    /**
+     * Called by readLayerXML() instead of readXml() when the loading of the layer is deferred.
+     * Children may read the properties they can provide without a data provider, the
+     * rest of their state is read by readXml() when the loading is completed. The default
+     * implementation reads the extent, the styles and the custom properties stored in the
+     * project and marks the layer as valid.
+     * \see setDeferredLoading()
+     * \since QGIS 3.6
+     */
+    virtual bool readDeferredXml( const QDomNode &layerNode, QgsReadWriteContext &context );
+
+    /**
+     * Completes the deferred loading of the layer, if any. Must be called by the methods
+     * returning state which is only read once the loading is completed. The data provider
+     * of the layer completes the loading itself, see QgsMapLayerProviderPointer.
+     * \since QGIS 3.6
+     */
+    void ensureLoaded() const SIP_SKIP
+    {
+      if ( Q_UNLIKELY( mLoadingDeferred ) )
+        const_cast< QgsMapLayer * >( this )->completeDeferredLoading();
+    }
+
     /**
      * Called by writeLayerXML(), used by children to write state specific to them to
      *  project files.
@@ -1363,6 +1462,18 @@ class CORE_EXPORT QgsMapLayer : public QObject
      */
     virtual QString decodedSource( const QString &source, const QString &dataProvider, const QgsReadWriteContext &context ) const;
 
+    /**
+     * Creates a new data provider for the specified \a providerKey and \a dataSource.
+     * The provider set with setPreloadedDataProvider() is returned if it matches, otherwise
+     * the provider is instantiated by the provider registry.
+     *
+     * Caller takes ownership of the returned provider.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.6
+     */
+    QgsDataProvider *createDataProvider( const QString &providerKey, const QString &dataSource, const QgsDataProvider::ProviderOptions &options ) SIP_SKIP;
+
     /**
      * Read custom properties from project file.
       \param layerNode note to read from
@@ -1510,6 +1621,29 @@ class CORE_EXPORT QgsMapLayer : public QObject
     //! Layer's persistent storage of additional properties (may be used by plugins)
     QgsObjectCustomProperties mCustomProperties;
 
+    //! Whether readLayerXml() defers the loading of the layer
+    bool mDeferLoading = false;
+
+    //! True while the loading of the layer is deferred
+    bool mLoadingDeferred = false;
+
+    //! Copy of the layer element, kept until the deferred loading is completed
+    QDomDocument mDeferredDocument;
+
+    //! Path resolver used to complete the deferred loading
+    QgsPathResolver mDeferredPathResolver;
+
+    //! True if the deferred layer was read with the project as translator
+    bool mDeferredProjectTranslator = false;
+
+    //! Project the deferred layer is read for, used to resolve references to other layers
+    QPointer< QgsProject > mDeferredProject;
+
+    //! Data provider created in advance, with the provider key and data source it was created for
+    std::unique_ptr< QgsDataProvider > mPreloadedProvider;
+    QString mPreloadedProviderKey;
+    QString mPreloadedDataSource;
+
     //! Controller of legend items of this layer
     QgsMapLayerLegend *mLegend = nullptr;
 
@@ -1531,6 +1665,7 @@ class CORE_EXPORT QgsMapLayer : public QObject
      */
     QString mOriginalXmlProperties;
 
+    friend class TestQgsProject;
 };
 
 Q_DECLARE_METATYPE( QgsMapLayer * )
@@ -1540,6 +1675,55 @@ Q_DECLARE_OPERATORS_FOR_FLAGS( QgsMapLayer::StyleCategories )
 
 #ifndef SIP_RUN
 
+/**
+ * \ingroup core
+ * Data provider pointer of a map layer. Any access to the provider first completes
+ * the deferred loading of the layer (see QgsMapLayer::setDeferredLoading()), so that
+ * the layer code never sees the missing provider of a deferred layer.
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+template< class T >
+class QgsMapLayerProviderPointer
+{
+  public:
+
+    //! Constructor for QgsMapLayerProviderPointer, for the provider of \a layer
+    explicit QgsMapLayerProviderPointer( QgsMapLayer *layer )
+      : mLayer( layer )
+    {}
+
+    QgsMapLayerProviderPointer( const QgsMapLayerProviderPointer &other ) = delete;
+    QgsMapLayerProviderPointer &operator=( const QgsMapLayerProviderPointer &other ) = delete;
+
+    QgsMapLayerProviderPointer &operator=( T *provider )
+    {
+      mProvider = provider;
+      return *this;
+    }
+
+    //! Returns the provider, once the deferred loading of the layer is completed
+    T *get() const
+    {
+      if ( Q_UNLIKELY( mLayer->isLoadingDeferred() ) )
+        mLayer->completeDeferredLoading();
+      return mProvider;
+    }
+
+    /**
+     * Returns the provider without completing the deferred loading of the layer, e.g.
+     * to delete it.
+     */
+    T *loadedProvider() const { return mProvider; }
+
+    T *operator->() const { return get(); }
+    operator T *() const { return get(); }
+
+  private:
+    QgsMapLayer *mLayer = nullptr;
+    T *mProvider = nullptr;
+};
+
 /**
  * Weak pointer for QgsMapLayer
  * \note not available in Python bindings
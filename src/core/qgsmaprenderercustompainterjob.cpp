@@ -269,6 +269,14 @@ void QgsMapRendererCustomPainterJob::doRender()
 
       job.renderingTime += layerTime.elapsed();
     }
+    else if ( job.renderer )
+    {
+      // the cached image is still valid, the renderer only registers labels
+      QTime layerTime;
+      layerTime.start();
+      job.renderer->render();
+      job.renderingTime += layerTime.elapsed();
+    }
 
     if ( job.img )
     {
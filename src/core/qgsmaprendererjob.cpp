@@ -266,14 +266,15 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
       continue;
     }
 
-    // Force render of layers that are being edited
-    // or if there's a labeling engine that needs the layer to register features
+    // Force render of layers that are being edited.
+    // Layers which must register features with the labeling engine keep their cached
+    // image, and only go through their features again without drawing symbols
+    bool requiresLabeling = false;
     if ( mCache && ml->type() == QgsMapLayer::VectorLayer )
     {
       QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( ml );
-      bool requiresLabeling = false;
       requiresLabeling = ( labelingEngine2 && QgsPalLabeling::staticWillUseLayer( vl ) ) && requiresLabelRedraw;
-      if ( vl->isEditable() || requiresLabeling )
+      if ( vl->isEditable() )
       {
         mCache->clearCacheImage( ml->id() );
       }
@@ -316,6 +317,14 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
       job.img->setDevicePixelRatio( mSettings.devicePixelRatio() );
       job.renderer = nullptr;
       job.context.setPainter( nullptr );
+      if ( requiresLabeling )
+      {
+        job.context.setFlag( QgsRenderContext::SkipSymbolRendering );
+        QTime layerTime;
+        layerTime.start();
+        job.renderer = ml->createMapRenderer( job.context );
+        job.renderingTime = layerTime.elapsed();
+      }
       continue;
     }
 
@@ -239,10 +239,11 @@ void QgsMapRendererParallelJob::renderLayerStatic( LayerRenderJob &job )
   if ( job.context.renderingStopped() )
     return;
 
-  if ( job.cached )
+  // cached layers only have a renderer when they must register their labels again
+  if ( job.cached && !job.renderer )
     return;
 
-  if ( job.img )
+  if ( job.img && !job.cached )
   {
     job.img->fill( 0 );
     job.imageInitialized = true;
@@ -52,6 +52,7 @@
 #include "qgsmaplayerstore.h"
 #include "qgsziputils.h"
 #include "qgsauxiliarystorage.h"
+#include "qgsproviderregistry.h"
 
 #include <QApplication>
 #include <QFileInfo>
@@ -61,6 +62,8 @@
 #include <QTemporaryFile>
 #include <QDir>
 #include <QUrl>
+#include <QThread>
+#include <QtConcurrentMap>
 
 
 #ifdef _MSC_VER
@@ -894,9 +897,21 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
 
   QVector<QDomNode> sortedLayerNodes = depSorter.sortedLayerNodes();
 
+  // create the layers first, so that their data providers can be instantiated
+  // concurrently; layers are then read and registered in document order
+  QVector<QgsMapLayer *> layers( sortedLayerNodes.size(), nullptr );
+  for ( int j = 0; j < sortedLayerNodes.size(); ++j )
+  {
+    const QDomElement element = sortedLayerNodes.at( j ).toElement();
+    if ( element.attribute( QStringLiteral( "embedded" ) ) != QLatin1String( "1" ) )
+      layers[j] = createLayer( element );
+  }
+  preloadDataProviders( sortedLayerNodes, layers );
+
   int i = 0;
-  Q_FOREACH ( const QDomNode &node, sortedLayerNodes )
+  for ( int j = 0; j < sortedLayerNodes.size(); ++j )
   {
+    const QDomNode &node = sortedLayerNodes.at( j );
     QDomElement element = node.toElement();
 
     QString name = translate( QStringLiteral( "project:layers:%1" ).arg( node.namedItem( QStringLiteral( "id" ) ).toElement().text() ), node.namedItem( QStringLiteral( "layername" ) ).toElement().text() );
@@ -913,7 +928,7 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
       QgsReadWriteContext context;
       context.setPathResolver( pathResolver() );
       context.setProjectTranslator( this );
-      if ( !addLayer( element, brokenNodes, context ) )
+      if ( !addLayer( layers.at( j ), element, brokenNodes, context ) )
       {
         returnStatus = false;
       }
@@ -931,6 +946,11 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
 }
 
 bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context )
+{
+  return addLayer( createLayer( layerElem ), layerElem, brokenNodes, context );
+}
+
+QgsMapLayer *QgsProject::createLayer( const QDomElement &layerElem ) const
 {
   QString type = layerElem.attribute( QStringLiteral( "type" ) );
   QgsDebugMsgLevel( "Layer type is " + type, 4 );
@@ -945,10 +965,12 @@ bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &broken
     {
       vl->setReadExtentFromXml( mTrustLayerMetadata );
     }
+    mapLayer->setDeferredLoading( mDeferredLayerLoading, this );
   }
   else if ( type == QLatin1String( "raster" ) )
   {
     mapLayer = new QgsRasterLayer;
+    mapLayer->setDeferredLoading( mDeferredLayerLoading, this );
   }
   else if ( type == QLatin1String( "mesh" ) )
   {
@@ -960,6 +982,82 @@ bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &broken
     mapLayer = QgsApplication::pluginLayerRegistry()->createLayer( typeName );
   }
 
+  return mapLayer;
+}
+
+void QgsProject::preloadDataProviders( const QVector<QDomNode> &layerNodes, const QVector<QgsMapLayer *> &layers ) const
+{
+  // the providers of deferred layers are created on demand
+  if ( mDeferredLayerLoading )
+    return;
+
+  // providers which only open local files can be created on a worker thread. Others
+  // rely on resources tied to the main thread (e.g. shared database connections or
+  // network authentication prompts) and are created when their layer is read.
+  static const QStringList sPreloadableProviders
+  {
+    QStringLiteral( "ogr" ),
+    QStringLiteral( "gdal" ),
+    QStringLiteral( "spatialite" ),
+  };
+
+  struct PreloadJob
+  {
+    QgsMapLayer *layer = nullptr;
+    QString providerKey;
+    QString dataSource;
+    QgsDataProvider *provider = nullptr;
+  };
+
+  QgsReadWriteContext context;
+  context.setPathResolver( pathResolver() );
+
+  QVector<PreloadJob> jobs;
+  for ( int i = 0; i < layers.size(); ++i )
+  {
+    QgsMapLayer *layer = layers.at( i );
+    if ( !layer || ( layer->type() != QgsMapLayer::VectorLayer && layer->type() != QgsMapLayer::RasterLayer ) )
+      continue;
+
+    const QDomElement element = layerNodes.at( i ).toElement();
+    PreloadJob job;
+    job.layer = layer;
+    job.providerKey = element.namedItem( QStringLiteral( "provider" ) ).toElement().text();
+    if ( !sPreloadableProviders.contains( job.providerKey ) )
+      continue;
+
+    job.dataSource = layer->decodedLayerSource( element, job.providerKey, context );
+    // the master password may have to be asked when the layer is read
+    if ( job.dataSource.contains( QLatin1String( "authcfg=" ) ) )
+      continue;
+
+    jobs << job;
+  }
+
+  // nothing to gain over creating the provider when reading the layer
+  if ( jobs.size() < 2 )
+    return;
+
+  QThread *layerThread = QThread::currentThread();
+  QtConcurrent::blockingMap( jobs, [layerThread]( PreloadJob & job )
+  {
+    QgsDataProvider::ProviderOptions options;
+    job.provider = QgsProviderRegistry::instance()->createProvider( job.providerKey, job.dataSource, options );
+    if ( job.provider )
+      job.provider->moveToThread( layerThread );
+  } );
+
+  for ( const PreloadJob &job : qgis::as_const( jobs ) )
+  {
+    if ( job.provider )
+      job.layer->setPreloadedDataProvider( job.providerKey, job.dataSource, job.provider );
+  }
+}
+
+bool QgsProject::addLayer( QgsMapLayer *mapLayer, const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context )
+{
+  const QString type = layerElem.attribute( QStringLiteral( "type" ) );
+
   if ( !mapLayer )
   {
     QgsDebugMsg( QStringLiteral( "Unable to create layer" ) );
@@ -1560,7 +1658,19 @@ void QgsProject::onMapLayersAdded( const QList<QgsMapLayer *> &layers )
             tg->addLayer( vlayer );
           }
         }
-        vlayer->dataProvider()->setProviderProperty( QgsVectorDataProvider::EvaluateDefaultValues, evaluateDefaultValues() );
+        if ( vlayer->isLoadingDeferred() )
+        {
+          // the data provider is only created when the loading of the layer is completed
+          connect( vlayer, &QgsMapLayer::deferredLoadingCompleted, this, [ = ]
+          {
+            if ( vlayer->dataProvider() )
+              vlayer->dataProvider()->setProviderProperty( QgsVectorDataProvider::EvaluateDefaultValues, evaluateDefaultValues() );
+          } );
+        }
+        else
+        {
+          vlayer->dataProvider()->setProviderProperty( QgsVectorDataProvider::EvaluateDefaultValues, evaluateDefaultValues() );
+        }
       }
 
       if ( tgChanged )
@@ -2412,7 +2522,7 @@ void QgsProject::setEvaluateDefaultValues( bool evaluateDefaultValues )
   for ( ; layerIt != layers.constEnd(); ++layerIt )
   {
     QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( layerIt.value() );
-    if ( vl )
+    if ( vl && !vl->isLoadingDeferred() )
     {
       vl->dataProvider()->setProviderProperty( QgsVectorDataProvider::EvaluateDefaultValues, evaluateDefaultValues );
     }
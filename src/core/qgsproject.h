@@ -927,6 +927,30 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
      */
     bool trustLayerMetadata() const { return mTrustLayerMetadata; }
 
+    /**
+     * Sets whether the loading of vector and raster layers is deferred when the project
+     * is read. Deferred layers are created with the properties stored in the project
+     * file (name, CRS, extent, metadata...), without instantiating their data provider.
+     * The provider of a layer is created the first time its data is accessed, or when
+     * QgsMapLayer::completeDeferredLoading() is called.
+     *
+     * This option is not stored in the project file, it is meant to be set by applications
+     * which only use a subset of the layers of a project (e.g. QGIS Server).
+     *
+     * \see deferredLayerLoading()
+     * \since QGIS 3.6
+     */
+    void setDeferredLayerLoading( bool deferred ) { mDeferredLayerLoading = deferred; }
+
+    /**
+     * Returns true if the loading of vector and raster layers is deferred when the
+     * project is read.
+     *
+     * \see setDeferredLayerLoading()
+     * \since QGIS 3.6
+     */
+    bool deferredLayerLoading() const { return mDeferredLayerLoading; }
+
     /**
      * Returns the current const auxiliary storage.
      *
@@ -1382,6 +1406,27 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
      */
     bool addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context ) SIP_SKIP;
 
+    /**
+     * Reads \a mapLayer from \a layerElem and adds it to maplayer registry.
+     * Ownership of \a mapLayer is transferred to the project.
+     * \note not available in Python bindings
+     */
+    bool addLayer( QgsMapLayer *mapLayer, const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context ) SIP_SKIP;
+
+    /**
+     * Creates an empty layer of the type stored in \a layerElem, or nullptr if the type is unknown.
+     * \note not available in Python bindings
+     */
+    QgsMapLayer *createLayer( const QDomElement &layerElem ) const SIP_SKIP;
+
+    /**
+     * Instantiates concurrently the data providers of the \a layers read from \a layerNodes,
+     * for the providers which can be created on a worker thread. Providers are handed
+     * to their layers with QgsMapLayer::setPreloadedDataProvider().
+     * \note not available in Python bindings
+     */
+    void preloadDataProviders( const QVector<QDomNode> &layerNodes, const QVector<QgsMapLayer *> &layers ) const SIP_SKIP;
+
     //! \note not available in Python bindings
     void initializeEmbeddedSubtree( const QString &projectFilePath, QgsLayerTreeGroup *group ) SIP_SKIP;
 
@@ -1455,6 +1500,8 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
     int mDirtyBlockCount = 0;
     bool mTrustLayerMetadata = false;
 
+    bool mDeferredLayerLoading = false;
+
     QgsCoordinateTransformContext mTransformContext;
 
     QgsProjectMetadata mMetadata;
@@ -1465,6 +1512,8 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
 
     // Required by QGIS Server for switching the current project instance
     friend class QgsConfigCache;
+
+    friend class TestQgsProject;
 };
 
 /**
@@ -72,6 +72,7 @@ class CORE_EXPORT QgsRenderContext
       Antialiasing             = 0x80,  //!< Use antialiasing while drawing
       RenderPartialOutput      = 0x100, //!< Whether to make extra effort to update map image with partially rendered layers (better for interactive map canvas). Added in QGIS 3.0
       RenderPreviewJob         = 0x200, //!< Render is a 'canvas preview' render, and shortcuts should be taken to ensure fast rendering
+      SkipSymbolRendering      = 0x400, //!< Skip drawing the symbols of vector layers, while still registering their features with the labeling engine (since QGIS 3.6)
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
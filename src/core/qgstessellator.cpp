@@ -29,6 +29,7 @@
 #include <QtDebug>
 #include <QMatrix4x4>
 #include <QVector3D>
+#include <QSet>
 #include <algorithm>
 
 
@@ -203,7 +204,7 @@ static void _normalVectorToXYVectors( const QVector3D &pNormal, QVector3D &pXVec
 }
 
 
-static void _ringToPoly2tri( const QgsCurve *ring, std::vector<p2t::Point *> &polyline, QHash<p2t::Point *, float> &zHash )
+static void _ringToPoly2tri( const QgsCurve *ring, std::vector<p2t::Point> &points, std::vector<float> &zValues, std::vector<p2t::Point *> &polyline )
 {
   QgsVertexId::VertexType vt;
   QgsPoint pt;
@@ -212,6 +213,10 @@ static void _ringToPoly2tri( const QgsCurve *ring, std::vector<p2t::Point *> &po
 
   polyline.reserve( pCount );
 
+  // duplicate points are looked up in a hash rather than in the whole polyline
+  QSet< QPair< float, float > > ringPoints;
+  ringPoints.reserve( pCount );
+
   for ( int i = 0; i < pCount - 1; ++i )
   {
     ring->pointAt( i, pt, vt );
@@ -219,16 +224,19 @@ static void _ringToPoly2tri( const QgsCurve *ring, std::vector<p2t::Point *> &po
     const float y = pt.y();
     const float z = pt.z();
 
-    const bool found = std::find_if( polyline.begin(), polyline.end(), [x, y]( p2t::Point *&p ) { return *p == p2t::Point( x, y ); } ) != polyline.end();
-
-    if ( found )
+    const QPair< float, float > xy( x, y );
+    if ( ringPoints.contains( xy ) )
     {
       continue;
     }
-
-    p2t::Point *pt2 = new p2t::Point( x, y );
-    polyline.push_back( pt2 );
-    zHash[pt2] = z;
+    ringPoints.insert( xy );
+
+    // points are stored in an array reserved for all points of the polygon, so that
+    // the pointers given to poly2tri stay valid
+    Q_ASSERT( points.size() < points.capacity() );
+    points.emplace_back( x, y );
+    zValues.push_back( z );
+    polyline.push_back( &points.back() );
   }
 }
 
@@ -444,13 +452,24 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
       return;
     }
 
-    QList< std::vector<p2t::Point *> > polylinesToDelete;
-    QHash<p2t::Point *, float> z;
+    // storage for all points of the polygon, with their z values at the same index
+    int pointCount = polygonNew->exteriorRing()->numPoints();
+    for ( int i = 0; i < polygonNew->numInteriorRings(); ++i )
+      pointCount += polygonNew->interiorRing( i )->numPoints();
+    std::vector<p2t::Point> points;
+    points.reserve( pointCount );
+    std::vector<float> z;
+    z.reserve( pointCount );
+
+    auto pointZ = [&points, &z]( const p2t::Point * p ) -> float
+    {
+      const std::ptrdiff_t index = p - points.data();
+      return index >= 0 && index < static_cast< std::ptrdiff_t >( z.size() ) ? z[index] : 0;
+    };
 
     // polygon exterior
     std::vector<p2t::Point *> polyline;
-    _ringToPoly2tri( polygonNew->exteriorRing(), polyline, z );
-    polylinesToDelete << polyline;
+    _ringToPoly2tri( polygonNew->exteriorRing(), points, z, polyline );
 
     std::unique_ptr<p2t::CDT> cdt( new p2t::CDT( polyline ) );
 
@@ -460,10 +479,9 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
       std::vector<p2t::Point *> holePolyline;
       const QgsCurve *hole = polygonNew->interiorRing( i );
 
-      _ringToPoly2tri( hole, holePolyline, z );
+      _ringToPoly2tri( hole, points, z, holePolyline );
 
       cdt->AddHole( holePolyline );
-      polylinesToDelete << holePolyline;
     }
 
     // run triangulation and write vertices to the output data array
@@ -479,7 +497,7 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
         for ( int j = 0; j < 3; ++j )
         {
           p2t::Point *p = t->GetPoint( j );
-          QVector4D pt( p->x, p->y, z[p], 0 );
+          QVector4D pt( p->x, p->y, pointZ( p ), 0 );
           if ( toOldBase )
             pt = *toOldBase * pt;
           const double fx = pt.x() - mOriginX + pt0.x();
@@ -496,7 +514,7 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
           for ( int j = 2; j >= 0; --j )
           {
             p2t::Point *p = t->GetPoint( j );
-            QVector4D pt( p->x, p->y, z[p], 0 );
+            QVector4D pt( p->x, p->y, pointZ( p ), 0 );
             if ( toOldBase )
               pt = *toOldBase * pt;
             const double fx = pt.x() - mOriginX + pt0.x();
@@ -513,9 +531,6 @@ void QgsTessellator::addPolygon( const QgsPolygon &polygon, float extrusionHeigh
     {
       QgsMessageLog::logMessage( QObject::tr( "Triangulation failed. Skipping polygon…" ), QObject::tr( "3D" ) );
     }
-
-    for ( int i = 0; i < polylinesToDelete.count(); ++i )
-      qDeleteAll( polylinesToDelete[i] );
   }
 
   // add walls if extrusion is enabled
@@ -0,0 +1,73 @@
+/***************************************************************************
+                         qgstextoutlinecache.cpp
+                         -----------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstextoutlinecache.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+
+QMutex QgsTextOutlineCache::sMutex;
+QCache< QString, QPainterPath > QgsTextOutlineCache::sCache( QgsTextOutlineCache::MAXIMUM_ELEMENT_COUNT );
+
+QPainterPath QgsTextOutlineCache::textPath( const QFont &font, const QString &text )
+{
+  const QString key = cacheKey( font, text );
+  {
+    QMutexLocker locker( &sMutex );
+    if ( const QPainterPath *path = sCache.object( key ) )
+      return detachedCopy( *path );
+  }
+
+  // shape the text outside of the lock, a concurrent insertion of the same key is harmless
+  QPainterPath path;
+  path.setFillRule( Qt::WindingFill );
+  path.addText( 0, 0, font, text );
+
+  QMutexLocker locker( &sMutex );
+  sCache.insert( key, new QPainterPath( path ), std::max( 1, path.elementCount() ) );
+  return detachedCopy( path );
+}
+
+QPainterPath QgsTextOutlineCache::detachedCopy( const QPainterPath &path )
+{
+  // painter paths compute their bounds and vector paths lazily in their shared data, which
+  // is not thread safe: callers get their own elements instead of sharing the cached ones
+  QPainterPath copy;
+  copy.setFillRule( path.fillRule() );
+  copy.addPath( path );
+  return copy;
+}
+
+void QgsTextOutlineCache::clear()
+{
+  QMutexLocker locker( &sMutex );
+  sCache.clear();
+}
+
+int QgsTextOutlineCache::count()
+{
+  QMutexLocker locker( &sMutex );
+  return sCache.count();
+}
+
+QString QgsTextOutlineCache::cacheKey( const QFont &font, const QString &text )
+{
+  // QFont::key() does not cover the spacing and capitalization properties, which affect the shaping
+  return QStringLiteral( "%1|%2|%3|%4|%5|%6|%7|%8|%9" ).arg( font.key() )
+         .arg( font.letterSpacingType() ).arg( font.letterSpacing() ).arg( font.wordSpacing() )
+         .arg( font.capitalization() ).arg( font.kerning() ).arg( font.stretch() ).arg( font.hintingPreference() )
+         .arg( text );
+}
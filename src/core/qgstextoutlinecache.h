@@ -0,0 +1,81 @@
+/***************************************************************************
+                         qgstextoutlinecache.h
+                         ---------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSTEXTOUTLINECACHE_H
+#define QGSTEXTOUTLINECACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+
+#include <QCache>
+#include <QFont>
+#include <QMutex>
+#include <QPainterPath>
+#include <QString>
+
+/**
+ * \ingroup core
+ * \class QgsTextOutlineCache
+ * \brief Process wide cache of the outlines of shaped text strings.
+ *
+ * Drawing text as a path (e.g. for label buffers and shadows, or font markers) requires
+ * Qt to shape the string and to build the outlines of its glyphs each time. As the same
+ * strings are usually drawn many times with the same font, over labels, layers and
+ * render jobs, the resulting outlines are cached here, keyed by the font and the text.
+ *
+ * The cache is thread safe and its size is bounded by the total number of path elements.
+ * The returned outlines do not share their data with the cached ones, so that they can
+ * be used freely by concurrent render jobs.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.6
+ */
+class CORE_EXPORT QgsTextOutlineCache
+{
+  public:
+
+    /**
+     * Returns the outline of \a text drawn with \a font, with the left end of the
+     * baseline at the origin. The result is identical to the one of QPainterPath::addText().
+     */
+    static QPainterPath textPath( const QFont &font, const QString &text );
+
+    /**
+     * Removes all outlines from the cache.
+     */
+    static void clear();
+
+    /**
+     * Returns the number of outlines in the cache.
+     */
+    static int count();
+
+  private:
+
+    //! Maximum total number of path elements of the cached outlines
+    static const int MAXIMUM_ELEMENT_COUNT = 1000000;
+
+    static QString cacheKey( const QFont &font, const QString &text );
+
+    //! Returns a copy of \a path which does not share its data with \a path
+    static QPainterPath detachedCopy( const QPainterPath &path );
+
+    static QMutex sMutex;
+    static QCache< QString, QPainterPath > sCache;
+};
+
+#endif // QGSTEXTOUTLINECACHE_H
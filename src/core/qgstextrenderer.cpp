@@ -17,6 +17,7 @@
 #include "qgstextrenderer.h"
 #include "qgis.h"
 #include "qgstextrenderer_p.h"
+#include "qgstextoutlinecache.h"
 #include "qgsfontutils.h"
 #include "qgspathresolver.h"
 #include "qgsreadwritecontext.h"
@@ -1884,9 +1885,7 @@ void QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRender
 
   double penSize = context.convertToPainterUnits( buffer.size(), buffer.sizeUnit(), buffer.sizeMapUnitScale() );
 
-  QPainterPath path;
-  path.setFillRule( Qt::WindingFill );
-  path.addText( 0, 0, format.scaledFont( context ), component.text );
+  QPainterPath path = QgsTextOutlineCache::textPath( format.scaledFont( context ), component.text );
   QColor bufferColor = buffer.color();
   bufferColor.setAlphaF( buffer.opacity() );
   QPen pen( bufferColor );
@@ -2623,9 +2622,7 @@ void QgsTextRenderer::drawTextInternal( TextPart drawType,
     else
     {
       // draw text, QPainterPath method
-      QPainterPath path;
-      path.setFillRule( Qt::WindingFill );
-      path.addText( 0, 0, format.scaledFont( context ), subComponent.text );
+      QPainterPath path = QgsTextOutlineCache::textPath( format.scaledFont( context ), subComponent.text );
 
       // store text's drawing in QPicture for drop shadow call
       QPicture textPict;
@@ -42,6 +42,9 @@
 #include <QTextStream>
 #include <QSet>
 #include <QMetaType>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 
 #include <cassert>
 #include <cstdlib> // size_t
@@ -2109,7 +2112,20 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
   QgsLocaleNumC l; // Make sure the decimal delimiter is a dot
   Q_UNUSED( l );
 
-  gdal::ogr_feature_unique_ptr poFeature( OGR_F_Create( OGR_L_GetLayerDefn( mLayer ) ) );
+  QString errorMessage;
+  gdal::ogr_feature_unique_ptr poFeature = convertFeature( feature, OGR_L_GetLayerDefn( mLayer ), errorMessage );
+  if ( !poFeature )
+  {
+    mErrorMessage = errorMessage;
+    mError = ErrFeatureWriteFailed;
+    QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+  }
+  return poFeature;
+}
+
+gdal::ogr_feature_unique_ptr QgsVectorFileWriter::convertFeature( const QgsFeature &feature, OGRFeatureDefnH featureDefinition, QString &errorMessage )
+{
+  gdal::ogr_feature_unique_ptr poFeature( OGR_F_Create( featureDefinition ) );
 
   qint64 fid = FID_TO_NUMBER( feature.id() );
   if ( fid > std::numeric_limits<int>::max() )
@@ -2222,13 +2238,11 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
       case QVariant::Invalid:
         break;
       default:
-        mErrorMessage = QObject::tr( "Invalid variant type for field %1[%2]: received %3 with type %4" )
-                        .arg( mFields.at( fldIdx ).name() )
-                        .arg( ogrField )
-                        .arg( attrValue.typeName(),
-                              attrValue.toString() );
-        QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
-        mError = ErrFeatureWriteFailed;
+        errorMessage = QObject::tr( "Invalid variant type for field %1[%2]: received %3 with type %4" )
+                       .arg( mFields.at( fldIdx ).name() )
+                       .arg( ogrField )
+                       .arg( attrValue.typeName(),
+                             attrValue.toString() );
         return nullptr;
     }
   }
@@ -2295,10 +2309,8 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
 
         if ( !mGeom2 )
         {
-          mErrorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
-                          .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
-          mError = ErrFeatureWriteFailed;
-          QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+          errorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
+                         .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           return nullptr;
         }
 
@@ -2306,10 +2318,8 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
         OGRErr err = OGR_G_ImportFromWkb( mGeom2, reinterpret_cast<unsigned char *>( const_cast<char *>( wkb.constData() ) ), wkb.length() );
         if ( err != OGRERR_NONE )
         {
-          mErrorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
-                          .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
-          mError = ErrFeatureWriteFailed;
-          QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+          errorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
+                         .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           return nullptr;
         }
 
@@ -2323,10 +2333,8 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
         OGRErr err = OGR_G_ImportFromWkb( ogrGeom, reinterpret_cast<unsigned char *>( const_cast<char *>( wkb.constData() ) ), wkb.length() );
         if ( err != OGRERR_NONE )
         {
-          mErrorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
-                          .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
-          mError = ErrFeatureWriteFailed;
-          QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+          errorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
+                         .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           return nullptr;
         }
 
@@ -2342,6 +2350,147 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
   return poFeature;
 }
 
+QgsVectorFileWriter::WriterError QgsVectorFileWriter::writeFeaturesPipelined( PreparedWriterDetails &details, const QgsVectorFileWriter::SaveVectorOptions &options,
+    int &lastProgressReport, int &written, int &errors, QString *errorMessage )
+{
+  QgsLocaleNumC l; // Make sure the decimal delimiter is a dot, for the conversion threads too
+  Q_UNUSED( l );
+
+  struct PipelinedFeature
+  {
+    QgsFeature feature;
+    gdal::ogr_feature_unique_ptr ogrFeature;
+    QString conversionError;
+    QString transformError;
+  };
+
+  // at most two batches are alive, the one being written and the one being converted
+  const int batchSize = 1000;
+  std::vector< PipelinedFeature > batch;
+  std::vector< PipelinedFeature > writtenBatch;
+  QFuture< void > writeFuture;
+
+  const bool skipAttributes = details.attributes.empty() && options.skipAttributeCreation;
+  // the layer is only used by the writing thread, its definition is fetched here once
+  OGRFeatureDefnH featureDefinition = OGR_L_GetLayerDefn( mLayer );
+  auto convert = [this, &details, &options, featureDefinition]( PipelinedFeature & pipelined )
+  {
+    if ( details.shallTransform && pipelined.feature.hasGeometry() )
+    {
+      try
+      {
+        QgsGeometry g = pipelined.feature.geometry();
+        g.transform( options.ct );
+        pipelined.feature.setGeometry( g );
+      }
+      catch ( QgsCsException &e )
+      {
+        pipelined.transformError = QObject::tr( "Failed to transform a point while drawing a feature with ID '%1'. Writing stopped. (Exception: %2)" )
+                                   .arg( pipelined.feature.id() ).arg( e.what() );
+        return;
+      }
+    }
+    pipelined.ogrFeature = convertFeature( pipelined.feature, featureDefinition, pipelined.conversionError );
+  };
+
+  // features are written in order, up to the first one which could not be transformed
+  auto write = [this, &written, &errors, errorMessage]( std::vector< PipelinedFeature > &features )
+  {
+    for ( PipelinedFeature &pipelined : features )
+    {
+      if ( !pipelined.transformError.isEmpty() )
+        return;
+
+      bool ok = false;
+      if ( pipelined.ogrFeature )
+      {
+        ok = writeFeature( mLayer, pipelined.ogrFeature.get() );
+      }
+      else
+      {
+        mErrorMessage = pipelined.conversionError;
+        mError = ErrFeatureWriteFailed;
+        QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+      }
+
+      if ( !ok && addFeatureWriteError( mErrorMessage, errors, errorMessage ) )
+      {
+        written = -1;
+        return;
+      }
+      written++;
+    }
+  };
+
+  long total = details.featureCount;
+  long saved = 0;
+  int initialProgress = lastProgressReport;
+  QString transformError;
+  bool canceled = false;
+  bool hasMoreFeatures = true;
+  QgsFeature fet;
+  // written and errors are updated by the writing thread, and only read once it has finished
+  while ( hasMoreFeatures && transformError.isEmpty() )
+  {
+    batch.clear();
+    batch.reserve( batchSize );
+    while ( static_cast< int >( batch.size() ) < batchSize && ( hasMoreFeatures = details.sourceFeatureIterator.nextFeature( fet ) ) )
+    {
+      if ( !reportWriteProgress( options.feedback, ++saved, total, initialProgress, lastProgressReport ) )
+      {
+        canceled = true;
+        break;
+      }
+
+      if ( skipAttributes )
+      {
+        fet.initAttributes( 0 );
+      }
+
+      PipelinedFeature pipelined;
+      pipelined.feature = fet;
+      batch.push_back( std::move( pipelined ) );
+    }
+
+    if ( canceled )
+      break;
+
+    QtConcurrent::blockingMap( batch, convert );
+
+    for ( const PipelinedFeature &pipelined : batch )
+    {
+      if ( !pipelined.transformError.isEmpty() )
+      {
+        transformError = pipelined.transformError;
+        break;
+      }
+    }
+
+    // the previous batch must be written before this one, and OGR layers are used by one thread at a time
+    writeFuture.waitForFinished();
+    if ( written < 0 )
+      break;
+
+    std::swap( batch, writtenBatch );
+    writeFuture = QtConcurrent::run( [&write, &writtenBatch] { write( writtenBatch ); } );
+  }
+  writeFuture.waitForFinished();
+
+  if ( canceled )
+    return Canceled;
+
+  if ( !transformError.isEmpty() )
+  {
+    QgsLogger::warning( transformError );
+    if ( errorMessage )
+      *errorMessage = transformError;
+
+    return ErrProjection;
+  }
+
+  return NoError;
+}
+
 void QgsVectorFileWriter::resetMap( const QgsAttributeList &attributes )
 {
   QMap<int, int> omap( mAttrIdxToOgrIdx );
@@ -2610,6 +2759,47 @@ QgsVectorFileWriter::WriterError QgsVectorFileWriter::prepareWriteAsVectorFormat
   return NoError;
 }
 
+bool QgsVectorFileWriter::reportWriteProgress( QgsFeedback *feedback, long saved, long total, int initialProgress, int &lastProgressReport )
+{
+  if ( !feedback )
+    return true;
+
+  if ( feedback->isCanceled() )
+    return false;
+
+  //avoid spamming progress reports
+  int newProgress = static_cast<int>( initialProgress + ( ( 100.0 - initialProgress ) * saved ) / total );
+  if ( newProgress < 100 && newProgress != lastProgressReport )
+  {
+    lastProgressReport = newProgress;
+    feedback->setProgress( lastProgressReport );
+  }
+  return true;
+}
+
+bool QgsVectorFileWriter::addFeatureWriteError( const QString &message, int &errors, QString *errorMessage )
+{
+  if ( errorMessage && !message.isEmpty() )
+  {
+    if ( errorMessage->isEmpty() )
+    {
+      *errorMessage = QObject::tr( "Feature write errors:" );
+    }
+    *errorMessage += '\n' + message;
+  }
+  errors++;
+
+  if ( errors > 1000 )
+  {
+    if ( errorMessage )
+    {
+      *errorMessage += QObject::tr( "Stopping after %1 errors" ).arg( errors );
+    }
+    return true;
+  }
+  return false;
+}
+
 QgsVectorFileWriter::WriterError QgsVectorFileWriter::writeAsVectorFormat( PreparedWriterDetails &details, const QString &fileName, const QgsVectorFileWriter::SaveVectorOptions &options, QString *newFilename, QString *errorMessage, QString *newLayer )
 {
 
@@ -2740,81 +2930,65 @@ QgsVectorFileWriter::WriterError QgsVectorFileWriter::writeAsVectorFormat( Prepa
   // write all features
   long saved = 0;
   int initialProgress = lastProgressReport;
-  while ( details.sourceFeatureIterator.nextFeature( fet ) )
-  {
-    if ( options.feedback && options.feedback->isCanceled() )
-    {
-      return Canceled;
-    }
 
-    saved++;
-    if ( options.feedback )
+  // symbology and field value converters are evaluated on the calling thread only
+  if ( writer->symbologyExport() == NoSymbology && !options.fieldValueConverter && !details.filterRectEngine && QThread::idealThreadCount() > 1 )
+  {
+    WriterError pipelineError = writer->writeFeaturesPipelined( details, options, lastProgressReport, n, errors, errorMessage );
+    if ( pipelineError != NoError )
+      return pipelineError;
+  }
+  else
+  {
+    while ( details.sourceFeatureIterator.nextFeature( fet ) )
     {
-      //avoid spamming progress reports
-      int newProgress = static_cast<int>( initialProgress + ( ( 100.0 - initialProgress ) * saved ) / total );
-      if ( newProgress < 100 && newProgress != lastProgressReport )
+      if ( !reportWriteProgress( options.feedback, ++saved, total, initialProgress, lastProgressReport ) )
       {
-        lastProgressReport = newProgress;
-        options.feedback->setProgress( lastProgressReport );
+        return Canceled;
       }
-    }
 
-    if ( details.shallTransform )
-    {
-      try
+      if ( details.shallTransform )
       {
-        if ( fet.hasGeometry() )
+        try
         {
-          QgsGeometry g = fet.geometry();
-          g.transform( options.ct );
-          fet.setGeometry( g );
+          if ( fet.hasGeometry() )
+          {
+            QgsGeometry g = fet.geometry();
+            g.transform( options.ct );
+            fet.setGeometry( g );
+          }
         }
-      }
-      catch ( QgsCsException &e )
-      {
-        QString msg = QObject::tr( "Failed to transform a point while drawing a feature with ID '%1'. Writing stopped. (Exception: %2)" )
-                      .arg( fet.id() ).arg( e.what() );
-        QgsLogger::warning( msg );
-        if ( errorMessage )
-          *errorMessage = msg;
+        catch ( QgsCsException &e )
+        {
+          QString msg = QObject::tr( "Failed to transform a point while drawing a feature with ID '%1'. Writing stopped. (Exception: %2)" )
+                        .arg( fet.id() ).arg( e.what() );
+          QgsLogger::warning( msg );
+          if ( errorMessage )
+            *errorMessage = msg;
 
-        return ErrProjection;
+          return ErrProjection;
+        }
       }
-    }
-
-    if ( fet.hasGeometry() && details.filterRectEngine && !details.filterRectEngine->intersects( fet.geometry().constGet() ) )
-      continue;
 
-    if ( details.attributes.empty() && options.skipAttributeCreation )
-    {
-      fet.initAttributes( 0 );
-    }
+      if ( fet.hasGeometry() && details.filterRectEngine && !details.filterRectEngine->intersects( fet.geometry().constGet() ) )
+        continue;
 
-    if ( !writer->addFeatureWithStyle( fet, writer->mRenderer.get(), mapUnits ) )
-    {
-      WriterError err = writer->hasError();
-      if ( err != NoError && errorMessage )
+      if ( details.attributes.empty() && options.skipAttributeCreation )
       {
-        if ( errorMessage->isEmpty() )
-        {
-          *errorMessage = QObject::tr( "Feature write errors:" );
-        }
-        *errorMessage += '\n' + writer->errorMessage();
+        fet.initAttributes( 0 );
       }
-      errors++;
 
-      if ( errors > 1000 )
+      if ( !writer->addFeatureWithStyle( fet, writer->mRenderer.get(), mapUnits ) )
       {
-        if ( errorMessage )
+        const QString error = writer->hasError() != NoError ? writer->errorMessage() : QString();
+        if ( addFeatureWriteError( error, errors, errorMessage ) )
         {
-          *errorMessage += QObject::tr( "Stopping after %1 errors" ).arg( errors );
+          n = -1;
+          break;
         }
-
-        n = -1;
-        break;
       }
+      n++;
     }
-    n++;
   }
 
   writer->stopRender();
@@ -891,8 +891,38 @@ class CORE_EXPORT QgsVectorFileWriter : public QgsFeatureSink
 
     void createSymbolLayerTable( QgsVectorLayer *vl, const QgsCoordinateTransform &ct, OGRDataSourceH ds );
     gdal::ogr_feature_unique_ptr createFeature( const QgsFeature &feature );
+
+    /**
+     * Converts \a feature to an OGR feature of the \a featureDefinition of the output layer,
+     * or returns nullptr and sets \a errorMessage if it cannot be converted. Contrary to
+     * createFeature(), the writer state is not modified, the output layer is not accessed
+     * and the locale is not changed, so that features can be converted concurrently.
+     */
+    gdal::ogr_feature_unique_ptr convertFeature( const QgsFeature &feature, OGRFeatureDefnH featureDefinition, QString &errorMessage );
     bool writeFeature( OGRLayerH layer, OGRFeatureH feature );
 
+    /**
+     * Writes the features of \a details without symbology in a pipeline: features are read
+     * in batches, converted to OGR features (including their reprojection) by concurrent
+     * threads, and each batch is written in a background thread while the following one
+     * is read and converted. The numbers of \a written features and of \a errors are
+     * updated like for a sequential write.
+     */
+    QgsVectorFileWriter::WriterError writeFeaturesPipelined( PreparedWriterDetails &details, const QgsVectorFileWriter::SaveVectorOptions &options,
+        int &lastProgressReport, int &written, int &errors, QString *errorMessage );
+
+    /**
+     * Reports the progress of writing the \a saved -th feature of \a total to \a feedback,
+     * starting from \a initialProgress. Returns false if the writing was canceled.
+     */
+    static bool reportWriteProgress( QgsFeedback *feedback, long saved, long total, int initialProgress, int &lastProgressReport );
+
+    /**
+     * Counts a feature which could not be written in \a errors and appends its error \a message,
+     * if any, to \a errorMessage. Returns true if the writing must stop as there are too many errors.
+     */
+    static bool addFeatureWriteError( const QString &message, int &errors, QString *errorMessage );
+
     //! Writes features considering symbol level order
     QgsVectorFileWriter::WriterError exportFeaturesSymbolLevels( const PreparedWriterDetails &details, QgsFeatureIterator &fit, const QgsCoordinateTransform &ct, QString *errorMessage = nullptr );
     double mmScaleFactor( double scale, QgsUnitTypes::RenderUnit symbolUnits, QgsUnitTypes::DistanceUnit mapUnits );
@@ -54,6 +54,7 @@
 #include "qgsfeature.h"
 #include "qgsfeaturerequest.h"
 #include "qgsfields.h"
+#include "qgsgeneralizedgeometrycache.h"
 #include "qgsgeometry.h"
 #include "qgslayermetadataformatter.h"
 #include "qgslogger.h"
@@ -171,6 +172,18 @@ QgsVectorLayer::QgsVectorLayer( const QString &vectorLayerPath,
 
   connect( this, &QgsVectorLayer::subsetStringChanged, this, &QgsMapLayer::configChanged );
 
+  // generalized geometries follow the data of the layer
+  auto invalidateGeneralizedGeometries = [ = ]
+  {
+    if ( mGeneralizedGeometryCache )
+      mGeneralizedGeometryCache->invalidate();
+  };
+  connect( this, &QgsVectorLayer::dataChanged, this, invalidateGeneralizedGeometries );
+  connect( this, &QgsVectorLayer::subsetStringChanged, this, invalidateGeneralizedGeometries );
+  connect( this, &QgsVectorLayer::editingStopped, this, invalidateGeneralizedGeometries );
+  connect( this, &QgsVectorLayer::updatedFields, this, invalidateGeneralizedGeometries );
+  connect( this, &QgsMapLayer::dataSourceChanged, this, invalidateGeneralizedGeometries );
+
   // Default simplify drawing settings
   QgsSettings settings;
   mSimplifyMethod.setSimplifyHints( settings.flagValue( QStringLiteral( "qgis/simplifyDrawingHints" ), mSimplifyMethod.simplifyHints(), QgsSettings::NoSection ) );
@@ -188,7 +201,7 @@ QgsVectorLayer::~QgsVectorLayer()
 
   mValid = false;
 
-  delete mDataProvider;
+  delete mDataProvider.loadedProvider();
   delete mEditBuffer;
   delete mJoinBuffer;
   delete mExpressionFieldBuffer;
@@ -248,6 +261,7 @@ QgsVectorLayer *QgsVectorLayer::clone() const
   layer->setLabelsEnabled( labelsEnabled() );
 
   layer->setSimplifyMethod( simplifyMethod() );
+  layer->setGeneralizedGeometryCacheEnabled( generalizedGeometryCacheEnabled() );
 
   if ( diagramRenderer() )
   {
@@ -336,6 +350,7 @@ void QgsVectorLayer::reload()
 
 QgsMapLayerRenderer *QgsVectorLayer::createMapRenderer( QgsRenderContext &rendererContext )
 {
+  ensureLoaded();
   return new QgsVectorLayerRenderer( this, rendererContext );
 }
 
@@ -866,6 +881,8 @@ QgsRectangle QgsVectorLayer::sourceExtent() const
 
 QString QgsVectorLayer::subsetString() const
 {
+  ensureLoaded();
+
   if ( !mValid || !mDataProvider )
   {
     QgsDebugMsgLevel( QStringLiteral( "invoked with invalid layer or null mDataProvider" ), 3 );
@@ -876,6 +893,8 @@ QString QgsVectorLayer::subsetString() const
 
 bool QgsVectorLayer::setSubsetString( const QString &subset )
 {
+  ensureLoaded();
+
   if ( !mValid || !mDataProvider )
   {
     QgsDebugMsgLevel( QStringLiteral( "invoked with invalid layer or null mDataProvider" ), 3 );
@@ -913,6 +932,30 @@ bool QgsVectorLayer::simplifyDrawingCanbeApplied( const QgsRenderContext &render
   return false;
 }
 
+void QgsVectorLayer::setGeneralizedGeometryCacheEnabled( bool enabled )
+{
+  if ( enabled == generalizedGeometryCacheEnabled() )
+    return;
+
+  if ( !enabled )
+  {
+    mGeneralizedGeometryCache.reset();
+    return;
+  }
+
+  mGeneralizedGeometryCache = qgis::make_unique< QgsGeneralizedGeometryCache >( this );
+}
+
+bool QgsVectorLayer::generalizedGeometryCacheEnabled() const
+{
+  return static_cast< bool >( mGeneralizedGeometryCache );
+}
+
+QgsGeneralizedGeometryCache *QgsVectorLayer::generalizedGeometryCache() const
+{
+  return mGeneralizedGeometryCache.get();
+}
+
 QgsConditionalLayerStyles *QgsVectorLayer::conditionalStyles() const
 {
   return mConditionalStyles;
@@ -920,6 +963,8 @@ QgsConditionalLayerStyles *QgsVectorLayer::conditionalStyles() const
 
 QgsFeatureIterator QgsVectorLayer::getFeatures( const QgsFeatureRequest &request ) const
 {
+  ensureLoaded();
+
   if ( !mValid || !mDataProvider )
     return QgsFeatureIterator();
 
@@ -1476,6 +1521,28 @@ bool QgsVectorLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &c
 
 } // void QgsVectorLayer::readXml
 
+bool QgsVectorLayer::readDeferredXml( const QDomNode &layerNode, QgsReadWriteContext &context )
+{
+  mProviderKey = layerNode.namedItem( QStringLiteral( "provider" ) ).toElement().text();
+
+  // the WKB type is only stored by recent project files
+  const QString wkbTypeString = layerNode.toElement().attribute( QStringLiteral( "wkbType" ) );
+  if ( !wkbTypeString.isEmpty() )
+    mWkbType = QgsWkbTypes::parseType( wkbTypeString );
+
+  if ( !QgsMapLayer::readDeferredXml( layerNode, context ) )
+    return false;
+
+  QgsMapLayerLegend *legend = QgsMapLayerLegend::defaultVectorLegend( this );
+  QDomElement legendElem = layerNode.firstChildElement( QStringLiteral( "legend" ) );
+  if ( !legendElem.isNull() )
+    legend->readXml( legendElem, context );
+  setLegend( legend );
+
+  mValidExtent = !mExtent.isNull();
+  return true;
+}
+
 
 void QgsVectorLayer::setDataSource( const QString &dataSource, const QString &baseName, const QString &provider, bool loadDefaultStyleFlag )
 {
@@ -1585,7 +1652,7 @@ bool QgsVectorLayer::setDataProvider( QString const &provider, const QgsDataProv
   }
 
   delete mDataProvider;
-  mDataProvider = qobject_cast<QgsVectorDataProvider *>( QgsProviderRegistry::instance()->createProvider( provider, dataSource, options ) );
+  mDataProvider = qobject_cast<QgsVectorDataProvider *>( createDataProvider( provider, dataSource, options ) );
   if ( !mDataProvider )
   {
     mValid = false;
@@ -1699,6 +1766,7 @@ bool QgsVectorLayer::writeXml( QDomNode &layer_node,
 
   // set the geometry type
   mapLayerNode.setAttribute( QStringLiteral( "geometry" ), QgsWkbTypes::geometryDisplayString( geometryType() ) );
+  mapLayerNode.setAttribute( QStringLiteral( "wkbType" ), QgsWkbTypes::displayString( wkbType() ) );
 
   // add provider node
   if ( mDataProvider )
@@ -2199,6 +2267,7 @@ bool QgsVectorLayer::readStyle( const QDomNode &node, QString &errorMessage,
       mSimplifyMethod.setThreshold( e.attribute( QStringLiteral( "simplifyDrawingTol" ), QStringLiteral( "1" ) ).toFloat() );
       mSimplifyMethod.setForceLocalOptimization( e.attribute( QStringLiteral( "simplifyLocal" ), QStringLiteral( "1" ) ).toInt() );
       mSimplifyMethod.setMaximumScale( e.attribute( QStringLiteral( "simplifyMaxScale" ), QStringLiteral( "1" ) ).toFloat() );
+      setGeneralizedGeometryCacheEnabled( e.attribute( QStringLiteral( "generalizedGeometryCache" ), QStringLiteral( "0" ) ).toInt() );
     }
 
     //diagram renderer and diagram layer settings
@@ -2480,6 +2549,7 @@ bool QgsVectorLayer::writeStyle( QDomNode &node, QDomDocument &doc, QString &err
       mapLayerNode.setAttribute( QStringLiteral( "simplifyDrawingTol" ), QString::number( mSimplifyMethod.threshold() ) );
       mapLayerNode.setAttribute( QStringLiteral( "simplifyLocal" ), mSimplifyMethod.forceLocalOptimization() ? 1 : 0 );
       mapLayerNode.setAttribute( QStringLiteral( "simplifyMaxScale" ), QString::number( mSimplifyMethod.maximumScale() ) );
+      mapLayerNode.setAttribute( QStringLiteral( "generalizedGeometryCache" ), generalizedGeometryCacheEnabled() ? 1 : 0 );
     }
 
     //save customproperties
@@ -2870,6 +2940,7 @@ bool QgsVectorLayer::deleteFeatures( const QgsFeatureIds &fids )
 
 QgsFields QgsVectorLayer::fields() const
 {
+  ensureLoaded();
   return mFields;
 }
 
@@ -2890,6 +2961,9 @@ QgsAttributeList QgsVectorLayer::primaryKeyAttributes() const
 
 long QgsVectorLayer::featureCount() const
 {
+  if ( !mDataProvider )
+    return -1;
+
   return mDataProvider->featureCount() +
          ( mEditBuffer ? mEditBuffer->mAddedFeatures.size() - mEditBuffer->mDeletedFeatureIds.size() : 0 );
 }
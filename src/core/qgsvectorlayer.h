@@ -73,6 +73,7 @@ class QgsFeedback;
 class QgsAuxiliaryStorage;
 class QgsAuxiliaryLayer;
 class QgsGeometryOptions;
+class QgsGeneralizedGeometryCache;
 
 typedef QList<int> QgsAttributeList;
 typedef QSet<int> QgsAttributeIds;
@@ -773,6 +774,15 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
      */
     bool readXml( const QDomNode &layer_node, QgsReadWriteContext &context ) FINAL;
 
+    /**
+     * Reads the provider key, the WKB type, the extent, the styles, the legend and the
+     * custom properties of the layer from project file Dom node, when the loading of the
+     * layer is deferred.
+     * \note Called by QgsMapLayer::readLayerXml().
+     * \since QGIS 3.6
+     */
+    bool readDeferredXml( const QDomNode &layerNode, QgsReadWriteContext &context ) FINAL;
+
     /**
      * Write vector layer specific state to project file Dom node.
      * \note Called by QgsMapLayer::writeXml().
@@ -1930,6 +1940,36 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
      */
     bool simplifyDrawingCanbeApplied( const QgsRenderContext &renderContext, QgsVectorSimplifyMethod::SimplifyHint simplifyHint ) const;
 
+    /**
+     * Sets whether rendering at small scales may use pre-generalized geometries.
+     *
+     * When enabled, levels of generalization of the layer geometries are built in the background
+     * and kept in memory, and the renderer reads features from the coarsest level which still
+     * fits the simplification tolerance of the map instead of fetching them from the data provider.
+     * This speeds up redraws of large line and polygon layers when zoomed out, at the cost of memory.
+     * The levels are only used while the layer is not in edit mode, and they are rebuilt after
+     * changes to the layer data.
+     *
+     * \see generalizedGeometryCacheEnabled()
+     * \since QGIS 3.6
+     */
+    void setGeneralizedGeometryCacheEnabled( bool enabled );
+
+    /**
+     * Returns true if rendering at small scales may use pre-generalized geometries.
+     * \see setGeneralizedGeometryCacheEnabled()
+     * \since QGIS 3.6
+     */
+    bool generalizedGeometryCacheEnabled() const;
+
+    /**
+     * Returns the cache of generalized geometries, or nullptr if it is not enabled.
+     * \see setGeneralizedGeometryCacheEnabled()
+     * \note not available in Python bindings
+     * \since QGIS 3.6
+     */
+    QgsGeneralizedGeometryCache *generalizedGeometryCache() const SIP_SKIP;
+
     /**
      * Returns the conditional styles that are set for this layer. Style information is
      * used to render conditional formatting in the attribute table.
@@ -2426,7 +2466,7 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
     QgsConditionalLayerStyles *mConditionalStyles = nullptr;
 
     //! Pointer to data provider derived from the abastract base class QgsDataProvider
-    QgsVectorDataProvider *mDataProvider = nullptr;
+    QgsMapLayerProviderPointer< QgsVectorDataProvider > mDataProvider{ this };
 
     //! The preview expression used to generate a human readable preview string for features
     QString mDisplayExpression;
@@ -2555,6 +2595,8 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
 
     std::unique_ptr<QgsGeometryOptions> mGeometryOptions;
 
+    std::unique_ptr<QgsGeneralizedGeometryCache> mGeneralizedGeometryCache;
+
     bool mAllowCommit = true;
 
     friend class QgsVectorLayerFeatureSource;
@@ -60,6 +60,15 @@ QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRender
   mFeatureBlendMode = layer->featureBlendMode();
   mSimplifyMethod = layer->simplifyMethod();
   mSimplifyGeometry = layer->simplifyDrawingCanbeApplied( mContext, QgsVectorSimplifyMethod::GeometrySimplification );
+  if ( mSimplifyGeometry )
+  {
+    mSimplifyToleranceValid = computeSimplifyTolerance( mSimplifyTolerance );
+
+    // the generalized geometries do not follow the edit buffer, and simplifyDrawingCanbeApplied()
+    // is false for edited layers anyway
+    if ( mSimplifyToleranceValid && layer->generalizedGeometryCache() )
+      mGeneralizedLevel = layer->generalizedGeometryCache()->level( mSimplifyTolerance );
+  }
 
   QgsSettings settings;
   mVertexMarkerOnlyForSelection = settings.value( QStringLiteral( "qgis/digitizing/marker_only_for_selected" ), true ).toBool();
@@ -118,15 +127,18 @@ bool QgsVectorLayerRenderer::render()
     return false;
   }
 
+  // when only registering labels, nothing is drawn and there may be no painter at all
+  const bool skipSymbols = mContext.flags() & QgsRenderContext::SkipSymbolRendering;
+
   bool usingEffect = false;
-  if ( mRenderer->paintEffect() && mRenderer->paintEffect()->enabled() )
+  if ( !skipSymbols && mRenderer->paintEffect() && mRenderer->paintEffect()->enabled() )
   {
     usingEffect = true;
     mRenderer->paintEffect()->begin( mContext );
   }
 
   // Per feature blending mode
-  if ( mContext.useAdvancedEffects() && mFeatureBlendMode != QPainter::CompositionMode_SourceOver )
+  if ( !skipSymbols && mContext.useAdvancedEffects() && mFeatureBlendMode != QPainter::CompositionMode_SourceOver )
   {
     // set the painter to the feature blend mode, so that features drawn
     // on this layer will interact and blend with each other
@@ -162,62 +174,17 @@ bool QgsVectorLayerRenderer::render()
   // enable the simplification of the geometries (Using the current map2pixel context) before send it to renderer engine.
   if ( mSimplifyGeometry )
   {
-    double map2pixelTol = mSimplifyMethod.threshold();
-    bool validTransform = true;
-
-    const QgsMapToPixel &mtp = mContext.mapToPixel();
-    map2pixelTol *= mtp.mapUnitsPerPixel();
-    QgsCoordinateTransform ct = mContext.coordinateTransform();
-
-    // resize the tolerance using the change of size of an 1-BBOX from the source CoordinateSystem to the target CoordinateSystem
-    if ( ct.isValid() && !ct.isShortCircuited() )
-    {
-      try
-      {
-        QgsPointXY center = mContext.extent().center();
-        double rectSize = ct.sourceCrs().isGeographic() ? 0.0008983 /* ~100/(40075014/360=111319.4833) */ : 100;
-
-        QgsRectangle sourceRect = QgsRectangle( center.x(), center.y(), center.x() + rectSize, center.y() + rectSize );
-        QgsRectangle targetRect = ct.transform( sourceRect );
-
-        QgsDebugMsgLevel( QStringLiteral( "Simplify - SourceTransformRect=%1" ).arg( sourceRect.toString( 16 ) ), 4 );
-        QgsDebugMsgLevel( QStringLiteral( "Simplify - TargetTransformRect=%1" ).arg( targetRect.toString( 16 ) ), 4 );
-
-        if ( !sourceRect.isEmpty() && sourceRect.isFinite() && !targetRect.isEmpty() && targetRect.isFinite() )
-        {
-          QgsPointXY minimumSrcPoint( sourceRect.xMinimum(), sourceRect.yMinimum() );
-          QgsPointXY maximumSrcPoint( sourceRect.xMaximum(), sourceRect.yMaximum() );
-          QgsPointXY minimumDstPoint( targetRect.xMinimum(), targetRect.yMinimum() );
-          QgsPointXY maximumDstPoint( targetRect.xMaximum(), targetRect.yMaximum() );
-
-          double sourceHypothenuse = std::sqrt( minimumSrcPoint.sqrDist( maximumSrcPoint ) );
-          double targetHypothenuse = std::sqrt( minimumDstPoint.sqrDist( maximumDstPoint ) );
-
-          QgsDebugMsgLevel( QStringLiteral( "Simplify - SourceHypothenuse=%1" ).arg( sourceHypothenuse ), 4 );
-          QgsDebugMsgLevel( QStringLiteral( "Simplify - TargetHypothenuse=%1" ).arg( targetHypothenuse ), 4 );
-
-          if ( !qgsDoubleNear( targetHypothenuse, 0.0 ) )
-            map2pixelTol *= ( sourceHypothenuse / targetHypothenuse );
-        }
-      }
-      catch ( QgsCsException &cse )
-      {
-        QgsMessageLog::logMessage( QObject::tr( "Simplify transform error caught: %1" ).arg( cse.what() ), QObject::tr( "CRS" ) );
-        validTransform = false;
-      }
-    }
-
-    if ( validTransform )
+    if ( mSimplifyToleranceValid )
     {
       QgsSimplifyMethod simplifyMethod;
       simplifyMethod.setMethodType( QgsSimplifyMethod::OptimizeForRendering );
-      simplifyMethod.setTolerance( map2pixelTol );
+      simplifyMethod.setTolerance( mSimplifyTolerance );
       simplifyMethod.setThreshold( mSimplifyMethod.threshold() );
       simplifyMethod.setForceLocalOptimization( mSimplifyMethod.forceLocalOptimization() );
       featureRequest.setSimplifyMethod( simplifyMethod );
 
       QgsVectorSimplifyMethod vectorMethod = mSimplifyMethod;
-      vectorMethod.setTolerance( map2pixelTol );
+      vectorMethod.setTolerance( mSimplifyTolerance );
       mContext.setVectorSimplifyMethod( vectorMethod );
     }
     else
@@ -234,7 +201,9 @@ bool QgsVectorLayerRenderer::render()
     mContext.setVectorSimplifyMethod( vectorMethod );
   }
 
-  QgsFeatureIterator fit = mSource->getFeatures( featureRequest );
+  // at small scales, read the features from the generalized geometry cache of the layer
+  QgsFeatureIterator fit = mGeneralizedLevel ? QgsGeneralizedGeometryCache::getFeatures( mGeneralizedLevel, featureRequest )
+                           : mSource->getFeatures( featureRequest );
   // Attach an interruption checker so that iterators that have potentially
   // slow fetchFeature() implementations, such as in the WFS provider, can
   // check it, instead of relying on just the mContext.renderingStopped() check
@@ -255,6 +224,56 @@ bool QgsVectorLayerRenderer::render()
 }
 
 
+bool QgsVectorLayerRenderer::computeSimplifyTolerance( double &tolerance ) const
+{
+  double map2pixelTol = mSimplifyMethod.threshold();
+
+  const QgsMapToPixel &mtp = mContext.mapToPixel();
+  map2pixelTol *= mtp.mapUnitsPerPixel();
+  QgsCoordinateTransform ct = mContext.coordinateTransform();
+
+  // resize the tolerance using the change of size of an 1-BBOX from the source CoordinateSystem to the target CoordinateSystem
+  if ( ct.isValid() && !ct.isShortCircuited() )
+  {
+    try
+    {
+      QgsPointXY center = mContext.extent().center();
+      double rectSize = ct.sourceCrs().isGeographic() ? 0.0008983 /* ~100/(40075014/360=111319.4833) */ : 100;
+
+      QgsRectangle sourceRect = QgsRectangle( center.x(), center.y(), center.x() + rectSize, center.y() + rectSize );
+      QgsRectangle targetRect = ct.transform( sourceRect );
+
+      QgsDebugMsgLevel( QStringLiteral( "Simplify - SourceTransformRect=%1" ).arg( sourceRect.toString( 16 ) ), 4 );
+      QgsDebugMsgLevel( QStringLiteral( "Simplify - TargetTransformRect=%1" ).arg( targetRect.toString( 16 ) ), 4 );
+
+      if ( !sourceRect.isEmpty() && sourceRect.isFinite() && !targetRect.isEmpty() && targetRect.isFinite() )
+      {
+        QgsPointXY minimumSrcPoint( sourceRect.xMinimum(), sourceRect.yMinimum() );
+        QgsPointXY maximumSrcPoint( sourceRect.xMaximum(), sourceRect.yMaximum() );
+        QgsPointXY minimumDstPoint( targetRect.xMinimum(), targetRect.yMinimum() );
+        QgsPointXY maximumDstPoint( targetRect.xMaximum(), targetRect.yMaximum() );
+
+        double sourceHypothenuse = std::sqrt( minimumSrcPoint.sqrDist( maximumSrcPoint ) );
+        double targetHypothenuse = std::sqrt( minimumDstPoint.sqrDist( maximumDstPoint ) );
+
+        QgsDebugMsgLevel( QStringLiteral( "Simplify - SourceHypothenuse=%1" ).arg( sourceHypothenuse ), 4 );
+        QgsDebugMsgLevel( QStringLiteral( "Simplify - TargetHypothenuse=%1" ).arg( targetHypothenuse ), 4 );
+
+        if ( !qgsDoubleNear( targetHypothenuse, 0.0 ) )
+          map2pixelTol *= ( sourceHypothenuse / targetHypothenuse );
+      }
+    }
+    catch ( QgsCsException &cse )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Simplify transform error caught: %1" ).arg( cse.what() ), QObject::tr( "CRS" ) );
+      return false;
+    }
+  }
+
+  tolerance = map2pixelTol;
+  return true;
+}
+
 void QgsVectorLayerRenderer::drawRenderer( QgsFeatureIterator &fit )
 {
   QgsExpressionContextScope *symbolScope = QgsExpressionContextUtils::updateSymbolScope( nullptr, new QgsExpressionContextScope() );
@@ -280,7 +299,11 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureIterator &fit )
       bool drawMarker = ( mDrawVertexMarkers && mContext.drawEditingInformation() && ( !mVertexMarkerOnlyForSelection || sel ) );
 
       // render feature
-      bool rendered = mRenderer->renderFeature( fet, mContext, -1, sel, drawMarker );
+      bool rendered = false;
+      if ( mContext.flags() & QgsRenderContext::SkipSymbolRendering )
+        rendered = mRenderer->willRenderFeature( fet, mContext );
+      else
+        rendered = mRenderer->renderFeature( fet, mContext, -1, sel, drawMarker );
 
       // labeling - register feature
       if ( rendered )
@@ -398,7 +421,7 @@ void QgsVectorLayerRenderer::drawRendererLevels( QgsFeatureIterator &fit )
 
   delete mContext.expressionContext().popScope();
 
-  if ( features.empty() )
+  if ( features.empty() || ( mContext.flags() & QgsRenderContext::SkipSymbolRendering ) )
   {
     // nothing to draw
     stopRenderer( selRenderer );
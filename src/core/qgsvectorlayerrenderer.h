@@ -40,6 +40,7 @@ typedef QList<int> QgsAttributeList;
 #include "qgsvectorsimplifymethod.h"
 #include "qgsfeedback.h"
 #include "qgsfeatureid.h"
+#include "qgsgeneralizedgeometrycache.h"
 
 #include "qgsmaplayerrenderer.h"
 
@@ -102,6 +103,12 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
     //! Stop version 2 renderer and selected renderer (if required)
     void stopRenderer( QgsSingleSymbolRenderer *selRenderer );
 
+    /**
+     * Computes the simplification tolerance of the map in layer units.
+     * Returns false if the tolerance cannot be computed because of a transform error.
+     */
+    bool computeSimplifyTolerance( double &tolerance ) const;
+
 
   protected:
 
@@ -149,6 +156,13 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
 
     QgsVectorSimplifyMethod mSimplifyMethod;
     bool mSimplifyGeometry;
+
+    //! Simplification tolerance in layer units, only valid if mSimplifyToleranceValid is true
+    double mSimplifyTolerance = 0;
+    bool mSimplifyToleranceValid = false;
+
+    //! Pre-generalized features used instead of the layer features, may be null
+    std::shared_ptr< const QgsGeneralizedGeometryCache::Level > mGeneralizedLevel;
 };
 
 
@@ -242,6 +242,7 @@ void QgsRasterLayer::reload()
 
 QgsMapLayerRenderer *QgsRasterLayer::createMapRenderer( QgsRenderContext &rendererContext )
 {
+  ensureLoaded();
   return new QgsRasterLayerRenderer( this, rendererContext );
 }
 
@@ -432,7 +433,7 @@ QString QgsRasterLayer::htmlMetadata() const
   myMetadata += QLatin1String( "</table>\n<br><table width=\"100%\" class=\"tabular-view\">\n" );
   myMetadata += QLatin1String( "<tr><th>" ) + tr( "Number" ) + QLatin1String( "</th><th>" ) + tr( "Band" ) + QLatin1String( "</th><th>" ) + tr( "No-Data" ) + QLatin1String( "</th><th>" ) + tr( "Min" ) + QLatin1String( "</th><th>" ) + tr( "Max" ) + QLatin1String( "</th></tr>\n" );
 
-  QgsRasterDataProvider *provider = const_cast< QgsRasterDataProvider * >( mDataProvider );
+  QgsRasterDataProvider *provider = mDataProvider;
   for ( int i = 1; i <= bandCount(); i++ )
   {
     QString rowClass;
@@ -598,7 +599,7 @@ void QgsRasterLayer::setDataProvider( QString const &provider, const QgsDataProv
 
   //mBandCount = 0;
 
-  mDataProvider = dynamic_cast< QgsRasterDataProvider * >( QgsProviderRegistry::instance()->createProvider( mProviderKey, mDataSource, options ) );
+  mDataProvider = dynamic_cast< QgsRasterDataProvider * >( createDataProvider( mProviderKey, mDataSource, options ) );
   if ( !mDataProvider )
   {
     //QgsMessageLog::logMessage( tr( "Cannot instantiate the data provider" ), tr( "Raster" ) );
@@ -866,7 +867,7 @@ void QgsRasterLayer::setDataSource( const QString &dataSource, const QString &ba
 void QgsRasterLayer::closeDataProvider()
 {
   mValid = false;
-  mPipe.remove( mDataProvider );
+  mPipe.remove( mDataProvider.loadedProvider() );
   mDataProvider = nullptr;
 }
 
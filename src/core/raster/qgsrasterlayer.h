@@ -460,7 +460,7 @@ class CORE_EXPORT QgsRasterLayer : public QgsMapLayer
     const QString TRSTRING_NOT_SET;
 
     //! Pointer to data provider
-    QgsRasterDataProvider *mDataProvider = nullptr;
+    QgsMapLayerProviderPointer< QgsRasterDataProvider > mDataProvider{ this };
 
     //! [ data provider interface ] Timestamp, the last modified time of the data source when the layer was created
     QDateTime mLastModified;
@@ -178,11 +178,25 @@ QgsCategorizedSymbolRenderer::QgsCategorizedSymbolRenderer( const QString &attrN
 void QgsCategorizedSymbolRenderer::rebuildHash()
 {
   mSymbolHash.clear();
+  mIntegerSymbolHash.clear();
+  mDoubleSymbolHash.clear();
 
   for ( int i = 0; i < mCategories.size(); ++i )
   {
     const QgsRendererCategory &cat = mCategories.at( i );
-    mSymbolHash.insert( cat.value().toString(), ( cat.renderState() || mCounting ) ? cat.symbol() : nullptr );
+    const QString key = cat.value().toString();
+    QgsSymbol *symbol = ( cat.renderState() || mCounting ) ? cat.symbol() : nullptr;
+    mSymbolHash.insert( key, symbol );
+
+    // numeric values only match the categories whose value is their exact string representation
+    bool ok = false;
+    const qlonglong integer = key.toLongLong( &ok );
+    if ( ok && QString::number( integer ) == key )
+      mIntegerSymbolHash.insert( integer, symbol );
+
+    const double number = key.toDouble( &ok );
+    if ( ok && number != 0 && std::isfinite( number ) && QVariant( number ).toString() == key )
+      mDoubleSymbolHash.insert( number, symbol );
   }
 }
 
@@ -201,7 +215,43 @@ QgsSymbol *QgsCategorizedSymbolRenderer::symbolForValue( const QVariant &value,
 {
   foundMatchingSymbol = false;
 
-  // TODO: special case for int, double
+  // numeric values are looked up without converting them to strings
+  if ( !value.isNull() )
+  {
+    switch ( value.type() )
+    {
+      case QVariant::Int:
+      case QVariant::UInt:
+      case QVariant::LongLong:
+      {
+        QHash<qlonglong, QgsSymbol *>::const_iterator it = mIntegerSymbolHash.constFind( value.toLongLong() );
+        if ( it == mIntegerSymbolHash.constEnd() )
+          return nullptr;
+
+        foundMatchingSymbol = true;
+        return *it;
+      }
+
+      case QVariant::Double:
+      {
+        // zero (which may be negative), infinite and NaN values use the string lookup
+        const double number = value.toDouble();
+        if ( number == 0 || !std::isfinite( number ) )
+          break;
+
+        QHash<double, QgsSymbol *>::const_iterator it = mDoubleSymbolHash.constFind( number );
+        if ( it == mDoubleSymbolHash.constEnd() )
+          return nullptr;
+
+        foundMatchingSymbol = true;
+        return *it;
+      }
+
+      default:
+        break;
+    }
+  }
+
   QHash<QString, QgsSymbol *>::const_iterator it = mSymbolHash.constFind( value.isNull() ? QString() : value.toString() );
   if ( it == mSymbolHash.constEnd() )
   {
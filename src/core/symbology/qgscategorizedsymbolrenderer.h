@@ -274,6 +274,18 @@ class CORE_EXPORT QgsCategorizedSymbolRenderer : public QgsFeatureRenderer
 
     //! hashtable for faster access to symbols
     QHash<QString, QgsSymbol *> mSymbolHash;
+
+    /**
+     * Symbols of the categories whose value is the string representation of an integer,
+     * for looking up integer values without converting them to strings.
+     */
+    QHash<qlonglong, QgsSymbol *> mIntegerSymbolHash;
+
+    /**
+     * Symbols of the categories whose value is the string representation of a non zero double,
+     * for looking up double values without converting them to strings.
+     */
+    QHash<double, QgsSymbol *> mDoubleSymbolHash;
     bool mCounting = false;
 
     void rebuildHash();
@@ -297,36 +297,101 @@ QgsGraduatedSymbolRenderer::~QgsGraduatedSymbolRenderer()
 
 QgsSymbol *QgsGraduatedSymbolRenderer::symbolForValue( double value ) const
 {
-  Q_FOREACH ( const QgsRendererRange &range, mRanges )
+  const int index = rangeIndexForValue( value );
+  if ( index < 0 )
+  {
+    // the value is out of the range: return NULL instead of symbol
+    return nullptr;
+  }
+
+  const QgsRendererRange &range = mRanges.at( index );
+  if ( range.renderState() || mCounting )
+    return range.symbol();
+  else
+    return nullptr;
+}
+
+QString QgsGraduatedSymbolRenderer::legendKeyForValue( double value ) const
+{
+  const int index = rangeIndexForValue( value );
+  if ( index < 0 )
+  {
+    // the value is out of the range: return NULL
+    return QString();
+  }
+
+  const QgsRendererRange &range = mRanges.at( index );
+  if ( range.renderState() || mCounting )
+    return QString::number( index );
+  else
+    return QString();
+}
+
+int QgsGraduatedSymbolRenderer::rangeIndexForValue( double value ) const
+{
+  if ( !mRangeLookupValid )
   {
-    if ( range.lowerValue() <= value && range.upperValue() >= value )
+    for ( int i = 0; i < mRanges.size(); ++i )
     {
-      if ( range.renderState() || mCounting )
-        return range.symbol();
-      else
-        return nullptr;
+      const QgsRendererRange &range = mRanges.at( i );
+      if ( range.lowerValue() <= value && range.upperValue() >= value )
+        return i;
     }
+    return -1;
   }
-  // the value is out of the range: return NULL instead of symbol
-  return nullptr;
+
+  // NaN values are out of all ranges, and end up before the first bound
+  const QVector<double>::const_iterator it = std::lower_bound( mRangeBounds.constBegin(), mRangeBounds.constEnd(), value );
+  const int bound = static_cast< int >( it - mRangeBounds.constBegin() );
+  if ( it != mRangeBounds.constEnd() && *it == value )
+    return mRangeAtBound.at( bound );
+  if ( bound == 0 || it == mRangeBounds.constEnd() )
+    return -1;
+  return mRangeAfterBound.at( bound - 1 );
 }
 
-QString QgsGraduatedSymbolRenderer::legendKeyForValue( double value ) const
+void QgsGraduatedSymbolRenderer::buildRangeLookup()
 {
-  int i = 0;
-  Q_FOREACH ( const QgsRendererRange &range, mRanges )
+  mRangeBounds.clear();
+  mRangeAtBound.clear();
+  mRangeAfterBound.clear();
+
+  // ranges may overlap and are not necessarily sorted: the first range containing a value wins.
+  // The bounds split the values in intervals which are entirely inside or outside each range,
+  // so the first matching range only needs to be found for each bound and each interval.
+  for ( const QgsRendererRange &range : qgis::as_const( mRanges ) )
   {
-    if ( range.lowerValue() <= value && range.upperValue() >= value )
+    if ( std::isnan( range.lowerValue() ) || std::isnan( range.upperValue() ) )
     {
-      if ( range.renderState() || mCounting )
-        return QString::number( i );
-      else
-        return QString();
+      mRangeLookupValid = false;
+      return;
     }
-    i++;
+    mRangeBounds << range.lowerValue() << range.upperValue();
   }
-  // the value is out of the range: return NULL
-  return QString();
+  std::sort( mRangeBounds.begin(), mRangeBounds.end() );
+  mRangeBounds.erase( std::unique( mRangeBounds.begin(), mRangeBounds.end() ), mRangeBounds.end() );
+
+  auto firstRangeContaining = [this]( double value )
+  {
+    for ( int i = 0; i < mRanges.size(); ++i )
+    {
+      const QgsRendererRange &range = mRanges.at( i );
+      if ( range.lowerValue() <= value && range.upperValue() >= value )
+        return i;
+    }
+    return -1;
+  };
+
+  const int boundCount = mRangeBounds.size();
+  mRangeAtBound.reserve( boundCount );
+  mRangeAfterBound.reserve( boundCount );
+  for ( int i = 0; i < boundCount; ++i )
+  {
+    mRangeAtBound << firstRangeContaining( mRangeBounds.at( i ) );
+    if ( i + 1 < boundCount )
+      mRangeAfterBound << firstRangeContaining( std::nextafter( mRangeBounds.at( i ), mRangeBounds.at( i + 1 ) ) );
+  }
+  mRangeLookupValid = true;
 }
 
 QgsSymbol *QgsGraduatedSymbolRenderer::symbolForFeature( const QgsFeature &feature, QgsRenderContext &context ) const
@@ -384,6 +449,8 @@ void QgsGraduatedSymbolRenderer::startRender( QgsRenderContext &context, const Q
 
     range.symbol()->startRender( context, fields );
   }
+
+  buildRangeLookup();
 }
 
 void QgsGraduatedSymbolRenderer::stopRender( QgsRenderContext &context )
@@ -397,6 +464,8 @@ void QgsGraduatedSymbolRenderer::stopRender( QgsRenderContext &context )
 
     range.symbol()->stopRender( context );
   }
+
+  mRangeLookupValid = false;
 }
 
 QSet<QString> QgsGraduatedSymbolRenderer::usedAttributes( const QgsRenderContext &context ) const
@@ -462,6 +531,7 @@ bool QgsGraduatedSymbolRenderer::updateRangeUpperValue( int rangeIndex, double v
   bool isDefaultLabel = range.label() == mLabelFormat.labelForRange( range );
   range.setUpperValue( value );
   if ( isDefaultLabel ) range.setLabel( mLabelFormat.labelForRange( range ) );
+  mRangeLookupValid = false;
   return true;
 }
 
@@ -473,6 +543,7 @@ bool QgsGraduatedSymbolRenderer::updateRangeLowerValue( int rangeIndex, double v
   bool isDefaultLabel = range.label() == mLabelFormat.labelForRange( range );
   range.setLowerValue( value );
   if ( isDefaultLabel ) range.setLabel( mLabelFormat.labelForRange( range ) );
+  mRangeLookupValid = false;
   return true;
 }
 
@@ -1516,6 +1587,7 @@ void QgsGraduatedSymbolRenderer::addClass( QgsSymbol *symbol )
   QgsSymbol *newSymbol = symbol->clone();
   QString label = QStringLiteral( "0.0 - 0.0" );
   mRanges.insert( 0, QgsRendererRange( 0.0, 0.0, newSymbol, label ) );
+  mRangeLookupValid = false;
 }
 
 void QgsGraduatedSymbolRenderer::addClass( double lower, double upper )
@@ -1523,6 +1595,7 @@ void QgsGraduatedSymbolRenderer::addClass( double lower, double upper )
   QgsSymbol *newSymbol = mSourceSymbol->clone();
   QString label = mLabelFormat.labelForRange( lower, upper );
   mRanges.append( QgsRendererRange( lower, upper, newSymbol, label ) );
+  mRangeLookupValid = false;
 }
 
 void QgsGraduatedSymbolRenderer::addBreak( double breakValue, bool updateSymbols )
@@ -1546,6 +1619,7 @@ void QgsGraduatedSymbolRenderer::addBreak( double breakValue, bool updateSymbols
       it.setValue( range );
 
       it.insert( newRange );
+      mRangeLookupValid = false;
       break;
     }
   }
@@ -1567,16 +1641,19 @@ void QgsGraduatedSymbolRenderer::addBreak( double breakValue, bool updateSymbols
 void QgsGraduatedSymbolRenderer::addClass( const QgsRendererRange &range )
 {
   mRanges.append( range );
+  mRangeLookupValid = false;
 }
 
 void QgsGraduatedSymbolRenderer::deleteClass( int idx )
 {
   mRanges.removeAt( idx );
+  mRangeLookupValid = false;
 }
 
 void QgsGraduatedSymbolRenderer::deleteAllClasses()
 {
   mRanges.clear();
+  mRangeLookupValid = false;
 }
 
 void QgsGraduatedSymbolRenderer::setLabelFormat( const QgsRendererRangeLabelFormat &labelFormat, bool updateRanges )
@@ -1626,6 +1703,7 @@ void QgsGraduatedSymbolRenderer::moveClass( int from, int to )
   if ( from < 0 || from >= mRanges.size() || to < 0 || to >= mRanges.size() )
     return;
   mRanges.move( from, to );
+  mRangeLookupValid = false;
 }
 
 bool valueLessThan( const QgsRendererRange &r1, const QgsRendererRange &r2 )
@@ -1648,6 +1726,7 @@ void QgsGraduatedSymbolRenderer::sortByValue( Qt::SortOrder order )
   {
     std::sort( mRanges.begin(), mRanges.end(), valueGreaterThan );
   }
+  mRangeLookupValid = false;
 }
 
 bool QgsGraduatedSymbolRenderer::rangesOverlap() const
@@ -1720,6 +1799,7 @@ void QgsGraduatedSymbolRenderer::sortByLabel( Qt::SortOrder order )
   {
     std::sort( mRanges.begin(), mRanges.end(), labelGreaterThan );
   }
+  mRangeLookupValid = false;
 }
 
 QgsGraduatedSymbolRenderer *QgsGraduatedSymbolRenderer::convertFromRenderer( const QgsFeatureRenderer *renderer )
@@ -517,6 +517,25 @@ class CORE_EXPORT QgsGraduatedSymbolRenderer : public QgsFeatureRenderer
      */
     QVariant valueForFeature( const QgsFeature &feature, QgsRenderContext &context ) const;
 
+    /**
+     * Builds the lookup table of ranges by value, used while rendering.
+     */
+    void buildRangeLookup();
+
+    /**
+     * Returns the index of the first range containing \a value, or -1 if there is none.
+     */
+    int rangeIndexForValue( double value ) const;
+
+    //! Sorted distinct bounds of the ranges, built in startRender()
+    QVector<double> mRangeBounds;
+    //! Index of the first range containing each bound, or -1
+    QVector<int> mRangeAtBound;
+    //! Index of the first range containing the values between each bound and the next one, or -1
+    QVector<int> mRangeAfterBound;
+    //! True if the lookup matches the ranges, reset by all methods changing them
+    bool mRangeLookupValid = false;
+
     //! Returns list of legend symbol items from individual ranges
     QgsLegendSymbolList baseLegendSymbolItems() const;
 
@@ -24,6 +24,7 @@
 #include "qgsrendercontext.h"
 #include "qgslogger.h"
 #include "qgssvgcache.h"
+#include "qgstextoutlinecache.h"
 #include "qgsunittypes.h"
 
 #include <QPainter>
@@ -852,6 +853,17 @@ void QgsSimpleMarkerSymbolLayer::startRender( QgsSymbolRenderContext &context )
     mCache = QImage();
     mSelCache = QImage();
   }
+
+  // markers with data defined properties are drawn from sprites, rendered once for each
+  // distinct set of evaluated properties
+  mUsingSprites = !mUsingCache && !context.renderContext().forceVectorOutput();
+  mSprites.clear();
+}
+
+void QgsSimpleMarkerSymbolLayer::stopRender( QgsSymbolRenderContext &context )
+{
+  QgsSimpleMarkerSymbolLayerBase::stopRender( context );
+  mSprites.clear();
 }
 
 
@@ -917,17 +929,8 @@ bool QgsSimpleMarkerSymbolLayer::prepareCache( QgsSymbolRenderContext &context )
   return true;
 }
 
-void QgsSimpleMarkerSymbolLayer::draw( QgsSymbolRenderContext &context, QgsSimpleMarkerSymbolLayerBase::Shape shape, const QPolygonF &polygon, const QPainterPath &path )
+void QgsSimpleMarkerSymbolLayer::updateDataDefinedPenAndBrush( QgsSymbolRenderContext &context )
 {
-  //making changes here? Don't forget to also update ::bounds if the changes affect the bounding box
-  //of the rendered point!
-
-  QPainter *p = context.renderContext().painter();
-  if ( !p )
-  {
-    return;
-  }
-
   bool ok = true;
   if ( mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyFillColor ) )
   {
@@ -976,6 +979,20 @@ void QgsSimpleMarkerSymbolLayer::draw( QgsSymbolRenderContext &context, QgsSimpl
       mSelPen.setJoinStyle( QgsSymbolLayerUtils::decodePenJoinStyle( style ) );
     }
   }
+}
+
+void QgsSimpleMarkerSymbolLayer::draw( QgsSymbolRenderContext &context, QgsSimpleMarkerSymbolLayerBase::Shape shape, const QPolygonF &polygon, const QPainterPath &path )
+{
+  //making changes here? Don't forget to also update ::bounds if the changes affect the bounding box
+  //of the rendered point!
+
+  QPainter *p = context.renderContext().painter();
+  if ( !p )
+  {
+    return;
+  }
+
+  updateDataDefinedPenAndBrush( context );
 
   if ( shapeIsFilled( shape ) )
   {
@@ -1021,12 +1038,84 @@ void QgsSimpleMarkerSymbolLayer::renderPoint( QPointF point, QgsSymbolRenderCont
                           point.y() - s / 2.0 + offset.y(),
                           s, s ), img );
   }
-  else
+  else if ( !mUsingSprites || context.selected() || !renderSprite( point, context ) )
   {
     QgsSimpleMarkerSymbolLayerBase::renderPoint( point, context );
   }
 }
 
+bool QgsSimpleMarkerSymbolLayer::renderSprite( QPointF point, QgsSymbolRenderContext &context )
+{
+  bool hasDataDefinedSize = false;
+  double scaledSize = calculateSize( context, hasDataDefinedSize );
+
+  bool hasDataDefinedRotation = false;
+  QPointF offset;
+  double angle = 0;
+  calculateOffsetAndRotation( context, scaledSize, hasDataDefinedRotation, offset, angle );
+
+  Shape shape = mShape;
+  if ( mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyName ) )
+  {
+    context.setOriginalValueVariable( encodeShape( shape ) );
+    QVariant exprVal = mDataDefinedProperties.value( QgsSymbolLayer::PropertyName, context.renderContext().expressionContext() );
+    if ( exprVal.isValid() )
+    {
+      bool ok = false;
+      Shape decoded = decodeShape( exprVal.toString(), &ok );
+      if ( ok )
+        shape = decoded;
+    }
+  }
+
+  updateDataDefinedPenAndBrush( context );
+
+  // markers differing by less than 1/8 pixel or 1/4 degree share the same sprite
+  double size = context.renderContext().convertToPainterUnits( scaledSize, mSizeUnit, mSizeMapUnitScale );
+  SpriteKey key;
+  key.shape = shape;
+  key.size = std::llround( size * 8 );
+  key.angle = static_cast< int >( std::lround( angle * 4 ) % 1440 );
+  key.fillColor = mBrush.color().rgba();
+  key.strokeColor = mPen.color().rgba();
+  key.strokeWidth = std::llround( mPen.widthF() * 8 );
+  key.strokeStyle = mPen.style();
+  key.joinStyle = mPen.joinStyle();
+
+  QImage sprite = mSprites.value( key );
+  if ( sprite.isNull() )
+  {
+    if ( mSprites.size() >= MAXIMUM_SPRITE_COUNT )
+      return false;
+
+    // room for any rotation of the shape and for miter joins of the stroke
+    double pw = qgsDoubleNear( mPen.widthF(), 0.0 ) ? 1 : mPen.widthF() * 4;
+    int imageSize = static_cast< int >( std::ceil( size * M_SQRT2 + pw ) ) / 2 * 2 + 3; // make image width, height odd
+    if ( imageSize > MAXIMUM_CACHE_WIDTH )
+      return false;
+
+    sprite = QImage( imageSize, imageSize, QImage::Format_ARGB32_Premultiplied );
+    sprite.fill( 0 );
+
+    QPainter p( &sprite );
+    p.setRenderHint( QPainter::Antialiasing );
+    QPainter *painter = context.renderContext().painter();
+    context.renderContext().setPainter( &p );
+    double center = imageSize / 2.0;
+    QgsSimpleMarkerSymbolLayerBase::renderPoint( QPointF( center, center ) - offset, context );
+    context.renderContext().setPainter( painter );
+    p.end();
+
+    mSprites.insert( key, sprite );
+  }
+
+  double s = sprite.width();
+  context.renderContext().painter()->drawImage( QRectF( point.x() - s / 2.0 + offset.x(),
+      point.y() - s / 2.0 + offset.y(),
+      s, s ), sprite );
+  return true;
+}
+
 QgsStringMap QgsSimpleMarkerSymbolLayer::properties() const
 {
   QgsStringMap map;
@@ -3198,8 +3287,8 @@ void QgsFontMarkerSymbolLayer::renderPoint( QPointF point, QgsSymbolRenderContex
     transform.scale( s, s );
   }
 
-  QPainterPath path;
-  path.addText( -chrOffset.x(), -chrOffset.y(), mFont, charToRender );
+  QPainterPath path = QgsTextOutlineCache::textPath( mFont, charToRender ).translated( -chrOffset );
+  path.setFillRule( Qt::OddEvenFill );
   p->drawPath( transform.map( path ) );
   p->restore();
 }
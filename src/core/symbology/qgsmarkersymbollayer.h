@@ -33,6 +33,7 @@
 #include <QPicture>
 #include <QPolygonF>
 #include <QFont>
+#include <QHash>
 
 /**
  * \ingroup core
@@ -238,6 +239,7 @@ class CORE_EXPORT QgsSimpleMarkerSymbolLayer : public QgsSimpleMarkerSymbolLayer
 
     QString layerType() const override;
     void startRender( QgsSymbolRenderContext &context ) override;
+    void stopRender( QgsSymbolRenderContext &context ) override;
     void renderPoint( QPointF point, QgsSymbolRenderContext &context ) override;
     QgsStringMap properties() const override;
     QgsSimpleMarkerSymbolLayer *clone() const override SIP_FACTORY;
@@ -414,6 +416,58 @@ class CORE_EXPORT QgsSimpleMarkerSymbolLayer : public QgsSimpleMarkerSymbolLayer
 
   private:
 
+    friend class TestQgsSimpleMarkerSymbol;
+
+    /**
+     * Evaluated parameters of a marker, quantized so that nearly identical markers
+     * share the same sprite.
+     */
+    struct SpriteKey
+    {
+      int shape = 0;
+      qint64 size = 0;
+      int angle = 0;
+      QRgb fillColor = 0;
+      QRgb strokeColor = 0;
+      qint64 strokeWidth = 0;
+      int strokeStyle = 0;
+      int joinStyle = 0;
+
+      bool operator==( const SpriteKey &other ) const
+      {
+        return shape == other.shape && size == other.size && angle == other.angle
+               && fillColor == other.fillColor && strokeColor == other.strokeColor
+               && strokeWidth == other.strokeWidth && strokeStyle == other.strokeStyle && joinStyle == other.joinStyle;
+      }
+
+      friend uint qHash( const SpriteKey &key )
+      {
+        return qHash( key.size ) ^ ( qHash( key.angle ) << 1 ) ^ ( qHash( key.fillColor ) << 2 ) ^ qHash( key.strokeColor )
+               ^ ( qHash( key.strokeWidth ) << 3 ) ^ static_cast< uint >( key.shape << 16 | key.strokeStyle << 8 | key.joinStyle );
+      }
+    };
+
+    /**
+     * Sprites of the markers already drawn during this rendering, used instead of the
+     * single cached image when properties are data defined
+     */
+    QHash< SpriteKey, QImage > mSprites;
+
+    //! True if markers with data defined properties are drawn from sprites
+    bool mUsingSprites = false;
+
+    //! Maximum number of sprites kept during a rendering
+    static const int MAXIMUM_SPRITE_COUNT = 1000;
+
+    /**
+     * Draws the marker at \a point from a sprite matching its evaluated properties, rendering
+     * the sprite if there is none yet. Returns false if the marker must be drawn as a vector.
+     */
+    bool renderSprite( QPointF point, QgsSymbolRenderContext &context );
+
+    //! Updates the pens and the brush with the data defined properties of the stroke and fill
+    void updateDataDefinedPenAndBrush( QgsSymbolRenderContext &context );
+
     void draw( QgsSymbolRenderContext &context, QgsSimpleMarkerSymbolLayerBase::Shape shape, const QPolygonF &polygon, const QPainterPath &path ) override SIP_FORCE;
 };
 
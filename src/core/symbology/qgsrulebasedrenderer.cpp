@@ -27,6 +27,8 @@
 #include "qgspainteffect.h"
 #include "qgspainteffectregistry.h"
 #include "qgsproperty.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsexpressionutils.h"
 
 #include <QSet>
 
@@ -34,6 +36,169 @@
 #include <QDomElement>
 #include <QUuid>
 
+///@cond PRIVATE
+
+struct QgsRuleBasedRenderer::Rule::ChildLookup
+{
+  int fieldIndex = -1;
+  //! Children with a filter which can only be true for the values below
+  QSet< const Rule * > guarded;
+  QHash< QString, QVector< const Rule * > > stringValues;
+  //! Integral numeric values, also matching values nearly equal to them
+  QHash< qlonglong, QVector< const Rule * > > numberValues;
+
+  /**
+   * Stores in \a candidates the guarded children whose filter can be true for \a feature.
+   */
+  void candidates( const QgsFeature &feature, QVector< const Rule * > &candidates ) const
+  {
+    candidates.clear();
+    const QVariant value = feature.attribute( fieldIndex );
+    // the equality and IN operators are never true with a NULL operand
+    if ( QgsExpressionUtils::isNull( value ) )
+      return;
+
+    // strings which are not numbers are compared as strings
+    candidates += stringValues.value( QgsExpressionUtils::getStringValue( value, nullptr ) );
+    if ( QgsExpressionUtils::isDoubleSafe( value ) )
+    {
+      const double number = value.toDouble();
+      if ( std::fabs( number ) < 1e15 )
+        candidates += numberValues.value( std::llround( number ) );
+    }
+  }
+
+  //! Returns true if the filter of \a child is known to be false, given the \a candidates
+  bool skips( const Rule *child, const QVector< const Rule * > &candidates ) const
+  {
+    return guarded.contains( child ) && !candidates.contains( child );
+  }
+};
+
+/**
+ * Adds the lookup keys matching the \a literal. Returns false if values equal to
+ * the literal cannot be looked up.
+ */
+static bool addLookupValue( const QVariant &literal, QSet< QString > &strings, QSet< qlonglong > &numbers )
+{
+  // never equal to anything
+  if ( literal.isNull() )
+    return true;
+
+  auto addNumber = [&numbers]( double number )
+  {
+    if ( std::fabs( number ) >= 1e15 || number != std::floor( number ) )
+      return false;
+    numbers.insert( static_cast< qlonglong >( number ) );
+    return true;
+  };
+
+  switch ( literal.type() )
+  {
+    case QVariant::String:
+      strings.insert( literal.toString() );
+      // numeric strings are compared as numbers against numeric values
+      return !QgsExpressionUtils::isDoubleSafe( literal ) || addNumber( literal.toDouble() );
+
+    case QVariant::Int:
+    case QVariant::LongLong:
+    {
+      // feature values are only looked up below 1e15, see ChildLookup::candidates()
+      const qlonglong number = literal.toLongLong();
+      if ( number >= 1000000000000000LL || number <= -1000000000000000LL )
+        return false;
+      numbers.insert( number );
+      return true;
+    }
+
+    case QVariant::Double:
+      return addNumber( literal.toDouble() );
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * Finds a necessary condition of the form "field = value" or "field IN (values)" for the
+ * expression \a node to be true. Returns false if there is none.
+ */
+static bool fieldLookupCondition( const QgsExpressionNode *node, QString &field, QSet< QString > &strings, QSet< qlonglong > &numbers )
+{
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntBinaryOperator:
+    {
+      const QgsExpressionNodeBinaryOperator *op = static_cast< const QgsExpressionNodeBinaryOperator * >( node );
+      switch ( op->op() )
+      {
+        case QgsExpressionNodeBinaryOperator::boAnd:
+        {
+          // any operand of AND is a necessary condition
+          QString leftField;
+          QSet< QString > leftStrings;
+          QSet< qlonglong > leftNumbers;
+          if ( fieldLookupCondition( op->opLeft(), leftField, leftStrings, leftNumbers ) )
+          {
+            field = leftField;
+            strings.unite( leftStrings );
+            numbers.unite( leftNumbers );
+            return true;
+          }
+          return fieldLookupCondition( op->opRight(), field, strings, numbers );
+        }
+
+        case QgsExpressionNodeBinaryOperator::boOr:
+        {
+          // both operands must test the same field
+          QString rightField;
+          if ( !fieldLookupCondition( op->opLeft(), field, strings, numbers )
+               || !fieldLookupCondition( op->opRight(), rightField, strings, numbers ) )
+            return false;
+          return field == rightField;
+        }
+
+        case QgsExpressionNodeBinaryOperator::boEQ:
+        {
+          const QgsExpressionNode *column = op->opLeft();
+          const QgsExpressionNode *literal = op->opRight();
+          if ( column->nodeType() != QgsExpressionNode::ntColumnRef )
+            std::swap( column, literal );
+          if ( column->nodeType() != QgsExpressionNode::ntColumnRef || literal->nodeType() != QgsExpressionNode::ntLiteral )
+            return false;
+
+          field = static_cast< const QgsExpressionNodeColumnRef * >( column )->name();
+          return addLookupValue( static_cast< const QgsExpressionNodeLiteral * >( literal )->value(), strings, numbers );
+        }
+
+        default:
+          return false;
+      }
+    }
+
+    case QgsExpressionNode::ntInOperator:
+    {
+      const QgsExpressionNodeInOperator *in = static_cast< const QgsExpressionNodeInOperator * >( node );
+      if ( in->isNotIn() || in->node()->nodeType() != QgsExpressionNode::ntColumnRef )
+        return false;
+
+      field = static_cast< const QgsExpressionNodeColumnRef * >( in->node() )->name();
+      const QList< QgsExpressionNode * > values = in->list()->list();
+      for ( const QgsExpressionNode *value : values )
+      {
+        if ( value->nodeType() != QgsExpressionNode::ntLiteral
+             || !addLookupValue( static_cast< const QgsExpressionNodeLiteral * >( value )->value(), strings, numbers ) )
+          return false;
+      }
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+///@endcond
 
 QgsRuleBasedRenderer::Rule::Rule( QgsSymbol *symbol, int scaleMinDenom, int scaleMaxDenom, const QString &filterExp, const QString &label, const QString &description, bool elseRule )
   : mParent( nullptr )
@@ -402,6 +567,8 @@ bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const Q
     }
   }
 
+  buildChildLookup( fields );
+
   // subfilters (on the same level) are joined with OR
   // Finally they are joined with their parent (this) with AND
   QString sf;
@@ -468,6 +635,62 @@ bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const Q
   return true;
 }
 
+void QgsRuleBasedRenderer::Rule::buildChildLookup( const QgsFields &fields )
+{
+  mChildLookup.reset();
+
+  // find the field tested by most children
+  QHash< const Rule *, QString > childFields;
+  QHash< const Rule *, QPair< QSet< QString >, QSet< qlonglong > > > childValues;
+  QHash< QString, int > fieldCounts;
+  for ( const Rule *child : qgis::as_const( mChildren ) )
+  {
+    if ( !child->mFilter || child->mElseRule || !child->mFilter->rootNode() )
+      continue;
+
+    QString field;
+    QSet< QString > strings;
+    QSet< qlonglong > numbers;
+    if ( !fieldLookupCondition( child->mFilter->rootNode(), field, strings, numbers ) )
+      continue;
+
+    childFields.insert( child, field );
+    childValues.insert( child, qMakePair( strings, numbers ) );
+    fieldCounts[ field ]++;
+  }
+
+  QString field;
+  int count = 0;
+  for ( auto it = fieldCounts.constBegin(); it != fieldCounts.constEnd(); ++it )
+  {
+    if ( it.value() > count )
+    {
+      field = it.key();
+      count = it.value();
+    }
+  }
+
+  const int fieldIndex = fields.lookupField( field );
+  if ( count < 2 || fieldIndex < 0 )
+    return;
+
+  mChildLookup = qgis::make_unique< ChildLookup >();
+  mChildLookup->fieldIndex = fieldIndex;
+  for ( auto it = childFields.constBegin(); it != childFields.constEnd(); ++it )
+  {
+    if ( it.value() != field )
+      continue;
+
+    const Rule *child = it.key();
+    mChildLookup->guarded.insert( child );
+    const QPair< QSet< QString >, QSet< qlonglong > > &values = childValues[ child ];
+    for ( const QString &value : values.first )
+      mChildLookup->stringValues[ value ].append( child );
+    for ( qlonglong value : values.second )
+      mChildLookup->numberValues[ value ].append( child );
+  }
+}
+
 QSet<int> QgsRuleBasedRenderer::Rule::collectZLevels()
 {
   QSet<int> symbolZLevelsSet;
@@ -532,11 +755,16 @@ QgsRuleBasedRenderer::Rule::RenderResult QgsRuleBasedRenderer::Rule::renderFeatu
 
   bool willrendersomething = false;
 
+  // children whose filter may be true, for the children tested by the lookup
+  QVector< const Rule * > candidates;
+  if ( mChildLookup )
+    mChildLookup->candidates( featToRender.feat, candidates );
+
   // process children
   Q_FOREACH ( Rule *rule, mChildren )
   {
-    // Don't process else rules yet
-    if ( !rule->isElse() )
+    // Don't process else rules yet, and skip rules whose filter is known to be false
+    if ( !rule->isElse() && !( mChildLookup && mChildLookup->skips( rule, candidates ) ) )
     {
       RenderResult res = rule->renderFeature( featToRender, context, renderQueue );
       // consider inactive items as "rendered" so the else rule will ignore them
@@ -604,9 +832,14 @@ QgsSymbolList QgsRuleBasedRenderer::Rule::symbolsForFeature( const QgsFeature &f
   if ( mSymbol )
     lst.append( mSymbol.get() );
 
+  QVector< const Rule * > candidates;
+  if ( mChildLookup )
+    mChildLookup->candidates( feature, candidates );
+
   Q_FOREACH ( Rule *rule, mActiveChildren )
   {
-    lst += rule->symbolsForFeature( feature, context );
+    if ( !( mChildLookup && mChildLookup->skips( rule, candidates ) ) )
+      lst += rule->symbolsForFeature( feature, context );
   }
   return lst;
 }
@@ -676,6 +909,7 @@ void QgsRuleBasedRenderer::Rule::stopRender( QgsRenderContext &context )
 
   mActiveChildren.clear();
   mSymbolNormZLevels.clear();
+  mChildLookup.reset();
 }
 
 QgsRuleBasedRenderer::Rule *QgsRuleBasedRenderer::Rule::create( QDomElement &ruleElem, QgsSymbolMap &symbolMap )
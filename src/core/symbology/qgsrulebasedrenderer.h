@@ -454,6 +454,20 @@ class CORE_EXPORT QgsRuleBasedRenderer : public QgsFeatureRenderer
         QSet<int> mSymbolNormZLevels;
         RuleList mActiveChildren;
 
+        struct ChildLookup;
+
+        /**
+         * Values of a field for which the filters of child rules can be true, built by
+         * startRender() so that the filters which cannot match a feature are not evaluated.
+         */
+        std::unique_ptr< ChildLookup > mChildLookup;
+
+        /**
+         * Builds the lookup of child rules with filters on the same field, if the filters
+         * of at least two children are equality or IN tests on that field.
+         */
+        void buildChildLookup( const QgsFields &fields );
+
         /**
          * Check which child rules are else rules and update the internal list of else rules
          *
@@ -73,6 +73,7 @@ void QgsAttributeTableFilterModel::sort( int column, Qt::SortOrder order )
 
   int myColumn = mColumnMapping.at( column );
   masterModel()->prefetchColumnData( myColumn );
+  updateLoadingOrder( order );
   QSortFilterProxyModel::sort( myColumn, order );
   emit sortColumnChanged( column, order );
 }
@@ -230,6 +231,7 @@ void QgsAttributeTableFilterModel::sort( const QString &expression, Qt::SortOrde
 
   QSortFilterProxyModel::sort( -1 );
   masterModel()->prefetchSortData( expression );
+  updateLoadingOrder( order );
   QSortFilterProxyModel::sort( 0, order );
 }
 
@@ -274,6 +276,7 @@ void QgsAttributeTableFilterModel::setSourceModel( QgsAttributeTableModel *sourc
   // The following connections are needed in order to keep the filter model in sync, see: regression #15974
   connect( mTableModel, &QAbstractItemModel::columnsAboutToBeInserted, this, &QgsAttributeTableFilterModel::onColumnsChanged );
   connect( mTableModel, &QAbstractItemModel::columnsAboutToBeRemoved, this, &QgsAttributeTableFilterModel::onColumnsChanged );
+  connect( mTableModel, &QAbstractItemModel::modelReset, this, &QgsAttributeTableFilterModel::loadAllFeatures );
 
 }
 
@@ -316,10 +319,37 @@ void QgsAttributeTableFilterModel::setFilterMode( FilterMode filterMode )
     }
 
     mFilterMode = filterMode;
+    loadAllFeatures();
     invalidateFilter();
   }
 }
 
+void QgsAttributeTableFilterModel::loadAllFeatures()
+{
+  // only rows loaded in the master model are filtered, so features loaded
+  // in batches must all be loaded to show those matching a filter
+  if ( mFilterMode == ShowAll )
+    return;
+
+  while ( mTableModel->canFetchMore() )
+    mTableModel->fetchMore();
+}
+
+void QgsAttributeTableFilterModel::updateLoadingOrder( Qt::SortOrder order )
+{
+  if ( masterModel()->canLoadInSortOrder() )
+  {
+    masterModel()->setLoadingOrder( masterModel()->sortCacheExpression(), order );
+    return;
+  }
+
+  // the data provider cannot sort the features like the model,
+  // which only sorts the rows correctly once they are all loaded
+  masterModel()->setLoadingOrder( QString() );
+  while ( mTableModel->canFetchMore() )
+    mTableModel->fetchMore();
+}
+
 bool QgsAttributeTableFilterModel::filterAcceptsRow( int sourceRow, const QModelIndex &sourceParent ) const
 {
   Q_UNUSED( sourceParent );
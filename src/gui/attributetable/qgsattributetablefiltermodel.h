@@ -265,7 +265,14 @@ class GUI_EXPORT QgsAttributeTableFilterModel: public QSortFilterProxyModel, pub
     void selectionChanged();
     void onColumnsChanged();
 
+    //! Loads the features of the master model not loaded yet, if the filter mode needs them
+    void loadAllFeatures();
+
   private:
+
+    //! Sets the loading order of the master model to the sort \a order of the table, or loads all features if it cannot be used
+    void updateLoadingOrder( Qt::SortOrder order );
+
     QgsFeatureIds mFilteredFeatures;
     QgsMapCanvas *mCanvas = nullptr;
     FilterMode mFilterMode = FilterMode::ShowAll;
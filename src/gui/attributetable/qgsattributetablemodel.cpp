@@ -31,6 +31,7 @@
 #include "qgsrenderer.h"
 #include "qgsvectorlayer.h"
 #include "qgsvectordataprovider.h"
+#include "qgsvectorlayereditbuffer.h"
 #include "qgssymbollayerutils.h"
 #include "qgsfieldformatterregistry.h"
 #include "qgsgui.h"
@@ -40,6 +41,7 @@
 #include "qgsfieldmodel.h"
 #include "qgstexteditwidgetfactory.h"
 
+#include <QTimer>
 #include <QVariant>
 
 #include <limits>
@@ -60,6 +62,12 @@ QgsAttributeTableModel::QgsAttributeTableModel( QgsVectorLayerCache *layerCache,
   if ( !layer()->isSpatial() )
     mFeatureRequest.setFlags( QgsFeatureRequest::NoGeometry );
 
+  // an open iterator may hold a connection or a lock of the data provider
+  mLoadingIdleTimer = new QTimer( this );
+  mLoadingIdleTimer->setSingleShot( true );
+  mLoadingIdleTimer->setInterval( 10000 );
+  connect( mLoadingIdleTimer, &QTimer::timeout, this, [ = ] { mLoadingIterator = QgsFeatureIterator(); } );
+
   loadAttributes();
 
   connect( layer(), &QgsVectorLayer::featuresDeleted, this, &QgsAttributeTableModel::featuresDeleted );
@@ -100,6 +108,108 @@ void QgsAttributeTableModel::setExtraColumns( int extraColumns )
   loadAttributes();
 }
 
+int QgsAttributeTableModel::loadingBatchSize() const
+{
+  return mLoadingBatchSize;
+}
+
+void QgsAttributeTableModel::setLoadingBatchSize( int batchSize )
+{
+  mLoadingBatchSize = std::max( 0, batchSize );
+}
+
+void QgsAttributeTableModel::setLoadingOrder( const QString &expression, Qt::SortOrder order )
+{
+  if ( expression == mLoadingOrderExpression && ( expression.isEmpty() || order == mLoadingOrder ) )
+    return;
+
+  mLoadingOrderExpression = expression;
+  mLoadingOrder = order;
+
+  // the loaded rows are only the first ones of the previous order
+  if ( mLoadingBatchSize > 0 && mLayerCache && rowCount() > 0 )
+    loadLayer();
+}
+
+bool QgsAttributeTableModel::canLoadInSortOrder( unsigned long cacheIndex ) const
+{
+  if ( cacheIndex >= mSortCaches.size() )
+    return true;
+
+  // the sort values of a field only are the field values for the fallback formatter
+  const SortCache &cache = mSortCaches[cacheIndex];
+  return cache.sortFieldIndex == -1 || mFieldFormatters.at( cache.sortFieldIndex ) == QgsApplication::fieldFormatterRegistry()->fallbackFieldFormatter();
+}
+
+bool QgsAttributeTableModel::canFetchMore( const QModelIndex &parent ) const
+{
+  if ( parent.isValid() )
+    return false;
+
+  return mLoadingPending;
+}
+
+void QgsAttributeTableModel::fetchMore( const QModelIndex &parent )
+{
+  if ( parent.isValid() || !mLayerCache || !mLoadingPending )
+    return;
+
+  if ( mLoadingIterator.isClosed() )
+  {
+    // the iterator was closed while idle, the features already read are skipped
+    mLoadingIterator = mLayerCache->getFeatures( loadingRequest() );
+    long skipped = 0;
+    while ( skipped < mLoadingPosition && mLoadingIterator.nextFeature( mFeat ) )
+      ++skipped;
+  }
+
+  QgsVectorLayerEditBuffer *editBuffer = layer()->editBuffer();
+
+  // collect the batch first, so that its rows are inserted at once
+  QVector<QgsFeatureId> batchIds;
+  batchIds.reserve( mLoadingBatchSize );
+  QgsFeatureIds batchIdSet;
+
+  int i = 0;
+  while ( i < mLoadingBatchSize && mLoadingIterator.nextFeature( mFeat ) )
+  {
+    ++i;
+    ++mLoadingPosition;
+
+    // features deleted since the iterator was created are still returned
+    if ( editBuffer && editBuffer->isFeatureDeleted( mFeat.id() ) )
+      continue;
+
+    if ( !mFeatureRequest.acceptFeature( mFeat ) )
+      continue;
+
+    // features added while loading may already have their row
+    if ( mIdRowMap.contains( mFeat.id() ) || batchIdSet.contains( mFeat.id() ) )
+      continue;
+
+    cacheSortValues( mFeat );
+    batchIds << mFeat.id();
+    batchIdSet << mFeat.id();
+  }
+
+  if ( i < mLoadingBatchSize )
+    stopLoading();
+  else
+    mLoadingIdleTimer->start();
+
+  if ( batchIds.isEmpty() )
+    return;
+
+  const int n = mRowIdMap.size();
+  beginInsertRows( QModelIndex(), n, n + batchIds.size() - 1 );
+  for ( int row = 0; row < batchIds.size(); ++row )
+  {
+    mIdRowMap.insert( batchIds.at( row ), n + row );
+    mRowIdMap.insert( n + row, batchIds.at( row ) );
+  }
+  endInsertRows();
+}
+
 void QgsAttributeTableModel::featuresDeleted( const QgsFeatureIds &fids )
 {
   QList<int> rows;
@@ -219,22 +329,7 @@ void QgsAttributeTableModel::featureAdded( QgsFeatureId fid, bool resettingModel
 
   if ( featOk && mFeatureRequest.acceptFeature( mFeat ) )
   {
-    for ( SortCache &cache : mSortCaches )
-    {
-      if ( cache.sortFieldIndex >= 0 )
-      {
-        QgsFieldFormatter *fieldFormatter = mFieldFormatters.at( cache.sortFieldIndex );
-        const QVariant &widgetCache = mAttributeWidgetCaches.at( cache.sortFieldIndex );
-        const QVariantMap &widgetConfig = mWidgetConfigs.at( cache.sortFieldIndex );
-        QVariant sortValue = fieldFormatter->representValue( layer(), cache.sortFieldIndex, widgetConfig, widgetCache, mFeat.attribute( cache.sortFieldIndex ) );
-        cache.sortCache.insert( mFeat.id(), sortValue );
-      }
-      else if ( cache.sortCacheExpression.isValid() )
-      {
-        mExpressionContext.setFeature( mFeat );
-        cache.sortCache[mFeat.id()] = cache.sortCacheExpression.evaluate( &mExpressionContext );
-      }
-    }
+    cacheSortValues( mFeat );
 
     // Skip if the fid is already in the map (do not add twice)!
     if ( ! mIdRowMap.contains( fid ) )
@@ -251,6 +346,26 @@ void QgsAttributeTableModel::featureAdded( QgsFeatureId fid, bool resettingModel
   }
 }
 
+void QgsAttributeTableModel::cacheSortValues( const QgsFeature &feature )
+{
+  for ( SortCache &cache : mSortCaches )
+  {
+    if ( cache.sortFieldIndex >= 0 )
+    {
+      QgsFieldFormatter *fieldFormatter = mFieldFormatters.at( cache.sortFieldIndex );
+      const QVariant &widgetCache = mAttributeWidgetCaches.at( cache.sortFieldIndex );
+      const QVariantMap &widgetConfig = mWidgetConfigs.at( cache.sortFieldIndex );
+      QVariant sortValue = fieldFormatter->representValue( layer(), cache.sortFieldIndex, widgetConfig, widgetCache, feature.attribute( cache.sortFieldIndex ) );
+      cache.sortCache.insert( feature.id(), sortValue );
+    }
+    else if ( cache.sortCacheExpression.isValid() )
+    {
+      mExpressionContext.setFeature( feature );
+      cache.sortCache[feature.id()] = cache.sortCacheExpression.evaluate( &mExpressionContext );
+    }
+  }
+}
+
 void QgsAttributeTableModel::updatedFields()
 {
   loadAttributes();
@@ -279,6 +394,7 @@ void QgsAttributeTableModel::attributeDeleted( int idx )
 
 void QgsAttributeTableModel::layerDeleted()
 {
+  stopLoading();
   mLayerCache = nullptr;
   removeRows( 0, rowCount() );
 
@@ -441,17 +557,19 @@ void QgsAttributeTableModel::loadLayer()
     removeRows( 0, rowCount() );
   }
 
+  stopLoading();
+
   // Layer might have been deleted and cache set to nullptr!
   if ( mLayerCache )
   {
-    QgsFeatureIterator features = mLayerCache->getFeatures( mFeatureRequest );
+    QgsFeatureIterator features = mLayerCache->getFeatures( loadingRequest() );
 
     int i = 0;
 
     QTime t;
     t.start();
 
-    while ( features.nextFeature( mFeat ) )
+    while ( ( mLoadingBatchSize <= 0 || i < mLoadingBatchSize ) && features.nextFeature( mFeat ) )
     {
       ++i;
 
@@ -467,6 +585,15 @@ void QgsAttributeTableModel::loadLayer()
       featureAdded( mFeat.id(), true );
     }
 
+    // the following features are loaded on demand by fetchMore()
+    if ( mLoadingBatchSize > 0 && i == mLoadingBatchSize )
+    {
+      mLoadingIterator = features;
+      mLoadingPending = true;
+      mLoadingPosition = i;
+      mLoadingIdleTimer->start();
+    }
+
     emit finished();
     connect( mLayerCache, &QgsVectorLayerCache::invalidated, this, &QgsAttributeTableModel::loadLayer, Qt::UniqueConnection );
   }
@@ -474,6 +601,24 @@ void QgsAttributeTableModel::loadLayer()
   endResetModel();
 }
 
+QgsFeatureRequest QgsAttributeTableModel::loadingRequest() const
+{
+  QgsFeatureRequest request( mFeatureRequest );
+  if ( mLoadingBatchSize > 0 && !mLoadingOrderExpression.isEmpty() )
+  {
+    // the first batches must be the first rows of the sorted table
+    request.setOrderBy( QgsFeatureRequest::OrderBy() << QgsFeatureRequest::OrderByClause( mLoadingOrderExpression, mLoadingOrder == Qt::AscendingOrder ) );
+  }
+  return request;
+}
+
+void QgsAttributeTableModel::stopLoading()
+{
+  mLoadingIdleTimer->stop();
+  mLoadingIterator = QgsFeatureIterator();
+  mLoadingPending = false;
+  mLoadingPosition = 0;
+}
 
 void QgsAttributeTableModel::fieldConditionalStyleChanged( const QString &fieldName )
 {
@@ -931,6 +1076,11 @@ void QgsAttributeTableModel::prefetchSortData( const QString &expressionString,
   QgsFeatureRequest request = QgsFeatureRequest( mFeatureRequest )
                               .setFlags( QgsFeatureRequest::NoGeometry )
                               .setSubsetOfAttributes( cache.sortCacheAttributes );
+  if ( mLoadingBatchSize > 0 )
+  {
+    // only the loaded rows need a sort value, the other ones get theirs when they are loaded
+    request.setFilterFids( mIdRowMap.keys().toSet() );
+  }
   QgsFeatureIterator it = mLayerCache->getFeatures( request );
 
   QgsFeature f;
@@ -28,12 +28,14 @@
 #include "qgsconditionalstyle.h"
 #include "qgsattributeeditorcontext.h"
 #include "qgsvectorlayercache.h"
+#include "qgsfeatureiterator.h"
 #include "qgis_gui.h"
 
 class QgsMapCanvas;
 class QgsMapLayerAction;
 class QgsEditorWidgetFactory;
 class QgsFieldFormatter;
+class QTimer;
 
 /**
  * \ingroup gui
@@ -255,6 +257,56 @@ class GUI_EXPORT QgsAttributeTableModel: public QAbstractTableModel
      */
     void setExtraColumns( int extraColumns );
 
+    /**
+     * Sets the number of features loaded at once to \a batchSize.
+     *
+     * If \a batchSize is 0 (the default), loadLayer() loads all the features of the layer.
+     * Otherwise it only loads the first \a batchSize features, and views load the following
+     * ones with fetchMore() as they are scrolled down. The feature iterator is kept open
+     * between batches, so that the request filter and the loading order are evaluated by
+     * the data provider only once. It is closed once no batch was loaded for a while, and
+     * the next fetchMore() reopens it after the features already read.
+     *
+     * \see loadingBatchSize()
+     * \since QGIS 3.6
+     */
+    void setLoadingBatchSize( int batchSize );
+
+    /**
+     * Returns the number of features loaded at once, or 0 if all the features are loaded
+     * by loadLayer().
+     *
+     * \see setLoadingBatchSize()
+     * \since QGIS 3.6
+     */
+    int loadingBatchSize() const;
+
+    /**
+     * Sets the \a expression and \a order used to request features when they are loaded in batches,
+     * so that the loaded rows are the first ones of the sorted table. Providers able to compile
+     * the expression sort the features themselves. The layer is reloaded if the loading order
+     * changes. An empty \a expression loads features in the provider order.
+     *
+     * \see setLoadingBatchSize()
+     * \since QGIS 3.6
+     */
+    void setLoadingOrder( const QString &expression, Qt::SortOrder order = Qt::AscendingOrder );
+
+    /**
+     * Returns true if the features can be loaded in the order of the sort cache \a cacheIndex,
+     * i.e. if it sorts on the values of the features. Fields whose formatter sorts on other
+     * values, e.g. on the represented values of a value map, can only be sorted by the model,
+     * once all the features are loaded.
+     *
+     * \see setLoadingOrder()
+     * \since QGIS 3.6
+     */
+    bool canLoadInSortOrder( unsigned long cacheIndex = 0 ) const;
+
+    bool canFetchMore( const QModelIndex &parent = QModelIndex() ) const override;
+
+    void fetchMore( const QModelIndex &parent = QModelIndex() ) override;
+
   public slots:
 
     /**
@@ -363,6 +415,9 @@ class GUI_EXPORT QgsAttributeTableModel: public QAbstractTableModel
 
     bool fieldIsEditable( const QgsVectorLayer &layer, int fieldIndex, QgsFeatureId fid ) const;
 
+    //! Caches the values of \a feature used for sorting
+    void cacheSortValues( const QgsFeature &feature );
+
     QgsFeatureRequest mFeatureRequest;
 
     struct SortCache
@@ -382,6 +437,25 @@ class GUI_EXPORT QgsAttributeTableModel: public QAbstractTableModel
 
     int mExtraColumns = 0;
 
+    int mLoadingBatchSize = 0;
+    QString mLoadingOrderExpression;
+    Qt::SortOrder mLoadingOrder = Qt::AscendingOrder;
+
+    //! Iterator over the features not loaded yet, when loading in batches, closed when idle
+    QgsFeatureIterator mLoadingIterator;
+    //! True if features remain to be loaded in batches
+    bool mLoadingPending = false;
+    //! Number of features read by the loading iterator, skipped when it is reopened
+    long mLoadingPosition = 0;
+    //! Closes the loading iterator once no batch was loaded for a while
+    QTimer *mLoadingIdleTimer = nullptr;
+
+    //! Returns the request of the features of the table, in the loading order
+    QgsFeatureRequest loadingRequest() const;
+
+    //! Stops loading features in batches
+    void stopLoading();
+
     //! Flag for massive changes operations, set by edit command or rollback
     bool mBulkEditCommandRunning = false;
 
@@ -287,6 +287,13 @@ void QgsDualView::initModels( QgsMapCanvas *mapCanvas, const QgsFeatureRequest &
   mMasterModel->setEditorContext( mEditorContext );
   mMasterModel->setExtraColumns( 1 ); // Add one extra column which we can "abuse" as an action column
 
+  // Features of layers which are not fully cached are loaded in batches, as the table is scrolled
+  if ( !mLayerCache->hasFullCache() )
+  {
+    QgsSettings settings;
+    mMasterModel->setLoadingBatchSize( settings.value( QStringLiteral( "qgis/attributeTableLoadingBatchSize" ), 1000 ).toInt() );
+  }
+
   connect( mMasterModel, &QgsAttributeTableModel::progress, this, &QgsDualView::progress );
   connect( mMasterModel, &QgsAttributeTableModel::finished, this, &QgsDualView::finished );
 
@@ -491,6 +491,9 @@ QgsExpressionContextScope *QgsMapCanvas::defaultExpressionContextScope()
 
 void QgsMapCanvas::refresh()
 {
+  // set again by layerRepaintRequested() if the refresh is only due to layer repaints
+  mRefreshForLayerRepaint = false;
+
   if ( !mSettings.hasValidSettings() )
   {
     QgsDebugMsg( QStringLiteral( "CANVAS refresh - invalid settings -> nothing to do" ) );
@@ -569,7 +572,13 @@ void QgsMapCanvas::refreshMap()
   // deleting the one we have just started.
   mRefreshScheduled = false;
 
-  mMapUpdateTimer.start();
+  // when layers requested a repaint of an unchanged view, keep showing the last complete map until
+  // the job is finished, instead of flashing the layers being redrawn and missing labels
+  const bool repaintOnly = mRefreshForLayerRepaint && mSettings.visibleExtent() == mRenderedExtent
+                           && mSettings.outputSize() == mRenderedSize && mSettings.layerIds() == mRenderedLayerIds;
+  mRefreshForLayerRepaint = false;
+  if ( !repaintOnly )
+    mMapUpdateTimer.start();
 
   emit renderStarting();
 }
@@ -649,6 +658,9 @@ void QgsMapCanvas::rendererJobFinished()
     p.end();
 
     mMap->setContent( img, imageRect( img, mSettings ) );
+    mRenderedExtent = mJob->mapSettings().visibleExtent();
+    mRenderedSize = mJob->mapSettings().outputSize();
+    mRenderedLayerIds = mJob->mapSettings().layerIds();
 
     mLastLayerRenderTime.clear();
     const auto times = mJob->perLayerRenderingTime();
@@ -1887,8 +1899,13 @@ void QgsMapCanvas::connectNotify( const char *signal )
 
 void QgsMapCanvas::layerRepaintRequested( bool deferred )
 {
-  if ( !deferred )
-    refresh();
+  if ( deferred )
+    return;
+
+  // a refresh already scheduled for another reason keeps its progressive updates
+  const bool repaintOnly = !mRefreshScheduled || mRefreshForLayerRepaint;
+  refresh();
+  mRefreshForLayerRepaint = repaintOnly && mRefreshScheduled;
 }
 
 void QgsMapCanvas::autoRefreshTriggered()
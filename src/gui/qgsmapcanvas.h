@@ -955,6 +955,14 @@ class GUI_EXPORT QgsMapCanvas : public QGraphicsView
     //! Flag determining whether the active job has been canceled
     bool mJobCanceled = false;
 
+    //! Extent, size and layers of the last complete map image shown in the canvas
+    QgsRectangle mRenderedExtent;
+    QSize mRenderedSize;
+    QStringList mRenderedLayerIds;
+
+    //! Flag indicating that the scheduled refresh is only due to layer repaint requests
+    bool mRefreshForLayerRepaint = false;
+
     //! Labeling results from the recently rendered map
     QgsLabelingResults *mLabelingResults = nullptr;
 
@@ -25,12 +25,20 @@
 #include "qgsmessagelog.h"
 #include "qgssettings.h"
 #include "qgsexception.h"
+#include "qgsfeaturebatch.h"
 #include "qgswkbtypes.h"
 #include "qgsogrtransaction.h"
 
 #include <QTextCodec>
 #include <QFile>
 
+// Starting with GDAL 2.2, there are 2 concepts: unset fields and null fields
+// whereas previously there was only unset fields. For QGIS purposes, both
+// states (unset/null) are equivalent.
+#ifndef OGRNullMarker
+#define OGR_F_IsFieldSetAndNotNull OGR_F_IsFieldSet
+#endif
+
 // using from provider:
 // - setRelevantFields(), mRelevantFieldsForNextFeature
 // - ogrLayer
@@ -117,6 +125,13 @@ QgsOgrFeatureIterator::QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool
     return;
   }
 
+  if ( !mFilterRect.isNull() && ( mRequest.flags() & QgsFeatureRequest::ExactIntersect ) )
+  {
+    // every fetched feature is tested against the same rectangle
+    mFilterRectGeometry = QgsGeometry::fromRect( mFilterRect );
+    mFilterRectGeometry.prepare();
+  }
+
   mFetchGeometry = ( !mFilterRect.isNull() ) ||
                    !( mRequest.flags() & QgsFeatureRequest::NoGeometry ) ||
                    ( mSource->mOgrGeometryTypeFilter != wkbUnknown );
@@ -371,6 +386,170 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
   return false;
 }
 
+bool QgsOgrFeatureIterator::canReadBatchDirectly( const QgsFields &fields ) const
+{
+  // Only plain scans are read directly into batches. Everything else goes
+  // through fetchFeature() and the generic implementation.
+  if ( mRequest.filterType() == QgsFeatureRequest::FilterFid ||
+       mRequest.filterType() == QgsFeatureRequest::FilterFids ||
+       ( mRequest.filterType() == QgsFeatureRequest::FilterExpression && !mExpressionCompiled ) )
+    return false;
+
+  if ( !mRequest.orderBy().isEmpty() ||
+       mRequest.simplifyMethod().methodType() != QgsSimplifyMethod::NoSimplification ||
+       mTransform.isValid() ||
+       ( !mFilterRect.isNull() && ( mRequest.flags() & QgsFeatureRequest::ExactIntersect ) ) ||
+       mSource->mOgrGeometryTypeFilter != wkbUnknown )
+    return false;
+
+  // OSM-like drivers need GDALDatasetGetNextFeature()
+  if ( !QgsOgrProviderUtils::canDriverShareSameDatasetAmongLayers( mSource->mDriverName ) )
+    return false;
+
+  return fields == mSource->mFields;
+}
+
+bool QgsOgrFeatureIterator::readFeatureIntoBatch( OGRFeatureH fet, const QVector<bool> &fetchAttributes, QgsFeatureBatch &batch ) const
+{
+  OGRGeometryH geom = mFetchGeometry ? OGR_F_GetGeometryRef( fet ) : nullptr;
+  if ( !mFilterRect.isNull() )
+  {
+    // Same bounding box test as readFeature()
+    if ( !geom || OGR_G_IsEmpty( geom ) )
+      return false;
+    OGREnvelope env;
+    OGR_G_GetEnvelope( geom, &env );
+    if ( !mFilterRect.intersects( QgsRectangle( env.MinX, env.MinY, env.MaxX, env.MaxY ) ) )
+      return false;
+  }
+
+  batch.beginFeature( OGR_F_GetFID( fet ) );
+
+  const int fieldCount = mSource->mFields.count();
+  for ( int idx = 0; idx < fieldCount; ++idx )
+  {
+    QgsFeatureBatch::Column &column = batch.column( idx );
+    if ( !fetchAttributes.at( idx ) )
+    {
+      column.appendNull();
+      continue;
+    }
+
+    if ( mFirstFieldIsFid && idx == 0 )
+    {
+      column.appendVariant( static_cast<qint64>( OGR_F_GetFID( fet ) ) );
+      continue;
+    }
+
+    const int ogrIdx = mFirstFieldIsFid ? idx - 1 : idx;
+    if ( !OGR_F_IsFieldSetAndNotNull( fet, ogrIdx ) )
+    {
+      column.appendNull();
+      continue;
+    }
+
+    switch ( column.storage() )
+    {
+      case QgsFeatureBatch::Column::Integer:
+        column.appendInteger( OGR_F_GetFieldAsInteger64( fet, ogrIdx ) );
+        break;
+
+      case QgsFeatureBatch::Column::Double:
+        column.appendDouble( OGR_F_GetFieldAsDouble( fet, ogrIdx ) );
+        break;
+
+      case QgsFeatureBatch::Column::String:
+        if ( mSource->mEncoding )
+          column.appendString( mSource->mEncoding->toUnicode( OGR_F_GetFieldAsString( fet, ogrIdx ) ) );
+        else
+          column.appendString( QString::fromUtf8( OGR_F_GetFieldAsString( fet, ogrIdx ) ) );
+        break;
+
+      case QgsFeatureBatch::Column::Variant:
+      {
+        bool ok = false;
+        const QVariant value = QgsOgrUtils::getOgrFeatureAttribute( fet, mFieldsWithoutFid, ogrIdx, mSource->mEncoding, &ok );
+        column.appendVariant( ok ? value : QVariant() );
+        break;
+      }
+    }
+  }
+
+  if ( geom )
+  {
+    const OGRwkbGeometryType flatType = wkbFlatten( OGR_G_GetGeometryType( geom ) );
+    if ( flatType == wkbPolyhedralSurface || flatType == wkbTIN )
+    {
+      // Needs the remapping done by ogrGeometryToQgsGeometry()
+      const QByteArray wkb = QgsOgrUtils::ogrGeometryToQgsGeometry( geom ).asWkb();
+      memcpy( batch.allocateWkb( wkb.size() ), wkb.constData(), wkb.size() );
+    }
+    else
+    {
+      // Insure that multipart datasets return multipart geometry
+      gdal::ogr_geometry_unique_ptr multiGeom;
+      if ( QgsWkbTypes::isMultiType( mSource->mWkbType ) && !OGR_GT_IsSubClassOf( flatType, wkbGeometryCollection ) )
+      {
+        multiGeom.reset( OGR_G_ForceToMulti( OGR_G_Clone( geom ) ) );
+        geom = multiGeom.get();
+      }
+
+      // Export straight into the batch buffer. Same WKB variant as ogrGeometryToQgsGeometry(),
+      // so that 2.5D geometries keep their type
+      const int size = OGR_G_WkbSize( geom );
+      OGR_G_ExportToWkb( geom, static_cast< OGRwkbByteOrder >( QgsApplication::endian() ), batch.allocateWkb( size ) );
+    }
+  }
+
+  return true;
+}
+
+bool QgsOgrFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxSize )
+{
+  if ( !canReadBatchDirectly( batch.fields() ) )
+    return QgsAbstractFeatureIterator::nextBatch( batch, maxSize );
+
+  QMutexLocker locker( mSharedDS ? &mSharedDS->mutex() : nullptr );
+
+  batch.clear();
+
+  if ( mClosed || !mOgrLayer )
+    return false;
+
+  long toFetch = maxSize;
+  if ( mRequest.limit() >= 0 )
+    toFetch = std::min( toFetch, mRequest.limit() - mFetchedCount );
+  if ( toFetch <= 0 )
+    return false;
+  batch.reserve( static_cast< int >( toFetch ) );
+
+  QVector<bool> fetchAttributes( mSource->mFields.count(), !( mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes ) );
+  if ( mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes )
+  {
+    const QgsAttributeList attrs = mRequest.subsetOfAttributes();
+    for ( int idx : attrs )
+    {
+      if ( idx >= 0 && idx < fetchAttributes.size() )
+        fetchAttributes[idx] = true;
+    }
+  }
+
+  gdal::ogr_feature_unique_ptr fet;
+  while ( batch.size() < toFetch )
+  {
+    fet.reset( OGR_L_GetNextFeature( mOgrLayer ) );
+    if ( !fet )
+    {
+      close();
+      break;
+    }
+    readFeatureIntoBatch( fet.get(), fetchAttributes, batch );
+  }
+
+  mFetchedCount += batch.size();
+  return !batch.isEmpty();
+}
+
 void QgsOgrFeatureIterator::resetReading()
 {
 #if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(2,2,0)
@@ -498,7 +677,7 @@ bool QgsOgrFeatureIterator::readFeature( gdal::ogr_feature_unique_ptr fet, QgsFe
       // OK
     }
     else if ( ( useIntersect && ( !feature.hasGeometry()
-                                  || ( mRequest.flags() & QgsFeatureRequest::ExactIntersect && !feature.geometry().intersects( mFilterRect ) )
+                                  || ( mRequest.flags() & QgsFeatureRequest::ExactIntersect && !mFilterRectGeometry.intersects( feature.geometry() ) )
                                   || ( !( mRequest.flags() & QgsFeatureRequest::ExactIntersect ) && !feature.geometry().boundingBoxIntersects( mFilterRect ) )
                                 )
               )
@@ -18,6 +18,7 @@
 #include "qgsfeatureiterator.h"
 #include "qgsogrconnpool.h"
 #include "qgsfields.h"
+#include "qgsgeometry.h"
 
 #include <ogr_api.h>
 
@@ -64,6 +65,7 @@ class QgsOgrFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsOgr
 
     ~QgsOgrFeatureIterator() override;
 
+    bool nextBatch( QgsFeatureBatch &batch, int maxSize ) override;
     bool rewind() override;
     bool close() override;
 
@@ -76,6 +78,15 @@ class QgsOgrFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsOgr
 
     bool readFeature( gdal::ogr_feature_unique_ptr fet, QgsFeature &feature ) const;
 
+    //! Returns whether nextBatch() can read OGR features directly into a batch with the given \a fields
+    bool canReadBatchDirectly( const QgsFields &fields ) const;
+
+    /**
+     * Appends an OGR feature to a batch, reading only the attributes flagged in \a fetchAttributes.
+     * Returns false if the feature is filtered out.
+     */
+    bool readFeatureIntoBatch( OGRFeatureH fet, const QVector<bool> &fetchAttributes, QgsFeatureBatch &batch ) const;
+
     //! Gets an attribute associated with a feature
     void getFeatureAttribute( OGRFeatureH ogrFet, QgsFeature &f, int attindex ) const;
 
@@ -92,6 +103,8 @@ class QgsOgrFeatureIterator : public QgsAbstractFeatureIteratorFromSource<QgsOgr
     std::set<QgsFeatureId>::iterator mFilterFidsIt;
 
     QgsRectangle mFilterRect;
+    //! Prepared geometry of mFilterRect, for the exact intersection tests of ExactIntersect requests
+    QgsGeometry mFilterRectGeometry;
     QgsCoordinateTransform mTransform;
     QgsOgrDatasetSharedPtr mSharedDS = nullptr;
 
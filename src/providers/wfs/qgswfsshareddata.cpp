@@ -14,6 +14,7 @@
  ***************************************************************************/
 
 #include <cmath> // M_PI
+#include <limits>
 
 #include "qgswfsconstants.h"
 #include "qgswfsshareddata.h"
@@ -526,6 +527,14 @@ int QgsWFSSharedData::registerToCache( QgsWFSFeatureIterator *iterator, int limi
         break;
       }
     }
+
+    // The area of interest might also be covered by the union of several
+    // previous requests, none of them covering it on its own.
+    if ( newDownloadNeeded && tilesCached( rect ) )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "Cached tiles already cover this area of interest" ), 4 );
+      newDownloadNeeded = false;
+    }
   }
   // If there's a ongoing download with a BBOX and we request a new download
   // without it, then we need a new download.
@@ -570,106 +579,93 @@ int QgsWFSSharedData::getUpdatedCounter()
   return mGenCounter ++;
 }
 
-QSet<QString> QgsWFSSharedData::getExistingCachedGmlIds( const QVector<QgsWFSFeatureGmlIdPair> &featureList )
-{
-  QString expr;
-  bool first = true;
-  QSet<QString> setExistingGmlIds;
+// Number of tiles, along each axis, in which the capabilities extent is split
+static const int TILE_GRID_DIMENSION = 256;
 
-  QgsFields dataProviderFields = mCacheDataProvider->fields();
-  const int gmlidIdx = dataProviderFields.indexFromName( QgsWFSConstants::FIELD_GMLID );
+// Maximum number of tiles we accept to iterate over for a single rectangle
+static const qint64 MAX_TILES_PER_RECT = 1000000;
 
-  // To avoid excessive memory consumption in expression building, do not
-  // query more than 1000 ids at a time.
-  for ( int i = 0; i < featureList.size(); i ++ )
-  {
-    if ( !first )
-      expr += QLatin1String( "," );
-    else
-    {
-      expr = QgsWFSConstants::FIELD_GMLID + " IN (";
-      first = false;
-    }
-    expr += QLatin1String( "'" );
-    expr += featureList[i].second;
-    expr += QLatin1String( "'" );
-
-    if ( ( i > 0 && ( i % 1000 ) == 0 ) || i + 1 == featureList.size() )
-    {
-      expr += QLatin1String( ")" );
-
-      QgsFeatureRequest request;
-      request.setFilterExpression( expr );
-
-      QgsAttributeList attList;
-      attList.append( gmlidIdx );
-      request.setSubsetOfAttributes( attList );
-
-      QgsFeatureIterator iterGmlIds( mCacheDataProvider->getFeatures( request ) );
-      QgsFeature gmlidFeature;
-      while ( iterGmlIds.nextFeature( gmlidFeature ) )
-      {
-        const QVariant &v = gmlidFeature.attributes().value( gmlidIdx );
-        setExistingGmlIds.insert( v.toString() );
-      }
+bool QgsWFSSharedData::tileRange( const QgsRectangle &rect, bool inner,
+                                  int &minCol, int &minRow, int &maxCol, int &maxRow ) const
+{
+  if ( mTileSize <= 0 || rect.isEmpty() )
+    return false;
 
-      first = true;
-    }
+  const double minX = ( rect.xMinimum() - mTileOrigin.x() ) / mTileSize;
+  const double minY = ( rect.yMinimum() - mTileOrigin.y() ) / mTileSize;
+  const double maxX = ( rect.xMaximum() - mTileOrigin.x() ) / mTileSize;
+  const double maxY = ( rect.yMaximum() - mTileOrigin.y() ) / mTileSize;
+  // Avoid integer overflows on rectangles that are far away from the grid
+  const double limit = std::numeric_limits<int>::max() / 2;
+  if ( std::fabs( minX ) > limit || std::fabs( minY ) > limit ||
+       std::fabs( maxX ) > limit || std::fabs( maxY ) > limit )
+    return false;
 
+  if ( inner )
+  {
+    minCol = static_cast< int >( std::ceil( minX ) );
+    minRow = static_cast< int >( std::ceil( minY ) );
+    maxCol = static_cast< int >( std::floor( maxX ) ) - 1;
+    maxRow = static_cast< int >( std::floor( maxY ) ) - 1;
+  }
+  else
+  {
+    minCol = static_cast< int >( std::floor( minX ) );
+    minRow = static_cast< int >( std::floor( minY ) );
+    maxCol = static_cast< int >( std::ceil( maxX ) ) - 1;
+    maxRow = static_cast< int >( std::ceil( maxY ) ) - 1;
   }
+  if ( maxCol < minCol || maxRow < minRow )
+    return false;
 
-  return setExistingGmlIds;
+  return static_cast< qint64 >( maxCol - minCol + 1 ) * ( maxRow - minRow + 1 ) <= MAX_TILES_PER_RECT;
 }
 
-QSet<QString> QgsWFSSharedData::getExistingCachedMD5( const QVector<QgsWFSFeatureGmlIdPair> &featureList )
+void QgsWFSSharedData::markTilesAsCached( const QgsRectangle &rect )
 {
-  QString expr;
-  bool first = true;
-  QSet<QString> setExistingMD5;
-
-  QgsFields dataProviderFields = mCacheDataProvider->fields();
-  const int md5Idx = dataProviderFields.indexFromName( QgsWFSConstants::FIELD_MD5 );
+  if ( mTileSize <= 0 )
+  {
+    // Lazily anchor the grid on the capabilities extent, or on the first
+    // fully downloaded area if the server didn't report a usable extent
+    const QgsRectangle gridExtent = !mCapabilityExtent.isEmpty() ? mCapabilityExtent : rect;
+    const double size = std::max( gridExtent.width(), gridExtent.height() ) / TILE_GRID_DIMENSION;
+    if ( !( size > 0 ) )
+      return;
+    mTileOrigin = QgsPointXY( gridExtent.xMinimum(), gridExtent.yMinimum() );
+    mTileSize = size;
+  }
 
-  // To avoid excessive memory consumption in expression building, do not
-  // query more than 1000 ids at a time.
-  for ( int i = 0; i < featureList.size(); i ++ )
+  int minCol, minRow, maxCol, maxRow;
+  if ( !tileRange( rect, true, minCol, minRow, maxCol, maxRow ) )
+    return;
+  for ( int row = minRow; row <= maxRow; ++row )
   {
-    if ( !first )
-      expr += QLatin1String( "," );
-    else
+    for ( int col = minCol; col <= maxCol; ++col )
     {
-      expr = QgsWFSConstants::FIELD_MD5 + " IN (";
-      first = false;
+      mCachedTiles.insert( qMakePair( col, row ) );
     }
-    expr += QLatin1String( "'" );
-    expr += QgsWFSUtils::getMD5( featureList[i].first );
-    expr += QLatin1String( "'" );
-
-    if ( ( i > 0 && ( i % 1000 ) == 0 ) || i + 1 == featureList.size() )
-    {
-      expr += QLatin1String( ")" );
-
-      QgsFeatureRequest request;
-      request.setFilterExpression( expr );
-
-      QgsAttributeList attList;
-      attList.append( md5Idx );
-      request.setSubsetOfAttributes( attList );
+  }
+}
 
-      QgsFeatureIterator iterMD5s( mCacheDataProvider->getFeatures( request ) );
-      QgsFeature gmlidFeature;
-      while ( iterMD5s.nextFeature( gmlidFeature ) )
-      {
-        const QVariant &v = gmlidFeature.attributes().value( md5Idx );
-        setExistingMD5.insert( v.toString() );
-      }
+bool QgsWFSSharedData::tilesCached( const QgsRectangle &rect ) const
+{
+  if ( mCachedTiles.isEmpty() )
+    return false;
 
-      first = true;
+  int minCol, minRow, maxCol, maxRow;
+  if ( !tileRange( rect, false, minCol, minRow, maxCol, maxRow ) )
+    return false;
+  if ( static_cast< qint64 >( maxCol - minCol + 1 ) * ( maxRow - minRow + 1 ) > mCachedTiles.size() )
+    return false;
+  for ( int row = minRow; row <= maxRow; ++row )
+  {
+    for ( int col = minCol; col <= maxCol; ++col )
+    {
+      if ( !mCachedTiles.contains( qMakePair( col, row ) ) )
+        return false;
     }
-
   }
-
-  return setExistingMD5;
+  return true;
 }
 
 // Used by WFS-T
@@ -708,6 +704,30 @@ bool QgsWFSSharedData::deleteFeatures( const QgsFeatureIds &fidlist )
     mFeatureCount -= fidlist.size();
   }
 
+  QMutexLocker lockerWrite( &mCacheWriteMutex );
+
+  // Forget the identifiers of the deleted features, so that they can be
+  // cached again if the server returns them later.
+  QgsFields dataProviderFields = mCacheDataProvider->fields();
+  const int gmlidIdx = dataProviderFields.indexFromName( QgsWFSConstants::FIELD_GMLID );
+  const int md5Idx = dataProviderFields.indexFromName( QgsWFSConstants::FIELD_MD5 );
+  QgsAttributeList attList;
+  attList.append( gmlidIdx );
+  if ( md5Idx >= 0 )
+    attList.append( md5Idx );
+  QgsFeatureRequest request;
+  request.setFilterFids( fidlist );
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  request.setSubsetOfAttributes( attList );
+  QgsFeatureIterator iter( mCacheDataProvider->getFeatures( request ) );
+  QgsFeature f;
+  while ( iter.nextFeature( f ) )
+  {
+    mCachedGmlIds.remove( f.attribute( gmlidIdx ).toString() );
+    if ( md5Idx >= 0 )
+      mCachedMD5s.remove( f.attribute( md5Idx ).toString() );
+  }
+
   return mCacheDataProvider->deleteFeatures( fidlist );
 }
 
@@ -812,14 +832,18 @@ void QgsWFSSharedData::serializeFeatures( QVector<QgsWFSFeatureGmlIdPair> &featu
   Q_ASSERT( hexwkbGeomIdx >= 0 );
   int md5Idx = ( mDistinctSelect ) ? dataProviderFields.indexFromName( QgsWFSConstants::FIELD_MD5 ) : -1;
 
-  QSet<QString> existingGmlIds;
-  QSet<QString> existingMD5s;
-  if ( mDistinctSelect )
-    existingMD5s = getExistingCachedMD5( featureList );
-  else
-    existingGmlIds = getExistingCachedGmlIds( featureList );
+  // In case we would a WFS-T insert, while another thread download features,
+  // take a mutex. It also protects the in-memory sets of cached identifiers,
+  // which avoid querying the cache database to detect duplicates.
+  QMutexLocker lockerWrite( &mCacheWriteMutex );
+
   QVector<QgsWFSFeatureGmlIdPair> updatedFeatureList;
 
+  // Identifiers of this batch. They are only recorded as cached once the
+  // features have been successfully added to the cache
+  QSet<QString> batchMD5s;
+  QSet<QString> batchGmlIds;
+
   QgsRectangle localComputedExtent( mComputedExtent );
   Q_FOREACH ( const QgsWFSFeatureGmlIdPair &featPair, featureList )
   {
@@ -830,9 +854,9 @@ void QgsWFSSharedData::serializeFeatures( QVector<QgsWFSFeatureGmlIdPair> &featu
     if ( mDistinctSelect )
     {
       md5 = QgsWFSUtils::getMD5( gmlFeature );
-      if ( existingMD5s.contains( md5 ) )
+      if ( mCachedMD5s.contains( md5 ) || batchMD5s.contains( md5 ) )
         continue;
-      existingMD5s.insert( md5 );
+      batchMD5s.insert( md5 );
     }
     else
     {
@@ -840,7 +864,7 @@ void QgsWFSSharedData::serializeFeatures( QVector<QgsWFSFeatureGmlIdPair> &featu
       {
         // Shouldn't happen on sane datasets.
       }
-      else if ( existingGmlIds.contains( gmlId ) )
+      else if ( mCachedGmlIds.contains( gmlId ) || batchGmlIds.contains( gmlId ) )
       {
         if ( mRect.isEmpty() )
         {
@@ -850,7 +874,7 @@ void QgsWFSSharedData::serializeFeatures( QVector<QgsWFSFeatureGmlIdPair> &featu
       }
       else
       {
-        existingGmlIds.insert( gmlId );
+        batchGmlIds.insert( gmlId );
       }
     }
 
@@ -910,11 +934,13 @@ void QgsWFSSharedData::serializeFeatures( QVector<QgsWFSFeatureGmlIdPair> &featu
     featureListToCache.push_back( cachedFeature );
   }
 
-  // In case we would a WFS-T insert, while another thread download features,
-  // take a mutex
   {
-    QMutexLocker lockerWrite( &mCacheWriteMutex );
     bool cacheOk = mCacheDataProvider->addFeatures( featureListToCache );
+    if ( cacheOk )
+    {
+      mCachedMD5s.unite( batchMD5s );
+      mCachedGmlIds.unite( batchGmlIds );
+    }
 
     // Update the feature ids of the non-cached feature, i.e. the one that
     // will be notified to the user, from the feature id of the database
@@ -946,6 +972,7 @@ void QgsWFSSharedData::serializeFeatures( QVector<QgsWFSFeatureGmlIdPair> &featu
       }
     }
   }
+  lockerWrite.unlock();
 
   featureList = updatedFeatureList;
 
@@ -1024,6 +1051,7 @@ void QgsWFSSharedData::endOfDownload( bool success, int featureCount,
     {
       mRegions.clear();
       mCachedRegions = QgsSpatialIndex();
+      mCachedTiles.clear();
     }
 
     if ( mRequestLimit == 0 )
@@ -1038,6 +1066,9 @@ void QgsWFSSharedData::endOfDownload( bool success, int featureCount,
       f.setAttribute( 0, QVariant( bDownloadLimit ) );
       mRegions.push_back( f );
       mCachedRegions.addFeature( f );
+
+      if ( !bDownloadLimit )
+        markTilesAsCached( mRect );
     }
   }
 
@@ -1078,12 +1109,19 @@ void QgsWFSSharedData::invalidateCache()
 // to prevent deadlock when waiting the end of the downloader thread that will try to take the mutex in serializeFeatures()
   mMutex.unlock();
   delete mDownloader;
+  {
+    QMutexLocker lockerWrite( &mCacheWriteMutex );
+    mCachedGmlIds.clear();
+    mCachedMD5s.clear();
+  }
   mMutex.lock();
   mDownloader = nullptr;
   mDownloadFinished = false;
   mGenCounter = 0;
   mCachedRegions = QgsSpatialIndex();
   mRegions.clear();
+  mCachedTiles.clear();
+  mTileSize = 0;
   mRect = QgsRectangle();
   mRequestLimit = 0;
   mGetFeatureHitsIssued = false;
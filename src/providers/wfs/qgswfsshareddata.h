@@ -242,6 +242,21 @@ class QgsWFSSharedData : public QObject
     //! Requested cached regions
     QVector< QgsFeature > mRegions;
 
+    //! Origin of the tile grid used to track fully downloaded areas. Valid if mTileSize > 0
+    QgsPointXY mTileOrigin;
+
+    //! Size of a tile of the grid, in source CRS units. 0 = grid not initialized yet
+    double mTileSize = 0;
+
+    //! Tiles (column, row) of the grid whose features have been fully downloaded
+    QSet< QPair<int, int> > mCachedTiles;
+
+    //! gml:id of the features stored in the cache. Protected by mCacheWriteMutex
+    QSet<QString> mCachedGmlIds;
+
+    //! MD5 of the features stored in the cache (SELECT DISTINCT case). Protected by mCacheWriteMutex
+    QSet<QString> mCachedMD5s;
+
     //! Whether a GetFeature hits request has been issued to retrieve the number of features
     bool mGetFeatureHitsIssued;
 
@@ -252,14 +267,16 @@ class QgsWFSSharedData : public QObject
     bool mTryFetchingOneFeature;
 
     /**
-     * Returns the set of gmlIds that have already been downloaded and
-        cached, so as to avoid to cache duplicates. */
-    QSet<QString> getExistingCachedGmlIds( const QVector<QgsWFSFeatureGmlIdPair> &featureList );
+     * Computes the range of tiles of the grid that intersect \a rect (if \a inner is false)
+        or are fully included in it (if \a inner is true). Returns false if the
+        grid is not initialized, if the range is empty or too large to be tracked. */
+    bool tileRange( const QgsRectangle &rect, bool inner, int &minCol, int &minRow, int &maxCol, int &maxRow ) const;
 
-    /**
-     * Returns the set of md5 of features that have already been downloaded and
-        cached, so as to avoid to cache duplicates. */
-    QSet<QString> getExistingCachedMD5( const QVector<QgsWFSFeatureGmlIdPair> &featureList );
+    //! Records the tiles fully included in \a rect as downloaded
+    void markTilesAsCached( const QgsRectangle &rect );
+
+    //! Returns whether all the tiles intersecting \a rect have already been downloaded
+    bool tilesCached( const QgsRectangle &rect ) const;
 
     //! Create the on-disk cache and connect to it
     bool createCache();
@@ -18,6 +18,7 @@
 #include "qgsconfigcache.h"
 #include "qgsmessagelog.h"
 #include "qgsaccesscontrol.h"
+#include "qgsserversettings.h"
 
 #include <QFile>
 
@@ -36,11 +37,12 @@ QgsConfigCache::QgsConfigCache()
   QObject::connect( &mFileSystemWatcher, &QFileSystemWatcher::fileChanged, this, &QgsConfigCache::removeChangedEntry );
 }
 
-const QgsProject *QgsConfigCache::project( const QString &path )
+const QgsProject *QgsConfigCache::project( const QString &path, const QgsServerSettings *settings )
 {
   if ( ! mProjectCache[ path ] )
   {
     std::unique_ptr<QgsProject> prj( new QgsProject() );
+    prj->setDeferredLayerLoading( settings && settings->deferredLayerLoading() );
     if ( prj->read( path ) )
     {
       mProjectCache.insert( path, prj.release() );
@@ -30,6 +30,8 @@
 #include "qgis_sip.h"
 #include "qgsproject.h"
 
+class QgsServerSettings;
+
 /**
  * \ingroup server
  * \brief Cache for server configuration.
@@ -55,10 +57,12 @@ class SERVER_EXPORT QgsConfigCache : public QObject
      * If the project is not cached yet, then the project is read thanks to the
      * path. If the project is not available, then a nullptr is returned.
      * \param path the filename of the QGIS project
+     * \param settings the server settings, used to defer the loading of the project
+     * layers if QgsServerSettings::deferredLayerLoading() is activated (since QGIS 3.6)
      * \returns the project or nullptr if an error happened
      * \since QGIS 3.0
      */
-    const QgsProject *project( const QString &path );
+    const QgsProject *project( const QString &path, const QgsServerSettings *settings = nullptr );
 
   private:
     QgsConfigCache() SIP_FORCE;
@@ -317,7 +317,7 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
         QString configFilePath = configPath( *sConfigFilePath, params.map() );
 
         // load the project if needed and not empty
-        project = mConfigCache->project( configFilePath );
+        project = mConfigCache->project( configFilePath, &sSettings );
         if ( ! project )
         {
           throw QgsServerException( QStringLiteral( "Project file error" ) );
@@ -141,6 +141,28 @@ void QgsServerSettings::initSettings()
                                QVariant()
                              };
   mSettings[ sCacheSize.envVar ] = sCacheSize;
+
+  // deferred layer loading
+  const Setting sDeferredLoading = { QgsServerSettingsEnv::QGIS_SERVER_DEFERRED_LAYER_LOADING,
+                                     QgsServerSettingsEnv::DEFAULT_VALUE,
+                                     "Activate/Deactivate the loading of project layers only when a request uses them",
+                                     "/qgis/server_deferred_layer_loading",
+                                     QVariant::Bool,
+                                     QVariant( false ),
+                                     QVariant()
+                                   };
+  mSettings[ sDeferredLoading.envVar ] = sDeferredLoading;
+
+  // streaming buffer size
+  const Setting sStreamingBufferSize = { QgsServerSettingsEnv::QGIS_SERVER_STREAMING_BUFFER_SIZE,
+                                         QgsServerSettingsEnv::DEFAULT_VALUE,
+                                         "Specify the size of the buffer used to stream large responses (0 to disable streaming)",
+                                         "/qgis/server_streaming_buffer_size",
+                                         QVariant::LongLong,
+                                         QVariant( 64 * 1024 ),
+                                         QVariant()
+                                       };
+  mSettings[ sStreamingBufferSize.envVar ] = sStreamingBufferSize;
 }
 
 void QgsServerSettings::load()
@@ -321,3 +343,13 @@ QString QgsServerSettings::cacheDirectory() const
 {
   return value( QgsServerSettingsEnv::QGIS_SERVER_CACHE_DIRECTORY ).toString();
 }
+
+bool QgsServerSettings::deferredLayerLoading() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_DEFERRED_LAYER_LOADING ).toBool();
+}
+
+qint64 QgsServerSettings::streamingBufferSize() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_STREAMING_BUFFER_SIZE ).toLongLong();
+}
@@ -60,7 +60,9 @@ class SERVER_EXPORT QgsServerSettingsEnv : public QObject
       QGIS_PROJECT_FILE,
       MAX_CACHE_LAYERS,
       QGIS_SERVER_CACHE_DIRECTORY,
-      QGIS_SERVER_CACHE_SIZE
+      QGIS_SERVER_CACHE_SIZE,
+      QGIS_SERVER_DEFERRED_LAYER_LOADING,
+      QGIS_SERVER_STREAMING_BUFFER_SIZE
     };
     Q_ENUM( EnvVar )
 };
@@ -168,6 +170,24 @@ class SERVER_EXPORT QgsServerSettings
       */
     QString cacheDirectory() const;
 
+    /**
+     * Returns whether the loading of the layers of projects is deferred until a
+     * request uses them.
+     * \returns true if the loading of layers is deferred, false otherwise.
+     * \see QgsProject::setDeferredLayerLoading()
+     * \since QGIS 3.6
+     */
+    bool deferredLayerLoading() const;
+
+    /**
+     * Returns the size of the buffer used to stream large responses, in bytes.
+     * Responses are sent in chunks once they buffer more than this size, while
+     * 0 disables these intermediate flushes.
+     * \returns the size of the streaming buffer.
+     * \since QGIS 3.6
+     */
+    qint64 streamingBufferSize() const;
+
   private:
     void initSettings();
     QVariant value( QgsServerSettingsEnv::EnvVar envVar ) const;
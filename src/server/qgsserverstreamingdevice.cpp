@@ -0,0 +1,79 @@
+/***************************************************************************
+                          qgsserverstreamingdevice.cpp
+
+  Define an output device streaming data to a server response
+  -------------------
+  begin                : 2018-10-18
+  copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsserverstreamingdevice.h"
+#include "qgsserverresponse.h"
+
+QgsServerStreamingDevice::QgsServerStreamingDevice( QgsServerResponse &response, qint64 bufferSize )
+  : mResponse( response )
+  , mBufferSize( bufferSize )
+{
+  open( QIODevice::WriteOnly );
+}
+
+QgsServerStreamingDevice::~QgsServerStreamingDevice()
+{
+  close();
+}
+
+bool QgsServerStreamingDevice::isSequential() const
+{
+  return true;
+}
+
+void QgsServerStreamingDevice::close()
+{
+  if ( !isOpen() )
+    return;
+
+  // once streamed, the response has no content length: send the tail right away
+  if ( mResponse.headersSent() )
+    mResponse.flush();
+
+  QIODevice::close();
+}
+
+qint64 QgsServerStreamingDevice::readData( char *data, qint64 maxSize )
+{
+  Q_UNUSED( data );
+  Q_UNUSED( maxSize );
+  return -1;
+}
+
+qint64 QgsServerStreamingDevice::writeData( const char *data, qint64 maxSize )
+{
+  QIODevice *buffer = mResponse.io();
+  if ( !buffer )
+  {
+    setErrorString( QStringLiteral( "The server response has no output device" ) );
+    return -1;
+  }
+
+  const qint64 written = mResponse.write( data, maxSize );
+  if ( written <= 0 && maxSize > 0 )
+  {
+    setErrorString( QStringLiteral( "Unable to write to the server response: %1" ).arg( buffer->errorString() ) );
+    return -1;
+  }
+
+  // responses empty their buffer when they are flushed
+  if ( mBufferSize > 0 && buffer->size() >= mBufferSize )
+    mResponse.flush();
+
+  return written;
+}
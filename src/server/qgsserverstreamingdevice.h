@@ -0,0 +1,84 @@
+/***************************************************************************
+                          qgsserverstreamingdevice.h
+
+  Define an output device streaming data to a server response
+  -------------------
+  begin                : 2018-10-18
+  copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSSERVERSTREAMINGDEVICE_H
+#define QGSSERVERSTREAMINGDEVICE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_server.h"
+
+#include <QIODevice>
+
+class QgsServerResponse;
+
+/**
+ * \ingroup server
+ * \class QgsServerStreamingDevice
+ * \brief Write only device streaming its content to a server response.
+ *
+ * Data written to the device is appended to the response, which is flushed as soon as
+ * it buffers more than the buffer size. Large outputs are thus sent in chunks while
+ * they are produced, with a bounded memory usage. Outputs smaller than the buffer size
+ * are left in the response buffer, so that they are sent with a content length when
+ * the response is finished.
+ *
+ * A buffer size of 0 or less disables the intermediate flushes, and the whole output is
+ * buffered by the response.
+ *
+ * Once the response has been flushed its headers are sent, so errors cannot be reported
+ * with a new response any more. Writing fails if the response cannot take the data, and
+ * the reason is available through errorString().
+ *
+ * \since QGIS 3.6
+ */
+class SERVER_EXPORT QgsServerStreamingDevice : public QIODevice
+{
+  public:
+
+    //! Default size of the response buffer, in bytes
+    static const qint64 DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * Constructor for QgsServerStreamingDevice, writing to \a response and flushing it
+     * when it buffers more than \a bufferSize bytes. The device is opened write only.
+     */
+    explicit QgsServerStreamingDevice( QgsServerResponse &response, qint64 bufferSize = DEFAULT_BUFFER_SIZE );
+
+    //! Closes the device, flushing the remaining data if the response is already streamed
+    ~QgsServerStreamingDevice() override;
+
+    bool isSequential() const override;
+
+    /**
+     * Closes the device. If the response has already been flushed, the data it still
+     * buffers is flushed too, so that the whole output is sent once the device is closed.
+     */
+    void close() override;
+
+  protected:
+
+    qint64 readData( char *data, qint64 maxSize ) override;
+    qint64 writeData( const char *data, qint64 maxSize ) override;
+
+  private:
+
+    QgsServerResponse &mResponse;
+    qint64 mBufferSize;
+};
+
+#endif
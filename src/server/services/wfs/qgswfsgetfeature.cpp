@@ -36,10 +36,13 @@
 #include "qgsproject.h"
 #include "qgsogcutils.h"
 #include "qgsjsonutils.h"
+#include "qgsserverstreamingdevice.h"
+#include "qgsserversettings.h"
 
 #include "qgswfsgetfeature.h"
 
 #include <QStringList>
+#include <QTextStream>
 
 namespace QgsWfs
 {
@@ -67,9 +70,17 @@ namespace QgsWfs
 
     QString encodeValueToText( const QVariant &value, const QgsEditorWidgetSetup &setup );
 
-    QDomElement createFeatureGML2( QgsFeature *feat, QDomDocument &doc, const createFeatureParams &params, const QgsProject *project );
+    QString createFeatureGML2( QgsFeature *feat, const createFeatureParams &params, const QgsProject *project );
 
-    QDomElement createFeatureGML3( QgsFeature *feat, QDomDocument &doc, const createFeatureParams &params, const QgsProject *project );
+    QString createFeatureGML3( QgsFeature *feat, const createFeatureParams &params, const QgsProject *project );
+
+    QString featureMemberToText( const QString &typeName, const QString &idAttribute, const QString &content, QgsFeature *feat );
+
+    QString attributesToText( QgsFeature *feat, const createFeatureParams &params );
+
+    QString geometryToText( const QDomElement &gmlElem, int depth );
+
+    QString xmlEscaped( const QString &value, bool attribute );
 
     void hitGetFeature( const QgsServerRequest &request, QgsServerResponse &response, const QgsProject *project,
                         QgsWfsParameters::Format format, int numberOfFeatures, const QStringList &typeNames );
@@ -78,10 +89,10 @@ namespace QgsWfs
                           QgsWfsParameters::Format format, int prec, QgsCoordinateReferenceSystem &crs,
                           QgsRectangle *rect, const QStringList &typeNames );
 
-    void setGetFeature( QgsServerResponse &response, QgsWfsParameters::Format format, QgsFeature *feat, int featIdx,
+    void setGetFeature( QIODevice &output, QgsWfsParameters::Format format, QgsFeature *feat, int featIdx,
                         const createFeatureParams &params, const QgsProject *project );
 
-    void endGetFeature( QgsServerResponse &response, QgsWfsParameters::Format format );
+    void endGetFeature( QIODevice &output, QgsWfsParameters::Format format );
 
     QgsServerRequest::Parameters mRequestParameters;
     QgsWfsParameters mWfsParameters;
@@ -192,6 +203,8 @@ namespace QgsWfs
     long iteratedFeatures = 0;
     // sent features
     QgsFeature feature;
+    // features are written in chunks of bounded size
+    QgsServerStreamingDevice stream( response, serverIface->serverSettings()->streamingBufferSize() );
     qIt = aRequest.queries.begin();
     for ( ; qIt != aRequest.queries.end(); ++qIt )
     {
@@ -406,7 +419,7 @@ namespace QgsWfs
 
           if ( iteratedFeatures >= aRequest.startIndex )
           {
-            setGetFeature( response, aRequest.outputFormat, &feature, sentFeatures, cfp, project );
+            setGetFeature( stream, aRequest.outputFormat, &feature, sentFeatures, cfp, project );
             ++sentFeatures;
           }
           ++iteratedFeatures;
@@ -428,7 +441,7 @@ namespace QgsWfs
       // End of GetFeature
       if ( iteratedFeatures <= aRequest.startIndex )
         startGetFeature( request, response, project, aRequest.outputFormat, requestPrecision, requestCrs, &requestRect, typeNameList );
-      endGetFeature( response, aRequest.outputFormat );
+      endGetFeature( stream, aRequest.outputFormat );
     }
 
   }
@@ -1171,7 +1184,7 @@ namespace QgsWfs
       }
     }
 
-    void setGetFeature( QgsServerResponse &response, QgsWfsParameters::Format format, QgsFeature *feat, int featIdx,
+    void setGetFeature( QIODevice &output, QgsWfsParameters::Format format, QgsFeature *feat, int featIdx,
                         const createFeatureParams &params, const QgsProject *project )
     {
       if ( !feat->isValid() )
@@ -1191,30 +1204,19 @@ namespace QgsWfs
         fcString += createFeatureGeoJSON( feat, params );
         fcString += QLatin1String( "\n" );
 
-        response.write( fcString.toUtf8() );
+        output.write( fcString.toUtf8() );
+      }
+      else if ( format == QgsWfsParameters::Format::GML3 )
+      {
+        output.write( createFeatureGML3( feat, params, project ).toUtf8() );
       }
       else
       {
-        QDomDocument gmlDoc;
-        QDomElement featureElement;
-        if ( format == QgsWfsParameters::Format::GML3 )
-        {
-          featureElement = createFeatureGML3( feat, gmlDoc, params, project );
-          gmlDoc.appendChild( featureElement );
-        }
-        else
-        {
-          featureElement = createFeatureGML2( feat, gmlDoc, params, project );
-          gmlDoc.appendChild( featureElement );
-        }
-        response.write( gmlDoc.toByteArray() );
+        output.write( createFeatureGML2( feat, params, project ).toUtf8() );
       }
-
-      // Stream partial content
-      response.flush();
     }
 
-    void endGetFeature( QgsServerResponse &response, QgsWfsParameters::Format format )
+    void endGetFeature( QIODevice &output, QgsWfsParameters::Format format )
     {
       QString fcString;
       if ( format == QgsWfsParameters::Format::GeoJSON )
@@ -1226,7 +1228,7 @@ namespace QgsWfs
       {
         fcString = QStringLiteral( "</wfs:FeatureCollection>\n" );
       }
-      response.write( fcString.toUtf8() );
+      output.write( fcString.toUtf8() );
     }
 
 
@@ -1258,15 +1260,9 @@ namespace QgsWfs
     }
 
 
-    QDomElement createFeatureGML2( QgsFeature *feat, QDomDocument &doc, const createFeatureParams &params, const QgsProject *project )
+    QString createFeatureGML2( QgsFeature *feat, const createFeatureParams &params, const QgsProject *project )
     {
-      //gml:FeatureMember
-      QDomElement featureElement = doc.createElement( QStringLiteral( "gml:featureMember" )/*wfs:FeatureMember*/ );
-
-      //qgs:%TYPENAME%
-      QDomElement typeNameElement = doc.createElement( "qgs:" + params.typeName /*qgs:%TYPENAME%*/ );
-      typeNameElement.setAttribute( QStringLiteral( "fid" ), params.typeName + "." + QString::number( feat->id() ) );
-      featureElement.appendChild( typeNameElement );
+      QString content;
 
       //add geometry column (as gml)
       QgsGeometry geom = feat->geometry();
@@ -1291,7 +1287,8 @@ namespace QgsWfs
           Q_UNUSED( cse );
         }
 
-        QDomElement geomElem = doc.createElement( QStringLiteral( "qgs:geometry" ) );
+        // only the geometry element is built with a document, the geometry GML writers being DOM based
+        QDomDocument doc;
         QDomElement gmlElem;
         if ( params.geometryName == QLatin1String( "EXTENT" ) )
         {
@@ -1315,55 +1312,36 @@ namespace QgsWfs
         if ( !gmlElem.isNull() )
         {
           QgsRectangle box = geom.boundingBox();
-          QDomElement bbElem = doc.createElement( QStringLiteral( "gml:boundedBy" ) );
-          QDomElement boxElem = QgsOgcUtils::rectangleToGMLBox( &box, doc, prec );
-
+          QString srsAttribute;
           if ( crs.isValid() )
           {
-            boxElem.setAttribute( QStringLiteral( "srsName" ), crs.authid() );
+            srsAttribute = QStringLiteral( " srsName=\"%1\"" ).arg( xmlEscaped( crs.authid(), true ) );
             gmlElem.setAttribute( QStringLiteral( "srsName" ), crs.authid() );
           }
 
-          bbElem.appendChild( boxElem );
-          typeNameElement.appendChild( bbElem );
-
-          geomElem.appendChild( gmlElem );
-          typeNameElement.appendChild( geomElem );
+          content += QLatin1String( "  <gml:boundedBy>\n" );
+          content += QLatin1String( "   <gml:Box" ) + srsAttribute + QLatin1String( ">\n" );
+          content += QLatin1String( "    <gml:coordinates cs=\",\" ts=\" \">" );
+          content += qgsDoubleToString( box.xMinimum(), prec ) + ',' + qgsDoubleToString( box.yMinimum(), prec ) + ' ';
+          content += qgsDoubleToString( box.xMaximum(), prec ) + ',' + qgsDoubleToString( box.yMaximum(), prec );
+          content += QLatin1String( "</gml:coordinates>\n" );
+          content += QLatin1String( "   </gml:Box>\n" );
+          content += QLatin1String( "  </gml:boundedBy>\n" );
+
+          content += QLatin1String( "  <qgs:geometry>\n" );
+          content += geometryToText( gmlElem, 3 );
+          content += QLatin1String( "  </qgs:geometry>\n" );
         }
       }
 
-      //read all attribute values from the feature
-      QgsAttributes featureAttributes = feat->attributes();
-      QgsFields fields = feat->fields();
-      for ( int i = 0; i < params.attributeIndexes.count(); ++i )
-      {
-        int idx = params.attributeIndexes[i];
-        if ( idx >= fields.count() )
-        {
-          continue;
-        }
-        const QgsField field = fields.at( idx );
-        const QgsEditorWidgetSetup setup = field.editorWidgetSetup();
-        QString attributeName = field.name();
+      content += attributesToText( feat, params );
 
-        QDomElement fieldElem = doc.createElement( "qgs:" + attributeName.replace( ' ', '_' ).replace( cleanTagNameRegExp, QString() ) );
-        QDomText fieldText = doc.createTextNode( encodeValueToText( featureAttributes[idx], setup ) );
-        fieldElem.appendChild( fieldText );
-        typeNameElement.appendChild( fieldElem );
-      }
-
-      return featureElement;
+      return featureMemberToText( params.typeName, QStringLiteral( "fid" ), content, feat );
     }
 
-    QDomElement createFeatureGML3( QgsFeature *feat, QDomDocument &doc, const createFeatureParams &params, const QgsProject *project )
+    QString createFeatureGML3( QgsFeature *feat, const createFeatureParams &params, const QgsProject *project )
     {
-      //gml:FeatureMember
-      QDomElement featureElement = doc.createElement( QStringLiteral( "gml:featureMember" )/*wfs:FeatureMember*/ );
-
-      //qgs:%TYPENAME%
-      QDomElement typeNameElement = doc.createElement( "qgs:" + params.typeName /*qgs:%TYPENAME%*/ );
-      typeNameElement.setAttribute( QStringLiteral( "gml:id" ), params.typeName + "." + QString::number( feat->id() ) );
-      featureElement.appendChild( typeNameElement );
+      QString content;
 
       //add geometry column (as gml)
       QgsGeometry geom = feat->geometry();
@@ -1388,7 +1366,8 @@ namespace QgsWfs
           Q_UNUSED( cse );
         }
 
-        QDomElement geomElem = doc.createElement( QStringLiteral( "qgs:geometry" ) );
+        // only the geometry element is built with a document, the geometry GML writers being DOM based
+        QDomDocument doc;
         QDomElement gmlElem;
         if ( params.geometryName == QLatin1String( "EXTENT" ) )
         {
@@ -1412,23 +1391,61 @@ namespace QgsWfs
         if ( !gmlElem.isNull() )
         {
           QgsRectangle box = geom.boundingBox();
-          QDomElement bbElem = doc.createElement( QStringLiteral( "gml:boundedBy" ) );
-          QDomElement boxElem = QgsOgcUtils::rectangleToGMLEnvelope( &box, doc, prec );
-
+          QString srsAttribute;
           if ( crs.isValid() )
           {
-            boxElem.setAttribute( QStringLiteral( "srsName" ), crs.authid() );
+            srsAttribute = QStringLiteral( " srsName=\"%1\"" ).arg( xmlEscaped( crs.authid(), true ) );
             gmlElem.setAttribute( QStringLiteral( "srsName" ), crs.authid() );
           }
 
-          bbElem.appendChild( boxElem );
-          typeNameElement.appendChild( bbElem );
-
-          geomElem.appendChild( gmlElem );
-          typeNameElement.appendChild( geomElem );
+          content += QLatin1String( "  <gml:boundedBy>\n" );
+          content += QLatin1String( "   <gml:Envelope" ) + srsAttribute + QLatin1String( ">\n" );
+          content += QLatin1String( "    <gml:lowerCorner>" );
+          content += qgsDoubleToString( box.xMinimum(), prec ) + ' ' + qgsDoubleToString( box.yMinimum(), prec );
+          content += QLatin1String( "</gml:lowerCorner>\n" );
+          content += QLatin1String( "    <gml:upperCorner>" );
+          content += qgsDoubleToString( box.xMaximum(), prec ) + ' ' + qgsDoubleToString( box.yMaximum(), prec );
+          content += QLatin1String( "</gml:upperCorner>\n" );
+          content += QLatin1String( "   </gml:Envelope>\n" );
+          content += QLatin1String( "  </gml:boundedBy>\n" );
+
+          content += QLatin1String( "  <qgs:geometry>\n" );
+          content += geometryToText( gmlElem, 3 );
+          content += QLatin1String( "  </qgs:geometry>\n" );
         }
       }
 
+      content += attributesToText( feat, params );
+
+      return featureMemberToText( params.typeName, QStringLiteral( "gml:id" ), content, feat );
+    }
+
+    QString featureMemberToText( const QString &typeName, const QString &idAttribute, const QString &content, QgsFeature *feat )
+    {
+      //gml:FeatureMember
+      QString text = QStringLiteral( "<gml:featureMember>\n" );
+
+      //qgs:%TYPENAME%
+      text += QLatin1String( " <qgs:" ) + typeName + ' ' + idAttribute + QLatin1String( "=\"" );
+      text += xmlEscaped( typeName + '.' + QString::number( feat->id() ), true ) + '"';
+      if ( content.isEmpty() )
+      {
+        text += QLatin1String( "/>\n" );
+      }
+      else
+      {
+        text += QLatin1String( ">\n" ) + content;
+        text += QLatin1String( " </qgs:" ) + typeName + QLatin1String( ">\n" );
+      }
+
+      text += QLatin1String( "</gml:featureMember>\n" );
+      return text;
+    }
+
+    QString attributesToText( QgsFeature *feat, const createFeatureParams &params )
+    {
+      QString text;
+
       //read all attribute values from the feature
       QgsAttributes featureAttributes = feat->attributes();
       QgsFields fields = feat->fields();
@@ -1442,14 +1459,59 @@ namespace QgsWfs
         const QgsField field = fields.at( idx );
         const QgsEditorWidgetSetup setup = field.editorWidgetSetup();
         QString attributeName = field.name();
+        const QString tagName = "qgs:" + attributeName.replace( ' ', '_' ).replace( cleanTagNameRegExp, QString() );
 
-        QDomElement fieldElem = doc.createElement( "qgs:" + attributeName.replace( ' ', '_' ).replace( cleanTagNameRegExp, QString() ) );
-        QDomText fieldText = doc.createTextNode( encodeValueToText( featureAttributes[idx], setup ) );
-        fieldElem.appendChild( fieldText );
-        typeNameElement.appendChild( fieldElem );
+        text += QLatin1String( "  <" ) + tagName + '>';
+        text += xmlEscaped( encodeValueToText( featureAttributes[idx], setup ), false );
+        text += QLatin1String( "</" ) + tagName + QLatin1String( ">\n" );
       }
 
-      return featureElement;
+      return text;
+    }
+
+    QString geometryToText( const QDomElement &gmlElem, int depth )
+    {
+      QString elementText;
+      QTextStream stream( &elementText );
+      gmlElem.save( stream, 1 );
+      stream.flush();
+
+      const QString indent( depth, ' ' );
+      QString text;
+      const QStringList lines = elementText.split( '\n', QString::SkipEmptyParts );
+      for ( const QString &line : lines )
+      {
+        text += indent + line + '\n';
+      }
+      return text;
+    }
+
+    QString xmlEscaped( const QString &value, bool attribute )
+    {
+      // same escaping as QDomDocument, so that the output does not depend on the writer
+      QString escaped;
+      escaped.reserve( value.size() );
+      for ( int i = 0; i < value.size(); ++i )
+      {
+        const QChar c = value.at( i );
+        if ( c == '<' )
+          escaped += QLatin1String( "&lt;" );
+        else if ( c == '&' )
+          escaped += QLatin1String( "&amp;" );
+        else if ( c == '>' && i >= 2 && value.at( i - 1 ) == ']' && value.at( i - 2 ) == ']' )
+          escaped += QLatin1String( "&gt;" );
+        else if ( attribute && c == '"' )
+          escaped += QLatin1String( "&quot;" );
+        else if ( attribute && c == '\n' )
+          escaped += QLatin1String( "&#xa;" );
+        else if ( attribute && c == '\t' )
+          escaped += QLatin1String( "&#x9;" );
+        else if ( c == '\r' )
+          escaped += QLatin1String( "&#xd;" );
+        else
+          escaped += c;
+      }
+      return escaped;
     }
 
     QString encodeValueToText( const QVariant &value, const QgsEditorWidgetSetup &setup )
@@ -20,6 +20,8 @@ email                : david dot marteau at 3liz dot com
 #include "qgsmaplayer.h"
 #include "qgsvectorlayer.h"
 #include "qgsdxfexport.h"
+#include "qgsserverstreamingdevice.h"
+#include "qgsserversettings.h"
 #include "qgswmsrenderer.h"
 
 namespace QgsWms
@@ -69,9 +71,11 @@ namespace QgsWms
       codec = formatOptionsMap.value( QStringLiteral( "CODEC" ) );
     }
 
-    // Write output
+    // Write output, large exports are streamed while they are written
     response.setHeader( "Content-Type", "application/dxf" );
-    dxf.writeToFile( response.io(), codec );
+    QgsServerStreamingDevice stream( response, serverIface->serverSettings()->streamingBufferSize() );
+    dxf.writeToFile( &stream, codec );
+    stream.close();
   }
 
 
@@ -26,6 +26,10 @@ QgsLayerRestorer::QgsLayerRestorer( const QList<QgsMapLayer *> &layers )
 {
   for ( QgsMapLayer *layer : layers )
   {
+    // layers not used by the request are not loaded, and so not modified
+    if ( layer->isLoadingDeferred() )
+      continue;
+
     QgsLayerSettings settings;
     settings.name = layer->name();
 
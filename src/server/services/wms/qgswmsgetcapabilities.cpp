@@ -1020,7 +1020,8 @@ namespace QgsWms
             if ( l->type() == QgsMapLayer::VectorLayer )
             {
               QgsVectorLayer *vl = qobject_cast<QgsVectorLayer *>( l );
-              if ( vl && vl->featureCount() == 0 )
+              // do not load a deferred layer just to count its features
+              if ( vl && !vl->isLoadingDeferred() && vl->featureCount() == 0 )
               {
                 // if there's no feature, use the wms extent defined in the
                 // project...
@@ -1692,6 +1693,10 @@ namespace QgsWms
       if ( currentLayer->type() == QgsMapLayer::VectorLayer )
       {
         QgsVectorLayer *vLayer = static_cast<QgsVectorLayer *>( currentLayer );
+
+        // attributes are read from the data provider
+        vLayer->completeDeferredLoading();
+
         const QSet<QString> &excludedAttributes = vLayer->excludeAttributesWms();
 
         int displayFieldIdx = -1;
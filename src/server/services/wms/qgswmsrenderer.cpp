@@ -138,6 +138,7 @@ namespace QgsWms
 
     initRestrictedLayers();
     initNicknameLayers();
+    loadDeferredLayers();
   }
 
   QgsRenderer::~QgsRenderer()
@@ -307,6 +308,9 @@ namespace QgsWms
     QgsMapSettings mapSettings;
     configureMapSettings( image.get(), mapSettings );
 
+    // the layers of the print layout are only known once it is loaded
+    loadDeferredLayers( mNicknameLayers.values() );
+
     // init layer restorer before doing anything
     std::unique_ptr<QgsLayerRestorer> restorer;
     restorer.reset( new QgsLayerRestorer( mNicknameLayers.values() ) );
@@ -2427,6 +2431,39 @@ namespace QgsWms
     initLayerGroupsRecursive( root, mProject->title() );
   }
 
+  void QgsRenderer::loadDeferredLayers()
+  {
+    // layers of a SLD are named in the SLD body
+    if ( !mWmsParameters.sldBody().isEmpty() )
+    {
+      loadDeferredLayers( mNicknameLayers.values() );
+      return;
+    }
+
+    QList<QgsMapLayer *> layers;
+    const QStringList nicknames = mWmsParameters.allLayersNickname() + mWmsParameters.queryLayersNickname();
+    for ( const QString &nickname : nicknames )
+    {
+      if ( mNicknameLayers.contains( nickname ) )
+        layers << mNicknameLayers[ nickname ];
+      else if ( mLayerGroups.contains( nickname ) )
+        layers << mLayerGroups[ nickname ];
+    }
+    loadDeferredLayers( layers );
+  }
+
+  void QgsRenderer::loadDeferredLayers( const QList<QgsMapLayer *> &layers )
+  {
+    for ( QgsMapLayer *layer : layers )
+    {
+      if ( layer && layer->isLoadingDeferred() && !layer->completeDeferredLoading() )
+      {
+        QgsMessageLog::logMessage( QStringLiteral( "Error when loading layer '%1'" ).arg( layer->name() ),
+                                   QStringLiteral( "Server" ), Qgis::Warning );
+      }
+    }
+  }
+
   void QgsRenderer::initLayerGroupsRecursive( const QgsLayerTreeGroup *group, const QString &groupName )
   {
     if ( !groupName.isEmpty() )
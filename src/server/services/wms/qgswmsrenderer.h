@@ -132,6 +132,12 @@ namespace QgsWms
 
       void initLayerGroupsRecursive( const QgsLayerTreeGroup *group, const QString &groupName );
 
+      // Complete the loading of the layers used by the request if it has been deferred
+      void loadDeferredLayers();
+
+      // Complete the loading of layers if it has been deferred
+      void loadDeferredLayers( const QList<QgsMapLayer *> &layers );
+
       // Return the nickname of the layer (short name, id or name according to
       // the project configuration)
       QString layerNickname( const QgsMapLayer &layer ) const;
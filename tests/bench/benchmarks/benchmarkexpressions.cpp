@@ -0,0 +1,115 @@
+/***************************************************************************
+     benchmarkexpressions.cpp
+     ------------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsbenchmarkdata.h"
+#include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
+#include "qgsfeatureiterator.h"
+#include "qgsvectorlayer.h"
+
+/**
+ * Benchmarks the evaluation of prepared expressions over the features of a layer.
+ */
+class BenchmarkExpressions : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void evaluate_data();
+    void evaluate();
+    void parse();
+
+  private:
+    std::unique_ptr< QgsVectorLayer > mLayer;
+    QgsFeatureList mFeatures;
+};
+
+void BenchmarkExpressions::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mLayer = QgsBenchmarkData::createPolygonLayer( 10000 );
+  QgsFeatureIterator it = mLayer->getFeatures();
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+    mFeatures << f;
+}
+
+void BenchmarkExpressions::cleanupTestCase()
+{
+  mFeatures.clear();
+  mLayer.reset();
+  QgsApplication::exitQgis();
+}
+
+void BenchmarkExpressions::evaluate_data()
+{
+  QTest::addColumn< QString >( "expression" );
+
+  QTest::newRow( "literal" ) << QStringLiteral( "1" );
+  QTest::newRow( "field" ) << QStringLiteral( "\"value\"" );
+  QTest::newRow( "arithmetic" ) << QStringLiteral( "\"value\" * 2 + \"category\" / 3 - 1" );
+  QTest::newRow( "comparison" ) << QStringLiteral( "\"category\" = 3 AND \"value\" > 500" );
+  QTest::newRow( "in" ) << QStringLiteral( "\"category\" IN (1, 3, 5, 7)" );
+  QTest::newRow( "like" ) << QStringLiteral( "\"name\" ILIKE '%north%'" );
+  QTest::newRow( "concat" ) << QStringLiteral( "\"name\" || ' (' || \"category\" || ')'" );
+  QTest::newRow( "string functions" ) << QStringLiteral( "upper(left(\"name\", 5)) || lpad(\"id\", 6, '0')" );
+  QTest::newRow( "regexp" ) << QStringLiteral( "regexp_replace(\"name\", '[0-9]+', '#')" );
+  QTest::newRow( "case" ) << QStringLiteral( "CASE WHEN \"value\" < 250 THEN 'low' WHEN \"value\" < 750 THEN 'medium' ELSE 'high' END" );
+  QTest::newRow( "area" ) << QStringLiteral( "$area" );
+  QTest::newRow( "geometry functions" ) << QStringLiteral( "area(buffer($geometry, 10))" );
+  QTest::newRow( "centroid" ) << QStringLiteral( "x(centroid($geometry))" );
+}
+
+void BenchmarkExpressions::evaluate()
+{
+  QFETCH( QString, expression );
+
+  QgsExpressionContext context( QgsExpressionContextUtils::globalProjectLayerScopes( mLayer.get() ) );
+  QgsExpression exp( expression );
+  QVERIFY( exp.prepare( &context ) );
+
+  QBENCHMARK
+  {
+    for ( const QgsFeature &f : qgis::as_const( mFeatures ) )
+    {
+      context.setFeature( f );
+      exp.evaluate( &context );
+    }
+  }
+  QVERIFY( !exp.hasEvalError() );
+}
+
+void BenchmarkExpressions::parse()
+{
+  QBENCHMARK
+  {
+    for ( int i = 0; i < 1000; ++i )
+    {
+      QgsExpression exp( QStringLiteral( "CASE WHEN \"value\" < %1 THEN upper(\"name\") ELSE \"name\" || ' ' || \"category\" END" ).arg( i ) );
+      Q_UNUSED( exp );
+    }
+  }
+}
+
+QGSTEST_MAIN( BenchmarkExpressions )
+#include "benchmarkexpressions.moc"
@@ -0,0 +1,145 @@
+/***************************************************************************
+     benchmarkprocessing.cpp
+     -----------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsbenchmarkdata.h"
+#include "qgsnativealgorithms.h"
+#include "qgsprocessingalgorithm.h"
+#include "qgsprocessingcontext.h"
+#include "qgsprocessingfeedback.h"
+#include "qgsprocessingregistry.h"
+#include "qgsproject.h"
+#include "qgsvectorlayer.h"
+
+/**
+ * Benchmarks native processing algorithms on synthetic datasets.
+ */
+class BenchmarkProcessing : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void algorithm_data();
+    void algorithm();
+
+  private:
+    QString mPointsId;
+    QString mPolygonsId;
+    QString mOverlayId;
+};
+
+void BenchmarkProcessing::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+  QgsApplication::processingRegistry()->addProvider( new QgsNativeAlgorithms( QgsApplication::processingRegistry() ) );
+
+  // the layers are owned by the project, and referenced by id in the parameters
+  std::unique_ptr< QgsVectorLayer > points = QgsBenchmarkData::createPointLayer( 100000 );
+  std::unique_ptr< QgsVectorLayer > polygons = QgsBenchmarkData::createPolygonLayer( 5000 );
+  std::unique_ptr< QgsVectorLayer > overlay = QgsBenchmarkData::createPolygonLayer( 5000, 32, QgsBenchmarkData::DEFAULT_SEED + 1 );
+  mPointsId = points->id();
+  mPolygonsId = polygons->id();
+  mOverlayId = overlay->id();
+  QgsProject::instance()->addMapLayers( QList< QgsMapLayer * >() << points.release() << polygons.release() << overlay.release() );
+}
+
+void BenchmarkProcessing::cleanupTestCase()
+{
+  QgsProject::instance()->removeAllMapLayers();
+  QgsApplication::exitQgis();
+}
+
+void BenchmarkProcessing::algorithm_data()
+{
+  QTest::addColumn< QString >( "algorithm" );
+  QTest::addColumn< QVariantMap >( "parameters" );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), mPointsId );
+  parameters.insert( QStringLiteral( "DISTANCE" ), 100 );
+  parameters.insert( QStringLiteral( "SEGMENTS" ), 8 );
+  QTest::newRow( "buffer points" ) << QStringLiteral( "native:buffer" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  parameters.insert( QStringLiteral( "DISTANCE" ), 100 );
+  parameters.insert( QStringLiteral( "SEGMENTS" ), 8 );
+  QTest::newRow( "buffer polygons" ) << QStringLiteral( "native:buffer" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  QTest::newRow( "centroids" ) << QStringLiteral( "native:centroids" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  parameters.insert( QStringLiteral( "METHOD" ), 0 );
+  parameters.insert( QStringLiteral( "TOLERANCE" ), 50 );
+  QTest::newRow( "simplify" ) << QStringLiteral( "native:simplifygeometries" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  parameters.insert( QStringLiteral( "TARGET_CRS" ), QStringLiteral( "EPSG:4326" ) );
+  QTest::newRow( "reproject" ) << QStringLiteral( "native:reprojectlayer" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "category" ) );
+  QTest::newRow( "dissolve" ) << QStringLiteral( "native:dissolve" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPointsId );
+  parameters.insert( QStringLiteral( "OVERLAY" ), mPolygonsId );
+  QTest::newRow( "clip points" ) << QStringLiteral( "native:clip" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  parameters.insert( QStringLiteral( "OVERLAY" ), mOverlayId );
+  QTest::newRow( "intersection" ) << QStringLiteral( "native:intersection" ) << parameters;
+
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), mPolygonsId );
+  parameters.insert( QStringLiteral( "OVERLAY" ), mOverlayId );
+  QTest::newRow( "difference" ) << QStringLiteral( "native:difference" ) << parameters;
+}
+
+void BenchmarkProcessing::algorithm()
+{
+  QFETCH( QString, algorithm );
+  QFETCH( QVariantMap, parameters );
+
+  const QgsProcessingAlgorithm *alg = QgsApplication::processingRegistry()->algorithmById( algorithm );
+  QVERIFY( alg );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QStringLiteral( "memory:" ) );
+
+  bool ok = false;
+  QBENCHMARK
+  {
+    // a new context per run, so that the output layers are released in each run
+    QgsProcessingContext context;
+    context.setProject( QgsProject::instance() );
+    QgsProcessingFeedback feedback;
+    alg->run( parameters, context, &feedback, &ok );
+  }
+  QVERIFY( ok );
+}
+
+QGSTEST_MAIN( BenchmarkProcessing )
+#include "benchmarkprocessing.moc"
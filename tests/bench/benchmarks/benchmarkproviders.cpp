@@ -0,0 +1,217 @@
+/***************************************************************************
+     benchmarkproviders.cpp
+     ----------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QTemporaryDir>
+
+#include "qgsapplication.h"
+#include "qgsbenchmarkdata.h"
+#include "qgsfeatureiterator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerexporter.h"
+
+/**
+ * Benchmarks the iteration over the features of the same synthetic dataset,
+ * stored in the formats of the main vector data providers.
+ *
+ * The PostgreSQL provider is benchmarked when built with ENABLE_PGTEST, using the
+ * database of the QGIS_PGTEST_DB environment variable, like the provider tests.
+ */
+class BenchmarkProviders : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void iterateAll_data();
+    void iterateAll();
+    void iterateAttributesOnly_data();
+    void iterateAttributesOnly();
+    void iterateRect_data();
+    void iterateRect();
+    void iterateExpression_data();
+    void iterateExpression();
+
+  private:
+    //! Number of points of the dataset
+    static const int FEATURE_COUNT = 100000;
+
+    void addProviderRows();
+    //! Iterates over all features of \a layer matching \a request, and returns their count
+    static int iterate( QgsVectorLayer *layer, const QgsFeatureRequest &request );
+
+    QTemporaryDir mDir;
+    std::unique_ptr< QgsVectorLayer > mMemoryLayer;
+    QMap< QString, QgsVectorLayer * > mLayers;
+};
+
+void BenchmarkProviders::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  QVERIFY( mDir.isValid() );
+  mMemoryLayer = QgsBenchmarkData::createPointLayer( FEATURE_COUNT );
+  mLayers.insert( QStringLiteral( "memory" ), mMemoryLayer.get() );
+
+  const QString gpkg = QgsBenchmarkData::writeVectorFile( mMemoryLayer.get(), mDir.path(), QStringLiteral( "GPKG" ), QStringLiteral( "gpkg" ) );
+  QVERIFY( !gpkg.isEmpty() );
+  mLayers.insert( QStringLiteral( "ogr gpkg" ), new QgsVectorLayer( gpkg, QStringLiteral( "gpkg" ), QStringLiteral( "ogr" ) ) );
+
+  const QString shp = QgsBenchmarkData::writeVectorFile( mMemoryLayer.get(), mDir.path(), QStringLiteral( "ESRI Shapefile" ), QStringLiteral( "shp" ) );
+  QVERIFY( !shp.isEmpty() );
+  mLayers.insert( QStringLiteral( "ogr shapefile" ), new QgsVectorLayer( shp, QStringLiteral( "shp" ), QStringLiteral( "ogr" ) ) );
+
+  const QString csv = QgsBenchmarkData::writeDelimitedText( mMemoryLayer.get(), mDir.path() );
+  QVERIFY( !csv.isEmpty() );
+  mLayers.insert( QStringLiteral( "delimitedtext" ), new QgsVectorLayer( csv, QStringLiteral( "csv" ), QStringLiteral( "delimitedtext" ) ) );
+
+#ifdef ENABLE_PGTEST
+  QString dbConn = getenv( "QGIS_PGTEST_DB" );
+  if ( dbConn.isEmpty() )
+  {
+    dbConn = "dbname='qgis_test'";
+  }
+  const QString uri = QStringLiteral( "%1 sslmode=disable key='id' table=\"qgis_test\".\"benchmark_points\" (geom) sql=" ).arg( dbConn );
+  QVariantMap options;
+  options.insert( QStringLiteral( "overwrite" ), true );
+  QString error;
+  QCOMPARE( QgsVectorLayerExporter::exportLayer( mMemoryLayer.get(), uri, QStringLiteral( "postgres" ), mMemoryLayer->crs(), false, &error, options ), QgsVectorLayerExporter::NoError );
+  mLayers.insert( QStringLiteral( "postgres" ), new QgsVectorLayer( uri, QStringLiteral( "postgres" ), QStringLiteral( "postgres" ) ) );
+#endif
+
+  for ( auto it = mLayers.constBegin(); it != mLayers.constEnd(); ++it )
+  {
+    QVERIFY2( it.value()->isValid(), it.key().toUtf8().constData() );
+    QCOMPARE( static_cast< int >( it.value()->featureCount() ), FEATURE_COUNT );
+  }
+}
+
+void BenchmarkProviders::cleanupTestCase()
+{
+  mLayers.remove( QStringLiteral( "memory" ) );
+  qDeleteAll( mLayers );
+  mLayers.clear();
+  mMemoryLayer.reset();
+  QgsApplication::exitQgis();
+}
+
+void BenchmarkProviders::addProviderRows()
+{
+  QTest::addColumn< QString >( "provider" );
+  for ( const QString &provider : mLayers.keys() )
+    QTest::newRow( provider.toUtf8().constData() ) << provider;
+}
+
+int BenchmarkProviders::iterate( QgsVectorLayer *layer, const QgsFeatureRequest &request )
+{
+  int count = 0;
+  QgsFeatureIterator it = layer->getFeatures( request );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+    ++count;
+  return count;
+}
+
+void BenchmarkProviders::iterateAll_data()
+{
+  addProviderRows();
+}
+
+void BenchmarkProviders::iterateAll()
+{
+  QFETCH( QString, provider );
+  QgsVectorLayer *layer = mLayers.value( provider );
+
+  int count = 0;
+  QBENCHMARK
+  {
+    count = iterate( layer, QgsFeatureRequest() );
+  }
+  QCOMPARE( count, FEATURE_COUNT );
+}
+
+void BenchmarkProviders::iterateAttributesOnly_data()
+{
+  addProviderRows();
+}
+
+void BenchmarkProviders::iterateAttributesOnly()
+{
+  QFETCH( QString, provider );
+  QgsVectorLayer *layer = mLayers.value( provider );
+
+  QgsFeatureRequest request;
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  request.setSubsetOfAttributes( QStringList() << QStringLiteral( "value" ), layer->fields() );
+
+  int count = 0;
+  QBENCHMARK
+  {
+    count = iterate( layer, request );
+  }
+  QCOMPARE( count, FEATURE_COUNT );
+}
+
+void BenchmarkProviders::iterateRect_data()
+{
+  addProviderRows();
+}
+
+void BenchmarkProviders::iterateRect()
+{
+  QFETCH( QString, provider );
+  QgsVectorLayer *layer = mLayers.value( provider );
+
+  // one percent of the extent
+  const QgsRectangle extent = QgsBenchmarkData::extent();
+  QgsFeatureRequest request;
+  request.setFilterRect( QgsRectangle( extent.xMinimum(), extent.yMinimum(),
+                                       extent.xMinimum() + extent.width() / 10, extent.yMinimum() + extent.height() / 10 ) );
+
+  int count = 0;
+  QBENCHMARK
+  {
+    for ( int i = 0; i < 10; ++i )
+      count = iterate( layer, request );
+  }
+  QVERIFY( count > 0 );
+}
+
+void BenchmarkProviders::iterateExpression_data()
+{
+  addProviderRows();
+}
+
+void BenchmarkProviders::iterateExpression()
+{
+  QFETCH( QString, provider );
+  QgsVectorLayer *layer = mLayers.value( provider );
+
+  QgsFeatureRequest request;
+  request.setFilterExpression( QStringLiteral( "\"category\" = 3 AND \"value\" > 500" ) );
+
+  int count = 0;
+  QBENCHMARK
+  {
+    count = iterate( layer, request );
+  }
+  QVERIFY( count > 0 );
+}
+
+QGSTEST_MAIN( BenchmarkProviders )
+#include "benchmarkproviders.moc"
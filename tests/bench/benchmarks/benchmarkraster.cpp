@@ -0,0 +1,109 @@
+/***************************************************************************
+     benchmarkraster.cpp
+     -------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QTemporaryDir>
+
+#include "qgsapplication.h"
+#include "qgsbenchmarkdata.h"
+#include "qgscoordinatetransform.h"
+#include "qgsproject.h"
+#include "qgsrasterblock.h"
+#include "qgsrasterdataprovider.h"
+#include "qgsrasterlayer.h"
+#include "qgsrasterprojector.h"
+
+/**
+ * Benchmarks reading and reprojecting blocks of a synthetic raster.
+ */
+class BenchmarkRaster : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void read();
+    void reproject_data();
+    void reproject();
+
+  private:
+    //! Size of the output blocks
+    static const int BLOCK_SIZE = 1024;
+
+    QTemporaryDir mDir;
+    std::unique_ptr< QgsRasterLayer > mLayer;
+};
+
+void BenchmarkRaster::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  QVERIFY( mDir.isValid() );
+  const QString path = QgsBenchmarkData::writeRaster( mDir.path(), 4000, 4000 );
+  QVERIFY( !path.isEmpty() );
+  mLayer = qgis::make_unique< QgsRasterLayer >( path, QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  QVERIFY( mLayer->isValid() );
+}
+
+void BenchmarkRaster::cleanupTestCase()
+{
+  mLayer.reset();
+  QgsApplication::exitQgis();
+}
+
+void BenchmarkRaster::read()
+{
+  QgsRasterDataProvider *provider = mLayer->dataProvider();
+
+  QBENCHMARK
+  {
+    std::unique_ptr< QgsRasterBlock > block( provider->block( 1, provider->extent(), BLOCK_SIZE, BLOCK_SIZE ) );
+    QVERIFY( block && block->isValid() );
+  }
+}
+
+void BenchmarkRaster::reproject_data()
+{
+  QTest::addColumn< QString >( "crs" );
+
+  QTest::newRow( "geographic" ) << QStringLiteral( "EPSG:4326" );
+  QTest::newRow( "utm" ) << QStringLiteral( "EPSG:32631" );
+  QTest::newRow( "lambert" ) << QStringLiteral( "EPSG:2154" );
+}
+
+void BenchmarkRaster::reproject()
+{
+  QFETCH( QString, crs );
+
+  const QgsCoordinateReferenceSystem destinationCrs( crs );
+  QgsRasterProjector projector;
+  projector.setInput( mLayer->dataProvider() );
+  projector.setCrs( mLayer->crs(), destinationCrs );
+
+  const QgsCoordinateTransform transform( mLayer->crs(), destinationCrs, QgsProject::instance() );
+  const QgsRectangle extent = transform.transformBoundingBox( mLayer->extent() );
+
+  QBENCHMARK
+  {
+    std::unique_ptr< QgsRasterBlock > block( projector.block( 1, extent, BLOCK_SIZE, BLOCK_SIZE ) );
+    QVERIFY( block && block->isValid() );
+  }
+}
+
+QGSTEST_MAIN( BenchmarkRaster )
+#include "benchmarkraster.moc"
@@ -0,0 +1,177 @@
+/***************************************************************************
+     benchmarkrendering.cpp
+     ----------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QImage>
+#include <QPainter>
+
+#include "qgsapplication.h"
+#include "qgsbenchmarkdata.h"
+#include "qgsfontutils.h"
+#include "qgsmaprenderercustompainterjob.h"
+#include "qgsmaprendererparalleljob.h"
+#include "qgsmapsettings.h"
+#include "qgspallabeling.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerlabeling.h"
+
+/**
+ * Benchmarks rendering synthetic vector layers, with and without labels.
+ */
+class BenchmarkRendering : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void render_data();
+    void render();
+    void renderParallel();
+    void labeling_data();
+    void labeling();
+
+  private:
+    QgsMapSettings mapSettings( const QList< QgsMapLayer * > &layers ) const;
+    static void renderSequential( const QgsMapSettings &settings );
+    void setLabeled( bool labeled );
+
+    std::unique_ptr< QgsVectorLayer > mPoints;
+    std::unique_ptr< QgsVectorLayer > mPolygons;
+};
+
+void BenchmarkRendering::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mPoints = QgsBenchmarkData::createPointLayer( 50000 );
+  mPolygons = QgsBenchmarkData::createPolygonLayer( 10000 );
+}
+
+void BenchmarkRendering::cleanupTestCase()
+{
+  mPoints.reset();
+  mPolygons.reset();
+  QgsApplication::exitQgis();
+}
+
+void BenchmarkRendering::init()
+{
+  setLabeled( false );
+}
+
+QgsMapSettings BenchmarkRendering::mapSettings( const QList< QgsMapLayer * > &layers ) const
+{
+  QgsMapSettings settings;
+  settings.setDestinationCrs( mPoints->crs() );
+  settings.setExtent( QgsBenchmarkData::extent() );
+  settings.setOutputSize( QSize( 1024, 1024 ) );
+  settings.setOutputDpi( 96 );
+  settings.setLayers( layers );
+  return settings;
+}
+
+void BenchmarkRendering::renderSequential( const QgsMapSettings &settings )
+{
+  QImage image( settings.outputSize(), QImage::Format_ARGB32_Premultiplied );
+  image.fill( Qt::white );
+  QPainter painter( &image );
+  QgsMapRendererCustomPainterJob job( settings, &painter );
+  job.renderSynchronously();
+  painter.end();
+}
+
+void BenchmarkRendering::setLabeled( bool labeled )
+{
+  for ( QgsVectorLayer *layer : { mPoints.get(), mPolygons.get() } )
+  {
+    if ( labeled )
+    {
+      QgsPalLayerSettings settings;
+      settings.fieldName = QStringLiteral( "name" );
+      QgsTextFormat format;
+      format.setFont( QgsFontUtils::getStandardTestFont( QStringLiteral( "Bold" ) ) );
+      format.setSize( 10 );
+      settings.setFormat( format );
+      layer->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+    }
+    layer->setLabelsEnabled( labeled );
+  }
+}
+
+void BenchmarkRendering::render_data()
+{
+  QTest::addColumn< bool >( "points" );
+  QTest::addColumn< bool >( "antialiasing" );
+
+  QTest::newRow( "points" ) << true << true;
+  QTest::newRow( "points without antialiasing" ) << true << false;
+  QTest::newRow( "polygons" ) << false << true;
+  QTest::newRow( "polygons without antialiasing" ) << false << false;
+}
+
+void BenchmarkRendering::render()
+{
+  QFETCH( bool, points );
+  QFETCH( bool, antialiasing );
+
+  QgsMapSettings settings = mapSettings( QList< QgsMapLayer * >() << ( points ? static_cast< QgsMapLayer * >( mPoints.get() ) : mPolygons.get() ) );
+  settings.setFlag( QgsMapSettings::Antialiasing, antialiasing );
+
+  QBENCHMARK
+  {
+    renderSequential( settings );
+  }
+}
+
+void BenchmarkRendering::renderParallel()
+{
+  const QgsMapSettings settings = mapSettings( QList< QgsMapLayer * >() << mPoints.get() << mPolygons.get() );
+
+  QBENCHMARK
+  {
+    QgsMapRendererParallelJob job( settings );
+    job.start();
+    job.waitForFinished();
+  }
+}
+
+void BenchmarkRendering::labeling_data()
+{
+  QTest::addColumn< bool >( "points" );
+
+  QTest::newRow( "points" ) << true;
+  QTest::newRow( "polygons" ) << false;
+}
+
+void BenchmarkRendering::labeling()
+{
+  QFETCH( bool, points );
+
+  // includes drawing the symbols, the cost of labeling is the difference with render()
+  setLabeled( true );
+  const QgsMapSettings settings = mapSettings( QList< QgsMapLayer * >() << ( points ? static_cast< QgsMapLayer * >( mPoints.get() ) : mPolygons.get() ) );
+
+  QBENCHMARK
+  {
+    renderSequential( settings );
+  }
+}
+
+QGSTEST_MAIN( BenchmarkRendering )
+#include "benchmarkrendering.moc"
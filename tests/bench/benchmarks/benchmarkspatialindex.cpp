@@ -0,0 +1,174 @@
+/***************************************************************************
+     benchmarkspatialindex.cpp
+     -------------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsbenchmarkdata.h"
+#include "qgsfeatureiterator.h"
+#include "qgsspatialindex.h"
+#include "qgsvectorlayer.h"
+
+#include <random>
+
+/**
+ * Benchmarks building and querying spatial indexes of point and polygon datasets.
+ */
+class BenchmarkSpatialIndex : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void build_data();
+    void build();
+    void buildIncremental_data();
+    void buildIncremental();
+    void intersects_data();
+    void intersects();
+    void nearestNeighbor();
+
+  private:
+    void addLayerRows();
+
+    std::unique_ptr< QgsVectorLayer > mPoints;
+    std::unique_ptr< QgsVectorLayer > mPolygons;
+};
+
+void BenchmarkSpatialIndex::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mPoints = QgsBenchmarkData::createPointLayer( 100000 );
+  mPolygons = QgsBenchmarkData::createPolygonLayer( 20000 );
+}
+
+void BenchmarkSpatialIndex::cleanupTestCase()
+{
+  mPoints.reset();
+  mPolygons.reset();
+  QgsApplication::exitQgis();
+}
+
+void BenchmarkSpatialIndex::addLayerRows()
+{
+  QTest::addColumn< bool >( "points" );
+  QTest::newRow( "points" ) << true;
+  QTest::newRow( "polygons" ) << false;
+}
+
+void BenchmarkSpatialIndex::build_data()
+{
+  addLayerRows();
+}
+
+void BenchmarkSpatialIndex::build()
+{
+  QFETCH( bool, points );
+  QgsVectorLayer *layer = points ? mPoints.get() : mPolygons.get();
+
+  // bulk loading from an iterator
+  QBENCHMARK
+  {
+    QgsSpatialIndex index( layer->getFeatures( QgsFeatureRequest().setNoAttributes() ) );
+  }
+}
+
+void BenchmarkSpatialIndex::buildIncremental_data()
+{
+  addLayerRows();
+}
+
+void BenchmarkSpatialIndex::buildIncremental()
+{
+  QFETCH( bool, points );
+  QgsVectorLayer *layer = points ? mPoints.get() : mPolygons.get();
+
+  QgsFeatureList features;
+  QgsFeatureIterator it = layer->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+    features << f;
+
+  QBENCHMARK
+  {
+    QgsSpatialIndex index;
+    for ( QgsFeature &feature : features )
+      index.addFeature( feature );
+  }
+}
+
+void BenchmarkSpatialIndex::intersects_data()
+{
+  addLayerRows();
+}
+
+void BenchmarkSpatialIndex::intersects()
+{
+  QFETCH( bool, points );
+  QgsVectorLayer *layer = points ? mPoints.get() : mPolygons.get();
+  QgsSpatialIndex index( layer->getFeatures( QgsFeatureRequest().setNoAttributes() ) );
+
+  // random query rectangles, of 1/100th of the extent width
+  const QgsRectangle extent = QgsBenchmarkData::extent();
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution< double > x( extent.xMinimum(), extent.xMaximum() );
+  std::uniform_real_distribution< double > y( extent.yMinimum(), extent.yMaximum() );
+  const double size = extent.width() / 100;
+  QVector< QgsRectangle > rects;
+  for ( int i = 0; i < 10000; ++i )
+  {
+    const double rx = x( generator );
+    const double ry = y( generator );
+    rects << QgsRectangle( rx, ry, rx + size, ry + size );
+  }
+
+  int found = 0;
+  QBENCHMARK
+  {
+    found = 0;
+    for ( const QgsRectangle &rect : qgis::as_const( rects ) )
+      found += index.intersects( rect ).count();
+  }
+  QVERIFY( found > 0 );
+}
+
+void BenchmarkSpatialIndex::nearestNeighbor()
+{
+  QgsSpatialIndex index( mPoints->getFeatures( QgsFeatureRequest().setNoAttributes() ) );
+
+  const QgsRectangle extent = QgsBenchmarkData::extent();
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution< double > x( extent.xMinimum(), extent.xMaximum() );
+  std::uniform_real_distribution< double > y( extent.yMinimum(), extent.yMaximum() );
+  QVector< QgsPointXY > queryPoints;
+  for ( int i = 0; i < 10000; ++i )
+  {
+    const double px = x( generator );
+    queryPoints << QgsPointXY( px, y( generator ) );
+  }
+
+  QBENCHMARK
+  {
+    for ( const QgsPointXY &point : qgis::as_const( queryPoints ) )
+      index.nearestNeighbor( point, 5 );
+  }
+}
+
+QGSTEST_MAIN( BenchmarkSpatialIndex )
+#include "benchmarkspatialindex.moc"
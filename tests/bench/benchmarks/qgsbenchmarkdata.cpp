@@ -0,0 +1,162 @@
+/***************************************************************************
+                         qgsbenchmarkdata.cpp
+                         --------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsbenchmarkdata.h"
+#include "qgsfeatureiterator.h"
+#include "qgsgeometry.h"
+#include "qgsrasterblock.h"
+#include "qgsrasterdataprovider.h"
+#include "qgsrasterfilewriter.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorfilewriter.h"
+#include "qgsvectorlayer.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QUrl>
+#include <cmath>
+#include <functional>
+#include <random>
+
+static const QStringList NAMES = QStringList() << QStringLiteral( "North" ) << QStringLiteral( "South" ) << QStringLiteral( "East" )
+                                 << QStringLiteral( "West" ) << QStringLiteral( "Central" ) << QStringLiteral( "Upper" ) << QStringLiteral( "Lower" );
+
+static std::unique_ptr< QgsVectorLayer > createLayer( const QString &geometryType, int count, unsigned int seed, const std::function< QgsGeometry( std::mt19937 & ) > &geometry )
+{
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >(
+        QStringLiteral( "%1?crs=EPSG:3857&field=id:integer&field=name:string(40)&field=category:integer&field=value:double" ).arg( geometryType ),
+        QStringLiteral( "benchmark" ), QStringLiteral( "memory" ) );
+
+  std::mt19937 generator( seed );
+  std::uniform_int_distribution< int > name( 0, NAMES.count() - 1 );
+  std::uniform_int_distribution< int > category( 0, 9 );
+  std::uniform_real_distribution< double > value( 0, 1000 );
+
+  QgsFeatureList features;
+  features.reserve( count );
+  for ( int i = 0; i < count; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i << QStringLiteral( "%1 %2" ).arg( NAMES.at( name( generator ) ) ).arg( i )
+                     << category( generator ) << value( generator ) );
+    f.setGeometry( geometry( generator ) );
+    features << f;
+  }
+  layer->dataProvider()->addFeatures( features );
+  return layer;
+}
+
+QgsRectangle QgsBenchmarkData::extent()
+{
+  return QgsRectangle( 0, 0, 100000, 100000 );
+}
+
+std::unique_ptr< QgsVectorLayer > QgsBenchmarkData::createPointLayer( int count, unsigned int seed )
+{
+  const QgsRectangle bounds = extent();
+  std::uniform_real_distribution< double > x( bounds.xMinimum(), bounds.xMaximum() );
+  std::uniform_real_distribution< double > y( bounds.yMinimum(), bounds.yMaximum() );
+  return createLayer( QStringLiteral( "Point" ), count, seed, [&]( std::mt19937 & generator )
+  {
+    const double px = x( generator );
+    return QgsGeometry::fromPointXY( QgsPointXY( px, y( generator ) ) );
+  } );
+}
+
+std::unique_ptr< QgsVectorLayer > QgsBenchmarkData::createPolygonLayer( int count, int vertexCount, unsigned int seed )
+{
+  const QgsRectangle bounds = extent();
+  std::uniform_real_distribution< double > x( bounds.xMinimum(), bounds.xMaximum() );
+  std::uniform_real_distribution< double > y( bounds.yMinimum(), bounds.yMaximum() );
+  std::uniform_real_distribution< double > radius( bounds.width() / 1000, bounds.width() / 50 );
+  std::uniform_real_distribution< double > jitter( 0.7, 1.0 );
+  return createLayer( QStringLiteral( "Polygon" ), count, seed, [&]( std::mt19937 & generator )
+  {
+    const double cx = x( generator );
+    const double cy = y( generator );
+    const double r = radius( generator );
+
+    // a star shaped ring, so that the polygons are not all convex
+    QgsPolylineXY ring;
+    ring.reserve( vertexCount + 1 );
+    for ( int i = 0; i < vertexCount; ++i )
+    {
+      const double angle = 2 * M_PI * i / vertexCount;
+      const double rv = r * jitter( generator );
+      ring << QgsPointXY( cx + rv * std::cos( angle ), cy + rv * std::sin( angle ) );
+    }
+    ring << ring.first();
+    return QgsGeometry::fromPolygonXY( QgsPolygonXY() << ring );
+  } );
+}
+
+QString QgsBenchmarkData::writeVectorFile( QgsVectorLayer *layer, const QString &directory, const QString &driverName, const QString &extension )
+{
+  const QString path = QDir( directory ).filePath( QStringLiteral( "%1.%2" ).arg( layer->geometryType() == QgsWkbTypes::PointGeometry ? QStringLiteral( "points" ) : QStringLiteral( "polygons" ), extension ) );
+  QString error;
+  if ( QgsVectorFileWriter::writeAsVectorFormat( layer, path, QStringLiteral( "UTF-8" ), layer->crs(), driverName, false, &error ) != QgsVectorFileWriter::NoError )
+    return QString();
+  return path;
+}
+
+QString QgsBenchmarkData::writeDelimitedText( QgsVectorLayer *layer, const QString &directory )
+{
+  const QString path = QDir( directory ).filePath( QStringLiteral( "points.csv" ) );
+  QFile file( path );
+  if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    return QString();
+
+  QTextStream stream( &file );
+  stream.setRealNumberPrecision( 17 );
+  stream << "id,name,category,value,x,y\n";
+  QgsFeatureIterator it = layer->getFeatures();
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    const QgsPointXY point = f.geometry().asPoint();
+    stream << f.attribute( 0 ).toInt() << ",\"" << f.attribute( 1 ).toString() << "\"," << f.attribute( 2 ).toInt() << ','
+           << f.attribute( 3 ).toDouble() << ',' << point.x() << ',' << point.y() << '\n';
+  }
+  file.close();
+
+  return QStringLiteral( "%1?type=csv&xField=x&yField=y&crs=EPSG:3857&spatialIndex=no&subsetIndex=no&watchFile=no" ).arg( QUrl::fromLocalFile( path ).toString() );
+}
+
+QString QgsBenchmarkData::writeRaster( const QString &directory, int width, int height )
+{
+  const QString path = QDir( directory ).filePath( QStringLiteral( "raster.tif" ) );
+  QgsRasterFileWriter writer( path );
+  std::unique_ptr< QgsRasterDataProvider > provider( writer.createOneBandRaster( Qgis::Float32, width, height, extent(), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ) ) );
+  if ( !provider )
+    return QString();
+
+  // a smooth surface with some noise, like an elevation model
+  std::mt19937 generator( DEFAULT_SEED );
+  std::uniform_real_distribution< double > noise( 0, 10 );
+  QgsRasterBlock block( Qgis::Float32, width, height );
+  for ( int row = 0; row < height; ++row )
+  {
+    for ( int column = 0; column < width; ++column )
+    {
+      block.setValue( row, column, 500 + 300 * std::sin( 8.0 * column / width ) * std::cos( 6.0 * row / height ) + noise( generator ) );
+    }
+  }
+  if ( !provider->writeBlock( &block, 1 ) )
+    return QString();
+
+  return path;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+                         qgsbenchmarkdata.h
+                         ------------------
+    begin                : October 2018
+    copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSBENCHMARKDATA_H
+#define QGSBENCHMARKDATA_H
+
+#include "qgsrectangle.h"
+
+#include <QString>
+#include <memory>
+
+class QgsVectorLayer;
+
+/**
+ * Generates the synthetic datasets used by the benchmarks.
+ *
+ * The datasets are generated from a fixed seed, so that all runs of a benchmark
+ * work on the same data. All datasets are in EPSG:3857 and cover extent().
+ */
+class QgsBenchmarkData
+{
+  public:
+
+    //! Default seed of the datasets
+    static const unsigned int DEFAULT_SEED = 42;
+
+    //! Returns the extent covered by the datasets
+    static QgsRectangle extent();
+
+    /**
+     * Creates a memory layer with \a count random points, with the fields
+     * "id" (integer), "name" (string), "category" (integer, 0 to 9) and "value" (double).
+     * Layers generated with another \a seed are different datasets.
+     */
+    static std::unique_ptr< QgsVectorLayer > createPointLayer( int count, unsigned int seed = DEFAULT_SEED );
+
+    /**
+     * Creates a memory layer with \a count random, possibly overlapping, polygons of
+     * \a vertexCount vertices, with the same fields as createPointLayer().
+     */
+    static std::unique_ptr< QgsVectorLayer > createPolygonLayer( int count, int vertexCount = 32, unsigned int seed = DEFAULT_SEED );
+
+    /**
+     * Writes \a layer to a new file in \a directory with the OGR driver \a driverName,
+     * and returns the path of the file, or an empty string on failure.
+     */
+    static QString writeVectorFile( QgsVectorLayer *layer, const QString &directory, const QString &driverName, const QString &extension );
+
+    /**
+     * Writes the points of \a layer to a CSV file in \a directory, with "x" and "y" columns,
+     * and returns the delimited text provider URI of the file, or an empty string on failure.
+     */
+    static QString writeDelimitedText( QgsVectorLayer *layer, const QString &directory );
+
+    /**
+     * Writes a single band float GeoTIFF of \a width by \a height pixels covering extent()
+     * to \a directory, and returns its path, or an empty string on failure.
+     */
+    static QString writeRaster( const QString &directory, int width, int height );
+};
+
+#endif // QGSBENCHMARKDATA_H
@@ -15,6 +15,9 @@ Email                : nyall dot dawson at gmail dot com
 #include "qgstest.h"
 
 #include "qgsapplication.h"
+#include "qgsidwinterpolator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
 #include "DualEdgeTriangulation.h"
 
 class TestQgsInterpolator : public QObject
@@ -29,6 +32,7 @@ class TestQgsInterpolator : public QObject
     void init() ;// will be called before each testfunction is executed.
     void cleanup() ;// will be called after every testfunction.
     void dualEdge();
+    void idwNeighbors();
 
   private:
 };
@@ -265,5 +269,78 @@ void TestQgsInterpolator::dualEdge()
 //  QVERIFY( tri.getSurroundingTriangles( 0 ).empty() );
 }
 
+void TestQgsInterpolator::idwNeighbors()
+{
+  QgsVectorLayer layer( QStringLiteral( "Point?field=z:double" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+  QgsFeatureList features;
+  auto addPoint = [&features, &layer]( double x, double y, double z )
+  {
+    QgsFeature f( layer.fields() );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( x, y ) ) );
+    f.setAttributes( QgsAttributes() << z );
+    features << f;
+  };
+  addPoint( 0, 0, 1 );
+  addPoint( 10, 0, 2 );
+  addPoint( 0, 10, 3 );
+  addPoint( 100, 100, 10 );
+  QVERIFY( layer.dataProvider()->addFeatures( features ) );
+
+  QgsInterpolator::LayerData data;
+  data.source = &layer;
+  data.valueSource = QgsInterpolator::ValueAttribute;
+  data.interpolationAttribute = 0;
+
+  QgsIDWInterpolator all( QList< QgsInterpolator::LayerData >() << data );
+  QVERIFY( all.canInterpolateConcurrently() );
+  double expected = 0;
+  QCOMPARE( all.interpolatePoint( 1, 1, expected ), 0 );
+
+  // using all the neighbors gives the same result
+  QgsIDWInterpolator knn( QList< QgsInterpolator::LayerData >() << data );
+  knn.setMaximumNeighbors( 4 );
+  double result = 0;
+  QCOMPARE( knn.interpolatePoint( 1, 1, result ), 0 );
+  QGSCOMPARENEAR( result, expected, 0.0000001 );
+  knn.setMaximumNeighbors( 10 );
+  QCOMPARE( knn.interpolatePoint( 1, 1, result ), 0 );
+  QGSCOMPARENEAR( result, expected, 0.0000001 );
+
+  // nearest neighbor only
+  knn.setMaximumNeighbors( 1 );
+  QCOMPARE( knn.interpolatePoint( 1, 1, result ), 0 );
+  QCOMPARE( result, 1.0 );
+  QCOMPARE( knn.interpolatePoint( 90, 95, result ), 0 );
+  QCOMPARE( result, 10.0 );
+  // point on a data point
+  knn.setMaximumNeighbors( 2 );
+  QCOMPARE( knn.interpolatePoint( 10, 0, result ), 0 );
+  QCOMPARE( result, 2.0 );
+
+  // search radius, excluding the far point
+  QgsIDWInterpolator radius( QList< QgsInterpolator::LayerData >() << data );
+  radius.setSearchRadius( 20 );
+  QCOMPARE( radius.interpolatePoint( 1, 1, result ), 0 );
+  expected = ( 0.5 * 1 + ( 2.0 + 3.0 ) / 82.0 ) / ( 0.5 + 2.0 / 82.0 );
+  QGSCOMPARENEAR( result, expected, 0.0000001 );
+  // no data point within the radius
+  QCOMPARE( radius.interpolatePoint( 50, 50, result ), 1 );
+
+  // radius and maximum number of neighbors
+  radius.setMaximumNeighbors( 1 );
+  QCOMPARE( radius.interpolatePoint( 9, 1, result ), 0 );
+  QCOMPARE( result, 2.0 );
+  QCOMPARE( radius.interpolatePoint( 50, 50, result ), 1 );
+
+  // preparing caches the data once, even without any data point
+  QgsVectorLayer empty( QStringLiteral( "Point?field=z:double" ), QStringLiteral( "empty" ), QStringLiteral( "memory" ) );
+  data.source = &empty;
+  QgsIDWInterpolator none( QList< QgsInterpolator::LayerData >() << data );
+  none.setMaximumNeighbors( 2 );
+  QCOMPARE( none.prepareInterpolation(), QgsInterpolator::Success );
+  QCOMPARE( none.interpolatePoint( 1, 1, result ), 1 );
+}
+
 QGSTEST_MAIN( TestQgsInterpolator )
 #include "testqgsinterpolator.moc"
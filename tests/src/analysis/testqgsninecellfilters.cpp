@@ -28,6 +28,46 @@
 #endif
 
 #include <QDir>
+#include <QTemporaryDir>
+#include <algorithm>
+
+//! Weights each cell of the window differently, so that misplaced rows or columns change the result
+class WeightedSumFilter : public QgsNineCellFilter
+{
+  public:
+    WeightedSumFilter( const QString &inputFile, const QString &outputFile )
+      : QgsNineCellFilter( inputFile, outputFile, QStringLiteral( "GTiff" ) )
+    {}
+
+    float processNineCellWindow( float *x11, float *x21, float *x31,
+                                 float *x12, float *x22, float *x32,
+                                 float *x13, float *x23, float *x33 ) override
+    {
+      const float *cells[9] = { x11, x21, x31, x12, x22, x32, x13, x23, x33 };
+      float sum = 0;
+      for ( int i = 0; i < 9; ++i )
+      {
+        if ( *cells[i] == mInputNodataValue )
+          return mOutputNodataValue;
+        sum += ( i + 1 ) * *cells[i];
+      }
+      return sum;
+    }
+};
+
+//! Overrides the window of a filter which processes its rows without virtual calls
+class ConstantSlopeFilter : public QgsSlopeFilter
+{
+  public:
+    ConstantSlopeFilter( const QString &inputFile, const QString &outputFile )
+      : QgsSlopeFilter( inputFile, outputFile, QStringLiteral( "GTiff" ) )
+    {}
+
+    float processNineCellWindow( float *, float *, float *, float *, float *, float *, float *, float *, float * ) override
+    {
+      return 42;
+    }
+};
 
 // If true regenerate raster reference images
 const bool REGENERATE_REFERENCES = false;
@@ -47,6 +87,8 @@ class TestNineCellFilters : public QObject
     void testAspect();
     void testRuggedness();
     void testTotalCurvature();
+    void testMultipleBands();
+    void testOverriddenWindow();
 #ifdef HAVE_OPENCL
     void testHillshadeCl();
     void testSlopeCl();
@@ -215,6 +257,93 @@ void TestNineCellFilters::testTotalCurvature()
   _testAlg<QgsTotalCurvatureFilter>( QStringLiteral( "totalcurvature" ) );
 }
 
+void TestNineCellFilters::testMultipleBands()
+{
+  // the filter processes bands of about 4M cells: 4094 columns (4096 with the nodata borders)
+  // give bands of 1024 rows, so that this raster is split in three bands
+  const int xSize = 4094;
+  const int ySize = 2100;
+  const float nodata = -9999;
+
+  QTemporaryDir dir;
+  const QString inputFile = dir.filePath( QStringLiteral( "input.tif" ) );
+  const QString outputFile = dir.filePath( QStringLiteral( "output.tif" ) );
+
+  std::vector< float > input( static_cast< std::size_t >( xSize ) * ySize );
+  for ( int row = 0; row < ySize; ++row )
+  {
+    for ( int col = 0; col < xSize; ++col )
+    {
+      input[ static_cast< std::size_t >( row ) * xSize + col ] = ( row * 7 + col ) % 97 == 0 ? nodata : ( row * 31 + col * 17 ) % 101;
+    }
+  }
+
+  {
+    gdal::dataset_unique_ptr dataset( GDALCreate( GDALGetDriverByName( "GTiff" ), inputFile.toUtf8().constData(), xSize, ySize, 1, GDT_Float32, nullptr ) );
+    QVERIFY( dataset );
+    double geoTransform[6] = { 0, 1, 0, ySize, 0, -1 };
+    GDALSetGeoTransform( dataset.get(), geoTransform );
+    GDALRasterBandH band = GDALGetRasterBand( dataset.get(), 1 );
+    GDALSetRasterNoDataValue( band, nodata );
+    QCOMPARE( GDALRasterIO( band, GF_Write, 0, 0, xSize, ySize, input.data(), xSize, ySize, GDT_Float32, 0, 0 ), CE_None );
+  }
+
+  WeightedSumFilter filter( inputFile, outputFile );
+  QCOMPARE( filter.processRaster(), 0 );
+
+  std::vector< float > output( input.size() );
+  {
+    gdal::dataset_unique_ptr dataset( GDALOpen( outputFile.toUtf8().constData(), GA_ReadOnly ) );
+    QVERIFY( dataset );
+    GDALRasterBandH band = GDALGetRasterBand( dataset.get(), 1 );
+    QCOMPARE( GDALRasterIO( band, GF_Read, 0, 0, xSize, ySize, output.data(), xSize, ySize, GDT_Float32, 0, 0 ), CE_None );
+  }
+
+  // compare with the window computed cell by cell, including the rows next to the band limits
+  auto inputValue = [&]( int row, int col )
+  {
+    if ( row < 0 || row >= ySize || col < 0 || col >= xSize )
+      return nodata;
+    return input[ static_cast< std::size_t >( row ) * xSize + col ];
+  };
+  int mismatches = 0;
+  for ( int row = 0; row < ySize; ++row )
+  {
+    for ( int col = 0; col < xSize; ++col )
+    {
+      float x11 = inputValue( row - 1, col - 1 ), x21 = inputValue( row - 1, col ), x31 = inputValue( row - 1, col + 1 );
+      float x12 = inputValue( row, col - 1 ), x22 = inputValue( row, col ), x32 = inputValue( row, col + 1 );
+      float x13 = inputValue( row + 1, col - 1 ), x23 = inputValue( row + 1, col ), x33 = inputValue( row + 1, col + 1 );
+      const float expected = filter.processNineCellWindow( &x11, &x21, &x31, &x12, &x22, &x32, &x13, &x23, &x33 );
+      if ( output[ static_cast< std::size_t >( row ) * xSize + col ] != expected )
+      {
+        if ( mismatches++ == 0 )
+          qDebug() << "First mismatch at row" << row << "column" << col;
+      }
+    }
+  }
+  QCOMPARE( mismatches, 0 );
+}
+
+void TestNineCellFilters::testOverriddenWindow()
+{
+#ifdef HAVE_OPENCL
+  QgsOpenClUtils::setEnabled( false );
+#endif
+  QTemporaryDir dir;
+  const QString outputFile = dir.filePath( QStringLiteral( "output.tif" ) );
+  ConstantSlopeFilter filter( SRC_FILE, outputFile );
+  QCOMPARE( filter.processRaster(), 0 );
+
+  gdal::dataset_unique_ptr dataset( GDALOpen( outputFile.toUtf8().constData(), GA_ReadOnly ) );
+  QVERIFY( dataset );
+  const int xSize = GDALGetRasterXSize( dataset.get() );
+  const int ySize = GDALGetRasterYSize( dataset.get() );
+  std::vector< float > output( static_cast< std::size_t >( xSize ) * ySize );
+  GDALRasterBandH band = GDALGetRasterBand( dataset.get(), 1 );
+  QCOMPARE( GDALRasterIO( band, GF_Read, 0, 0, xSize, ySize, output.data(), xSize, ySize, GDT_Float32, 0, 0 ), CE_None );
+  QVERIFY( std::all_of( output.begin(), output.end(), []( float value ) { return value == 42; } ) );
+}
 
 QGSTEST_MAIN( TestNineCellFilters )
 
@@ -16,6 +16,7 @@ Email                : nyall dot dawson at gmail dot com
 
 #include "qgsrastercalculator.h"
 #include "qgsrastercalcnode.h"
+#include "qgsrastercalcprogram.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasterlayer.h"
 #include "qgsrastermatrix.h"
@@ -50,6 +51,7 @@ class TestQgsRasterCalculator : public QObject
 
     void rasterRefOp();
     void dualOpRasterRaster(); //test dual op on raster ref and raster ref
+    void compiledProgram(); //test compiled expressions give the same results as the tree
 
     void calcWithLayers();
     void calcWithReprojectedLayers();
@@ -423,6 +425,68 @@ void TestQgsRasterCalculator::dualOpRasterRaster()
   QCOMPARE( result.data()[5], -9999.0 );
 }
 
+void TestQgsRasterCalculator::compiledProgram()
+{
+  QgsRasterBlock m1( Qgis::Float32, 3, 2 );
+  m1.setNoDataValue( -1.0 );
+  const double values1[] = { 1.0, -1.0, 0.0, 4.0, -5.0, 0.5 };
+  for ( int i = 0; i < 6; ++i )
+    m1.setValue( i / 3, i % 3, values1[i] );
+
+  QgsRasterBlock m2( Qgis::Int16, 3, 2 );
+  m2.setNoDataValue( -2.0 ); //different no data value
+  const double values2[] = { 2.0, 3.0, -2.0, 0.0, 2.0, -3.0 };
+  for ( int i = 0; i < 6; ++i )
+    m2.setValue( i / 3, i % 3, values2[i] );
+
+  QMap<QString, QgsRasterBlock *> rasterData;
+  rasterData.insert( QStringLiteral( "raster@1" ), &m1 );
+  rasterData.insert( QStringLiteral( "raster@2" ), &m2 );
+
+  const QStringList expressions
+  {
+    QStringLiteral( "\"raster@1\" + \"raster@2\" * 2" ),
+    QStringLiteral( "\"raster@1\" / \"raster@2\"" ),
+    QStringLiteral( "\"raster@2\" ^ \"raster@1\"" ),
+    QStringLiteral( "sqrt( \"raster@1\" ) + log10( \"raster@2\" )" ),
+    QStringLiteral( "( \"raster@1\" > 0 ) AND ( \"raster@2\" <= 2 ) OR \"raster@1\" = 0.5" ),
+    QStringLiteral( "-\"raster@1\" + ln( 2 ^ 3 ) * cos( \"raster@2\" - 1 )" ),
+    QStringLiteral( "\"raster@1\" * ( 1 / 0 )" ),
+    QStringLiteral( "atan( 3 + 2 )" ),
+  };
+
+  for ( const QString &expression : expressions )
+  {
+    QString error;
+    std::unique_ptr< QgsRasterCalcNode > calcNode( QgsRasterCalcNode::parseRasterCalcString( expression, error ) );
+    QVERIFY2( calcNode, error.toLocal8Bit().constData() );
+
+    QgsRasterMatrix result;
+    result.setNodataValue( -9999 );
+    QVERIFY( calcNode->calculate( rasterData, result ) );
+
+    QgsRasterCalcProgram program( -9999 );
+    QVERIFY( program.compile( calcNode.get() ) );
+    QVector< const QgsRasterBlock * > blocks;
+    for ( const QString &name : program.rasterNames() )
+      blocks << rasterData.value( name );
+
+    for ( int i = 0; i < 6; ++i )
+    {
+      const double expected = result.isNumber() ? result.number() : result.data()[i];
+      QCOMPARE( program.evaluate( blocks, i ), expected );
+    }
+  }
+
+  // matrices cannot be compiled
+  double *data = new double[4] { 1, 2, 3, 4 };
+  QgsRasterMatrix matrix( 2, 2, data, -1 );
+  QgsRasterCalcNode matrixNode( QgsRasterCalcNode::opPLUS, new QgsRasterCalcNode( &matrix ), new QgsRasterCalcNode( 1.0 ) );
+  QgsRasterCalcProgram program;
+  QVERIFY( !program.compile( &matrixNode ) );
+  QVERIFY( !program.isValid() );
+}
+
 void TestQgsRasterCalculator::calcWithLayers()
 {
   QgsRasterCalculatorEntry entry1;
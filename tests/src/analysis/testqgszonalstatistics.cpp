@@ -14,6 +14,7 @@
  ***************************************************************************/
 
 #include <QDir>
+#include <QTextStream>
 #include "qgstest.h"
 
 #include "qgsapplication.h"
@@ -23,6 +24,7 @@
 #include "qgszonalstatistics.h"
 #include "qgsproject.h"
 #include "qgsvectorlayerutils.h"
+#include "qgsvectordataprovider.h"
 
 /**
  * \ingroup UnitTests
@@ -42,6 +44,7 @@ class TestQgsZonalStatistics : public QObject
     void testReprojection();
     void testNoData();
     void testSmallPolygons();
+    void testRasterization();
 
   private:
     QgsVectorLayer *mVectorLayer = nullptr;
@@ -343,5 +346,96 @@ void TestQgsZonalStatistics::testSmallPolygons()
   QGSCOMPARENEAR( f.attribute( "nmean" ).toDouble(), 864.285638, 0.001 );
 }
 
+void TestQgsZonalStatistics::testRasterization()
+{
+  // a 20x20 raster whose cells all have different values, so that the sum identifies the cells
+  const int size = 20;
+  const QString rasterPath = mTempPath + "rasterization.asc";
+  QFile rasterFile( rasterPath );
+  QVERIFY( rasterFile.open( QIODevice::WriteOnly | QIODevice::Truncate ) );
+  QTextStream stream( &rasterFile );
+  stream << "ncols " << size << "\nnrows " << size << "\nxllcorner 0\nyllcorner 0\ncellsize 1\n";
+  for ( int row = 0; row < size; ++row )
+  {
+    for ( int col = 0; col < size; ++col )
+      stream << row * size + col << ' ';
+    stream << '\n';
+  }
+  stream.flush();
+  rasterFile.close();
+  QgsRasterLayer rasterLayer( rasterPath, QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  QVERIFY( rasterLayer.isValid() );
+
+  const QStringList wkts = QStringList()
+                           // polygon with a hole
+                           << QStringLiteral( "MultiPolygon(((2.3 2.7, 15.6 2.7, 15.6 17.2, 2.3 17.2, 2.3 2.7),(6.2 6.4, 10.8 6.4, 10.8 11.3, 6.2 11.3, 6.2 6.4)))" )
+                           // multipolygon, with a part in the hole of the other
+                           << QStringLiteral( "MultiPolygon(((1.2 1.1, 19.4 1.1, 19.4 18.7, 1.2 18.7, 1.2 1.1),(4.1 4.2, 16.3 4.2, 16.3 15.8, 4.1 15.8, 4.1 4.2)),((7.6 7.2, 11.9 8.3, 9.1 12.6, 7.6 7.2)))" )
+                           // edges through cell centers
+                           << QStringLiteral( "MultiPolygon(((3.5 3.5, 12.5 3.5, 12.5 9.5, 3.5 9.5, 3.5 3.5)))" )
+                           << QStringLiteral( "MultiPolygon(((0.5 0.5, 10.5 0.5, 0.5 10.5, 0.5 0.5)))" )
+                           << QStringLiteral( "MultiPolygon(((5.5 2.5, 9.5 6.5, 5.5 10.5, 1.5 6.5, 5.5 2.5),(5.5 4.5, 7.5 6.5, 5.5 8.5, 3.5 6.5, 5.5 4.5)))" )
+                           // no cell center inside, uses the precise intersection
+                           << QStringLiteral( "MultiPolygon(((4.8 4.8, 5.3 4.8, 5.3 5.4, 4.8 5.4, 4.8 4.8)))" )
+                           << QStringLiteral( "MultiPolygon(((4.2 4.2, 4.8 4.2, 4.5 4.9, 4.2 4.2)))" );
+
+  QgsVectorLayer vectorLayer( QStringLiteral( "MultiPolygon" ), QStringLiteral( "polys" ), QStringLiteral( "memory" ) );
+  QVERIFY( vectorLayer.isValid() );
+  QgsFeatureList features;
+  for ( const QString &wkt : wkts )
+  {
+    QgsFeature f;
+    f.setGeometry( QgsGeometry::fromWkt( wkt ) );
+    QVERIFY( !f.geometry().isNull() );
+    features << f;
+  }
+  QVERIFY( vectorLayer.dataProvider()->addFeatures( features ) );
+
+  QgsZonalStatistics zs( &vectorLayer, &rasterLayer, QString(), 1, QgsZonalStatistics::Count | QgsZonalStatistics::Sum );
+  QCOMPARE( zs.calculateStatistics( nullptr ), 0 );
+
+  // reference statistics, from a GEOS test of each cell
+  QgsFeatureIterator it = vectorLayer.getFeatures();
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    const QgsGeometry geometry = f.geometry();
+    double count = 0;
+    double sum = 0;
+    for ( int row = 0; row < size; ++row )
+    {
+      for ( int col = 0; col < size; ++col )
+      {
+        QgsPointXY center( col + 0.5, size - row - 0.5 );
+        if ( geometry.contains( &center ) )
+        {
+          count += 1;
+          sum += row * size + col;
+        }
+      }
+    }
+    if ( count <= 1 )
+    {
+      count = 0;
+      sum = 0;
+      for ( int row = 0; row < size; ++row )
+      {
+        for ( int col = 0; col < size; ++col )
+        {
+          const double area = QgsGeometry::fromRect( QgsRectangle( col, size - row - 1, col + 1, size - row ) ).intersection( geometry ).area();
+          if ( area > 0 )
+          {
+            count += area;
+            sum += ( row * size + col ) * area;
+          }
+        }
+      }
+    }
+
+    QGSCOMPARENEAR( f.attribute( "count" ).toDouble(), count, 0.000001 );
+    QGSCOMPARENEAR( f.attribute( "sum" ).toDouble(), sum, 0.000001 );
+  }
+}
+
 QGSTEST_MAIN( TestQgsZonalStatistics )
 #include "testqgszonalstatistics.moc"
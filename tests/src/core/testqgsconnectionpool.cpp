@@ -15,6 +15,7 @@
  *                                                                         *
  ***************************************************************************/
 #include "qgsapplication.h"
+#include "qgsconnectionpool.h"
 #include "qgsfeatureiterator.h"
 #include "qgsgeometry.h"
 #include "qgspoint.h"
@@ -26,6 +27,53 @@
 #include <QtConcurrentMap>
 #include "qgstest.h"
 
+//! Connection of the test pool group, which doesn't connect to anything
+struct TestConnection
+{
+  QString connInfo;
+};
+
+QString qgsConnectionPool_ConnectionToName( TestConnection *c ) { return c->connInfo; }
+void qgsConnectionPool_ConnectionCreate( const QString &connInfo, TestConnection *&c ) { c = new TestConnection{ connInfo }; }
+void qgsConnectionPool_ConnectionDestroy( TestConnection *c ) { delete c; }
+void qgsConnectionPool_InvalidateConnection( TestConnection * ) {}
+bool qgsConnectionPool_ConnectionIsValid( TestConnection * ) { return true; }
+
+class TestConnectionPoolGroup : public QObject, public QgsConnectionPoolGroup<TestConnection *>
+{
+    Q_OBJECT
+
+  public:
+    explicit TestConnectionPoolGroup( const QString &name )
+      : QgsConnectionPoolGroup<TestConnection *>( name )
+    {
+      initTimer( this );
+    }
+
+    //! Acquires connections without waiting until none is available, and returns their number
+    int acquireAll()
+    {
+      while ( TestConnection *c = acquire( 0, false ) )
+        mAcquired << c;
+      return mAcquired.count();
+    }
+
+    void releaseAll()
+    {
+      for ( TestConnection *c : qgis::as_const( mAcquired ) )
+        release( c );
+      mAcquired.clear();
+    }
+
+  protected slots:
+    void handleConnectionExpired() { onConnectionExpired(); }
+    void startExpirationTimer() { expirationTimer->start(); }
+    void stopExpirationTimer() { expirationTimer->stop(); }
+
+  private:
+    QList<TestConnection *> mAcquired;
+};
+
 class TestQgsConnectionPool: public QObject
 {
     Q_OBJECT
@@ -34,6 +82,8 @@ class TestQgsConnectionPool: public QObject
     void initTestCase();
     void cleanupTestCase();
     void layersFromSameDatasetGPX();
+    void maxConcurrentConnections();
+    void concurrentReadersOnSameLayer();
 
   private:
     struct ReadJob
@@ -140,5 +190,74 @@ void TestQgsConnectionPool::layersFromSameDatasetGPX()
   QFile( testFile.fileName() ).remove();
 }
 
+void TestQgsConnectionPool::maxConcurrentConnections()
+{
+  const int defaultPoolSize = QgsApplication::maxConcurrentConnectionsPerPool();
+
+  TestConnectionPoolGroup defaultGroup( QStringLiteral( "default" ) );
+  QCOMPARE( defaultGroup.acquireAll(), defaultPoolSize );
+
+  // only groups created after the call use the new size
+  QgsApplication::setMaxConcurrentConnectionsPerPool( 2 * defaultPoolSize + 1 );
+  QCOMPARE( QgsApplication::maxConcurrentConnectionsPerPool(), 2 * defaultPoolSize + 1 );
+  TestConnectionPoolGroup largerGroup( QStringLiteral( "larger" ) );
+  QCOMPARE( largerGroup.acquireAll(), 2 * defaultPoolSize + 1 );
+  QCOMPARE( defaultGroup.acquireAll(), defaultPoolSize );
+
+  // released connections can be acquired again
+  largerGroup.releaseAll();
+  QCOMPARE( largerGroup.acquireAll(), 2 * defaultPoolSize + 1 );
+  largerGroup.releaseAll();
+  defaultGroup.releaseAll();
+
+  QgsApplication::setMaxConcurrentConnectionsPerPool( -1 );
+  QCOMPARE( QgsApplication::maxConcurrentConnectionsPerPool(), defaultPoolSize );
+}
+
+void TestQgsConnectionPool::concurrentReadersOnSameLayer()
+{
+  // Read iterators get their own dataset handle from the connection pool,
+  // check that readers running concurrently on a larger pool get all the features
+  const int nWaypoints = 10000;
+  const int nReaders = 8;
+  QTemporaryFile testFile( QStringLiteral( "testXXXXXX.gpx" ) );
+  testFile.setAutoRemove( false );
+  testFile.open();
+  testFile.write( "<gpx version=\"1.1\" creator=\"qgis\">\n" );
+  for ( int i = 0; i < nWaypoints; ++i )
+  {
+    testFile.write( QStringLiteral( "<wpt lon=\"%1\" lat=\"%1\"><name></name></wpt>\n" ).arg( i ).toLocal8Bit() );
+  }
+  testFile.write( "</gpx>\n" );
+  testFile.close();
+
+  const int defaultPoolSize = QgsApplication::maxConcurrentConnectionsPerPool();
+  QgsApplication::setMaxConcurrentConnectionsPerPool( nReaders );
+  QCOMPARE( QgsApplication::maxConcurrentConnectionsPerPool(), nReaders );
+
+  QgsVectorLayer *layer = new QgsVectorLayer( testFile.fileName() + "|layername=waypoints", QStringLiteral( "Waypoints" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer->isValid() );
+
+  QList<ReadJob> jobs;
+  for ( int i = 0; i < nReaders; ++i )
+    jobs << ReadJob( layer );
+
+  QEventLoop evLoop;
+  QFutureWatcher<void> futureWatcher;
+  connect( &futureWatcher, SIGNAL( finished() ), &evLoop, SLOT( quit() ) );
+  futureWatcher.setFuture( QtConcurrent::map( jobs, processJob ) );
+  evLoop.exec();
+
+  for ( const ReadJob &job : qgis::as_const( jobs ) )
+  {
+    QCOMPARE( job.features.count(), nWaypoints );
+  }
+
+  delete layer;
+  QgsApplication::setMaxConcurrentConnectionsPerPool( -1 );
+  QCOMPARE( QgsApplication::maxConcurrentConnectionsPerPool(), defaultPoolSize );
+  QFile( testFile.fileName() ).remove();
+}
+
 QGSTEST_MAIN( TestQgsConnectionPool )
 #include "testqgsconnectionpool.moc"
@@ -38,6 +38,7 @@ class TestQgsCoordinateTransform: public QObject
     void contextShared();
     void scaleFactor();
     void scaleFactor_data();
+    void webMercator();
 
   private:
 
@@ -294,5 +295,49 @@ void TestQgsCoordinateTransform::transformBoundingBox()
   QVERIFY( errorObtained );
 }
 
+void TestQgsCoordinateTransform::webMercator()
+{
+  QgsCoordinateTransform tr( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance() );
+
+  QVector< double > x = QVector< double >() << 10 << -179.5 << 0;
+  QVector< double > y = QVector< double >() << 50 << -85 << 0;
+  QVector< double > z = QVector< double >() << 0 << 0 << 0;
+  tr.transformInPlace( x, y, z );
+  QGSCOMPARENEAR( x.at( 0 ), 1113194.907933, 0.000001 );
+  QGSCOMPARENEAR( y.at( 0 ), 6446275.841017, 0.000001 );
+  QGSCOMPARENEAR( x.at( 1 ), -19981848.597393, 0.000001 );
+  QGSCOMPARENEAR( y.at( 1 ), -19971868.880409, 0.000001 );
+  QGSCOMPARENEAR( x.at( 2 ), 0, 0.000001 );
+  QGSCOMPARENEAR( y.at( 2 ), 0, 0.000001 );
+
+  tr.transformInPlace( x, y, z, QgsCoordinateTransform::ReverseTransform );
+  QGSCOMPARENEAR( x.at( 0 ), 10, 0.000000001 );
+  QGSCOMPARENEAR( y.at( 0 ), 50, 0.000000001 );
+  QGSCOMPARENEAR( x.at( 1 ), -179.5, 0.000000001 );
+  QGSCOMPARENEAR( y.at( 1 ), -85, 0.000000001 );
+
+  QgsPointXY p = QgsCoordinateTransform( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsProject::instance() )
+                 .transform( QgsPointXY( 1113194.907933, 6446275.841017 ) );
+  QGSCOMPARENEAR( p.x(), 10, 0.000000001 );
+  QGSCOMPARENEAR( p.y(), 50, 0.000000001 );
+
+  // coordinates outside of the analytic transform domain are still handled by proj
+  bool errorObtained = false;
+  try
+  {
+    tr.transform( QgsPointXY( 0, 90 ) );
+  }
+  catch ( QgsCsException & )
+  {
+    errorObtained = true;
+  }
+  QVERIFY( errorObtained );
+
+  // wrapped longitudes
+  p = tr.transform( QgsPointXY( 190, 0 ) );
+  QGSCOMPARENEAR( p.x(), -18924313.434857, 0.000001 );
+  QGSCOMPARENEAR( p.y(), 0, 0.000001 );
+}
+
 QGSTEST_MAIN( TestQgsCoordinateTransform )
 #include "testqgscoordinatetransform.moc"
@@ -0,0 +1,201 @@
+/***************************************************************************
+     testqgsfeaturetextindex.cpp
+     ---------------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsfeaturetextindex.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayer.h"
+
+class TestQgsFeatureTextIndex : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void search();
+    void invalidate();
+    void displayExpressionOnly();
+    void caseFolding();
+
+  private:
+    std::unique_ptr< QgsVectorLayer > createLayer();
+};
+
+void TestQgsFeatureTextIndex::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsFeatureTextIndex::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+std::unique_ptr< QgsVectorLayer > TestQgsFeatureTextIndex::createLayer()
+{
+  std::unique_ptr< QgsVectorLayer > layer = qgis::make_unique< QgsVectorLayer >( QStringLiteral( "Point?field=name:string&field=street:string&field=number:integer" ),
+      QStringLiteral( "places" ), QStringLiteral( "memory" ) );
+  layer->setDisplayExpression( QStringLiteral( "\"name\" || ' ' || \"number\"" ) );
+
+  QgsFeatureList features;
+  QgsFeature f( layer->fields() );
+  f.setAttributes( QgsAttributes() << QStringLiteral( "Town Hall" ) << QStringLiteral( "Main Street" ) << 1 );
+  features << f;
+  f.setAttributes( QgsAttributes() << QStringLiteral( "Library" ) << QStringLiteral( "Station Road" ) << 2 );
+  features << f;
+  f.setAttributes( QgsAttributes() << QStringLiteral( "Main station" ) << QVariant( QVariant::String ) << 3 );
+  features << f;
+  layer->dataProvider()->addFeatures( features );
+  return layer;
+}
+
+void TestQgsFeatureTextIndex::search()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+  QgsFeatureTextIndex *textIndex = QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionAndStringFields );
+  QCOMPARE( QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionAndStringFields ), textIndex );
+
+  QVERIFY( !textIndex->index() );
+  QVERIFY( textIndex->isBuilding() );
+  textIndex->waitForFinished();
+  QVERIFY( !textIndex->isBuilding() );
+  std::shared_ptr< const QgsFeatureTextIndex::Index > index = textIndex->index();
+  QVERIFY( index );
+  // 3 display texts, 5 non null string values
+  QCOMPARE( index->count(), 8 );
+
+  // display expression
+  QVector< QgsFeatureTextIndex::Entry > entries = index->search( QStringList() << QStringLiteral( "hall" ), true, 10 );
+  QCOMPARE( entries.count(), 1 );
+  QCOMPARE( entries.at( 0 ).field, QgsFeatureTextIndex::DISPLAY_EXPRESSION );
+  QCOMPARE( entries.at( 0 ).text, QStringLiteral( "Town Hall 1" ) );
+
+  // parts must appear in order
+  entries = index->search( QStringList() << QStringLiteral( "main" ) << QStringLiteral( "3" ), true, 10 );
+  QCOMPARE( entries.count(), 1 );
+  QCOMPARE( entries.at( 0 ).text, QStringLiteral( "Main station 3" ) );
+  QVERIFY( index->search( QStringList() << QStringLiteral( "3" ) << QStringLiteral( "main" ), true, 10 ).isEmpty() );
+
+  // parts shorter than a trigram
+  QCOMPARE( index->search( QStringList() << QStringLiteral( "a" ), true, 10 ).count(), 3 );
+  QCOMPARE( index->search( QStringList() << QStringLiteral( "a" ), true, 2 ).count(), 2 );
+
+  // unknown trigram
+  QVERIFY( index->search( QStringList() << QStringLiteral( "museum" ), true, 10 ).isEmpty() );
+
+  // fields, at most one entry per feature
+  entries = index->search( QStringList() << QStringLiteral( "STATION" ), false, 10 );
+  QCOMPARE( entries.count(), 2 );
+  QCOMPARE( entries.at( 0 ).field, 1 );
+  QCOMPARE( entries.at( 0 ).text, QStringLiteral( "Station Road" ) );
+  QCOMPARE( entries.at( 1 ).field, 0 );
+  QCOMPARE( entries.at( 1 ).text, QStringLiteral( "Main station" ) );
+  QCOMPARE( index->displayText( entries.at( 1 ).id ), QStringLiteral( "Main station 3" ) );
+
+  entries = index->search( QStringList() << QStringLiteral( "main" ), false, 10 );
+  QCOMPARE( entries.count(), 2 );
+  QCOMPARE( entries.at( 0 ).text, QStringLiteral( "Main Street" ) );
+  QCOMPARE( entries.at( 1 ).text, QStringLiteral( "Main station" ) );
+}
+
+void TestQgsFeatureTextIndex::invalidate()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+  QgsFeatureTextIndex *textIndex = QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionAndStringFields );
+  textIndex->index();
+  textIndex->waitForFinished();
+  std::shared_ptr< const QgsFeatureTextIndex::Index > index = textIndex->index();
+  QVERIFY( index );
+  QVERIFY( index->search( QStringList() << QStringLiteral( "museum" ), true, 10 ).isEmpty() );
+
+  // edits drop the index
+  layer->startEditing();
+  QgsFeature f( layer->fields() );
+  f.setAttributes( QgsAttributes() << QStringLiteral( "Museum" ) << QStringLiteral( "Park Lane" ) << 4 );
+  QVERIFY( layer->addFeature( f ) );
+  QVERIFY( !textIndex->index() );
+  textIndex->waitForFinished();
+  index = textIndex->index();
+  QVERIFY( index );
+  QVector< QgsFeatureTextIndex::Entry > entries = index->search( QStringList() << QStringLiteral( "museum" ), true, 10 );
+  QCOMPARE( entries.count(), 1 );
+  QCOMPARE( entries.at( 0 ).text, QStringLiteral( "Museum 4" ) );
+
+  // so do display expression changes
+  layer->setDisplayExpression( QStringLiteral( "\"street\"" ) );
+  QVERIFY( !textIndex->index() );
+  textIndex->waitForFinished();
+  index = textIndex->index();
+  QVERIFY( index );
+  QVERIFY( index->search( QStringList() << QStringLiteral( "museum" ), true, 10 ).isEmpty() );
+  QCOMPARE( index->search( QStringList() << QStringLiteral( "lane" ), true, 10 ).count(), 1 );
+
+  layer->rollBack();
+}
+
+void TestQgsFeatureTextIndex::displayExpressionOnly()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+  QgsFeatureTextIndex *allTexts = QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionAndStringFields );
+  QgsFeatureTextIndex *textIndex = QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionOnly );
+  QVERIFY( textIndex != allTexts );
+  QCOMPARE( textIndex->content(), QgsFeatureTextIndex::DisplayExpressionOnly );
+  QCOMPARE( QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionOnly ), textIndex );
+
+  textIndex->index();
+  textIndex->waitForFinished();
+  std::shared_ptr< const QgsFeatureTextIndex::Index > index = textIndex->index();
+  QVERIFY( index );
+  QVERIFY( !textIndex->isTooLarge() );
+  // only the 3 display texts
+  QCOMPARE( index->count(), 3 );
+  QCOMPARE( index->search( QStringList() << QStringLiteral( "station" ), true, 10 ).count(), 1 );
+  QVERIFY( index->search( QStringList() << QStringLiteral( "road" ), false, 10 ).isEmpty() );
+  QCOMPARE( index->displayText( 2 ), QStringLiteral( "Library 2" ) );
+
+  // the other index is not built
+  QVERIFY( !allTexts->isBuilding() );
+}
+
+void TestQgsFeatureTextIndex::caseFolding()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+  layer->startEditing();
+  QgsFeature f( layer->fields() );
+  f.setAttributes( QgsAttributes() << QStringLiteral( "STRASSE ÉTOILE" ) << QVariant( QVariant::String ) << 4 );
+  QVERIFY( layer->addFeature( f ) );
+
+  QgsFeatureTextIndex *textIndex = QgsFeatureTextIndex::indexForLayer( layer.get(), QgsFeatureTextIndex::DisplayExpressionOnly );
+  textIndex->index();
+  textIndex->waitForFinished();
+  std::shared_ptr< const QgsFeatureTextIndex::Index > index = textIndex->index();
+  QVERIFY( index );
+
+  // the original texts are returned
+  QVector< QgsFeatureTextIndex::Entry > entries = index->search( QStringList() << QStringLiteral( "étoile" ), true, 10 );
+  QCOMPARE( entries.count(), 1 );
+  QCOMPARE( entries.at( 0 ).text, QStringLiteral( "STRASSE ÉTOILE 4" ) );
+  QCOMPARE( index->search( QStringList() << QStringLiteral( "Strasse" ) << QStringLiteral( "Étoile" ), true, 10 ).count(), 1 );
+
+  layer->rollBack();
+}
+
+QGSTEST_MAIN( TestQgsFeatureTextIndex )
+#include "testqgsfeaturetextindex.moc"
@@ -0,0 +1,224 @@
+/***************************************************************************
+     testqgsgeneralizedgeometrycache.cpp
+     -----------------------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsfeatureiterator.h"
+#include "qgsgeneralizedgeometrycache.h"
+#include "qgsgeometry.h"
+#include "qgsvectorlayer.h"
+
+#include <cmath>
+
+class TestQgsGeneralizedGeometryCache : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testLevels();
+    void testIterator();
+    void testInvalidate();
+    void testInvalidateOnFieldsChange();
+
+  private:
+    QgsVectorLayer *mLayer = nullptr;
+
+    //! Returns a polygon approximating a circle with the specified number of vertices
+    static QgsGeometry circle( double x, double y, double radius, int vertices );
+};
+
+QgsGeometry TestQgsGeneralizedGeometryCache::circle( double x, double y, double radius, int vertices )
+{
+  QgsPolylineXY ring;
+  for ( int i = 0; i < vertices; ++i )
+  {
+    const double angle = 2 * M_PI * i / vertices;
+    ring << QgsPointXY( x + radius * std::cos( angle ), y + radius * std::sin( angle ) );
+  }
+  ring << ring.at( 0 );
+  return QgsGeometry::fromPolygonXY( QgsPolygonXY() << ring );
+}
+
+void TestQgsGeneralizedGeometryCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsGeneralizedGeometryCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsGeneralizedGeometryCache::init()
+{
+  mLayer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:3857&field=name:string" ), QStringLiteral( "circles" ), QStringLiteral( "memory" ) );
+  QVERIFY( mLayer->isValid() );
+
+  // 10 circles along the x axis, spanning 10000 map units
+  QgsFeatureList features;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QgsFeature f( mLayer->fields() );
+    f.setAttributes( QgsAttributes() << QStringLiteral( "circle %1" ).arg( i ) );
+    f.setGeometry( circle( 500 + i * 1000, 0, 500, 2000 ) );
+    features << f;
+  }
+  QVERIFY( mLayer->dataProvider()->addFeatures( features ) );
+  mLayer->updateExtents();
+}
+
+void TestQgsGeneralizedGeometryCache::cleanup()
+{
+  delete mLayer;
+  mLayer = nullptr;
+}
+
+void TestQgsGeneralizedGeometryCache::testLevels()
+{
+  QVERIFY( !mLayer->generalizedGeometryCache() );
+  mLayer->setGeneralizedGeometryCacheEnabled( true );
+  QVERIFY( mLayer->generalizedGeometryCacheEnabled() );
+  QgsGeneralizedGeometryCache *cache = mLayer->generalizedGeometryCache();
+  QVERIFY( cache );
+
+  // the finest level has a tolerance of 10000 / 8192: levels are not built for finer tolerances
+  QVERIFY( !cache->level( 1 ) );
+  QVERIFY( !cache->isBuilding() );
+
+  // levels are built in the background on first request
+  QVERIFY( !cache->level( 100 ) );
+  cache->waitForFinished();
+  QVERIFY( !cache->isBuilding() );
+
+  // coarsest level has a tolerance of 10000 / 256
+  std::shared_ptr< const QgsGeneralizedGeometryCache::Level > level = cache->level( 100 );
+  QVERIFY( level );
+  QGSCOMPARENEAR( level->tolerance, 10000.0 / 256, 0.000001 );
+  QCOMPARE( level->features.size(), 10 );
+  QCOMPARE( level->features.at( 3 ).attribute( 0 ).toString(), QStringLiteral( "circle 3" ) );
+  const int coarseVertices = level->features.at( 0 ).geometry().constGet()->nCoordinates();
+  QVERIFY( coarseVertices < 2001 );
+  QVERIFY( coarseVertices >= 4 );
+
+  // picks the coarsest level not exceeding the tolerance
+  level = cache->level( 10 );
+  QVERIFY( level );
+  QGSCOMPARENEAR( level->tolerance, 10000.0 / 1024, 0.000001 );
+  QVERIFY( level->features.at( 0 ).geometry().constGet()->nCoordinates() > coarseVertices );
+
+  // no level is detailed enough
+  QVERIFY( !cache->level( 1 ) );
+  QVERIFY( !cache->isBuilding() );
+
+  mLayer->setGeneralizedGeometryCacheEnabled( false );
+  QVERIFY( !mLayer->generalizedGeometryCache() );
+}
+
+void TestQgsGeneralizedGeometryCache::testIterator()
+{
+  mLayer->setGeneralizedGeometryCacheEnabled( true );
+  QgsGeneralizedGeometryCache *cache = mLayer->generalizedGeometryCache();
+  cache->level( 100 );
+  cache->waitForFinished();
+  std::shared_ptr< const QgsGeneralizedGeometryCache::Level > level = cache->level( 100 );
+  QVERIFY( level );
+
+  QgsFeature f;
+  int count = 0;
+  QgsFeatureIterator it = QgsGeneralizedGeometryCache::getFeatures( level, QgsFeatureRequest() );
+  while ( it.nextFeature( f ) )
+    count++;
+  QCOMPARE( count, 10 );
+
+  // features are returned in the provider order
+  QStringList names;
+  it = QgsGeneralizedGeometryCache::getFeatures( level, QgsFeatureRequest().setFilterRect( QgsRectangle( 2100, -100, 4900, 100 ) ) );
+  while ( it.nextFeature( f ) )
+    names << f.attribute( 0 ).toString();
+  QCOMPARE( names, QStringList() << QStringLiteral( "circle 2" ) << QStringLiteral( "circle 3" ) << QStringLiteral( "circle 4" ) );
+
+  names.clear();
+  it = QgsGeneralizedGeometryCache::getFeatures( level, QgsFeatureRequest().setFilterRect( QgsRectangle( 2100, -100, 4900, 100 ) )
+       .setFilterExpression( QStringLiteral( "name <> 'circle 3'" ) ) );
+  while ( it.nextFeature( f ) )
+    names << f.attribute( 0 ).toString();
+  QCOMPARE( names, QStringList() << QStringLiteral( "circle 2" ) << QStringLiteral( "circle 4" ) );
+
+  const QgsFeatureId fid = level->features.at( 5 ).id();
+  it = QgsGeneralizedGeometryCache::getFeatures( level, QgsFeatureRequest().setFilterFid( fid ) );
+  QVERIFY( it.nextFeature( f ) );
+  QCOMPARE( f.id(), fid );
+  QVERIFY( !it.nextFeature( f ) );
+}
+
+void TestQgsGeneralizedGeometryCache::testInvalidate()
+{
+  mLayer->setGeneralizedGeometryCacheEnabled( true );
+  QgsGeneralizedGeometryCache *cache = mLayer->generalizedGeometryCache();
+  cache->level( 100 );
+  cache->waitForFinished();
+  std::shared_ptr< const QgsGeneralizedGeometryCache::Level > level = cache->level( 100 );
+  QVERIFY( level );
+
+  QVERIFY( mLayer->startEditing() );
+  QgsFeature f( mLayer->fields() );
+  f.setAttributes( QgsAttributes() << QStringLiteral( "new" ) );
+  f.setGeometry( circle( 500, 1000, 500, 100 ) );
+  QVERIFY( mLayer->addFeature( f ) );
+  QVERIFY( mLayer->commitChanges() );
+
+  // levels are dropped after the edits, but existing snapshots stay valid
+  QVERIFY( !cache->level( 100 ) );
+  QCOMPARE( level->features.size(), 10 );
+  cache->waitForFinished();
+  level = cache->level( 100 );
+  QVERIFY( level );
+  QCOMPARE( level->features.size(), 11 );
+}
+
+void TestQgsGeneralizedGeometryCache::testInvalidateOnFieldsChange()
+{
+  mLayer->setGeneralizedGeometryCacheEnabled( true );
+  QgsGeneralizedGeometryCache *cache = mLayer->generalizedGeometryCache();
+  cache->level( 100 );
+  cache->waitForFinished();
+  std::shared_ptr< const QgsGeneralizedGeometryCache::Level > level = cache->level( 100 );
+  QVERIFY( level );
+  QCOMPARE( level->features.at( 0 ).fields().count(), 1 );
+
+  // cached features must have the new field
+  QgsField field( QStringLiteral( "upper_name" ), QVariant::String );
+  QVERIFY( mLayer->addExpressionField( QStringLiteral( "upper(name)" ), field ) >= 0 );
+  QVERIFY( !cache->level( 100 ) );
+  cache->waitForFinished();
+  level = cache->level( 100 );
+  QVERIFY( level );
+  QCOMPARE( level->features.at( 3 ).fields().count(), 2 );
+  QCOMPARE( level->features.at( 3 ).attribute( 1 ).toString(), QStringLiteral( "CIRCLE 3" ) );
+
+  // as well as a new data source
+  mLayer->setDataSource( QStringLiteral( "Polygon?crs=epsg:3857&field=name:string" ), QStringLiteral( "circles" ), QStringLiteral( "memory" ), QgsDataProvider::ProviderOptions() );
+  QVERIFY( !cache->level( 100 ) );
+}
+
+QGSTEST_MAIN( TestQgsGeneralizedGeometryCache )
+#include "testqgsgeneralizedgeometrycache.moc"
@@ -133,12 +133,14 @@ class TestQgsGeometry : public QObject
     void smoothCheck();
 
     void unaryUnion();
+    void repeatedPredicates();
 
     void dataStream();
 
     void exportToGeoJSON();
 
     void wkbInOut();
+    void lazyWkb();
 
     void directionNeutralSegmentation();
     void poleOfInaccessibility();
@@ -16502,6 +16504,58 @@ void TestQgsGeometry::smoothCheck()
   QVERIFY( QgsGeometry::compare( multipoly, expectedMultiPoly ) );
 }
 
+void TestQgsGeometry::repeatedPredicates()
+{
+  // a prepared geometry must give the same results, and be discarded when the geometry is modified
+  QgsGeometry polygon = QgsGeometry::fromWkt( QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0),(4 4, 6 4, 6 6, 4 6, 4 4))" ) );
+  QgsGeometry inside = QgsGeometry::fromWkt( QStringLiteral( "Point(1 1)" ) );
+  QgsGeometry inHole = QgsGeometry::fromWkt( QStringLiteral( "Point(5 5)" ) );
+  QgsGeometry outside = QgsGeometry::fromWkt( QStringLiteral( "Point(15 1)" ) );
+  QgsGeometry crossing = QgsGeometry::fromWkt( QStringLiteral( "LineString(-1 1, 1 1)" ) );
+
+  for ( int i = 0; i < 3; ++i )
+  {
+    // unprepared, then prepared
+    if ( i == 1 )
+      polygon.prepare();
+    QVERIFY( polygon.intersects( inside ) );
+    QVERIFY( polygon.contains( inside ) );
+    QVERIFY( !polygon.disjoint( inside ) );
+    QVERIFY( !polygon.intersects( inHole ) );
+    QVERIFY( !polygon.contains( inHole ) );
+    QVERIFY( !polygon.intersects( outside ) );
+    QVERIFY( polygon.disjoint( outside ) );
+    QVERIFY( polygon.touches( QgsGeometry::fromWkt( QStringLiteral( "Point(0 5)" ) ) ) );
+    QVERIFY( polygon.crosses( crossing ) == crossing.crosses( polygon ) );
+    QVERIFY( !polygon.within( inside ) );
+    QVERIFY( !polygon.overlaps( inside ) );
+    QgsPointXY pt( 1, 1 );
+    QVERIFY( polygon.contains( &pt ) );
+    QVERIFY( polygon.intersects( QgsRectangle( 9, 9, 11, 11 ) ) );
+  }
+
+  // shared copies must not be affected by the modification of one of them
+  QgsGeometry copy = polygon;
+  QVERIFY( copy.intersects( inside ) );
+  QCOMPARE( copy.translate( 100, 0 ), QgsGeometry::Success );
+  QVERIFY( !copy.intersects( inside ) );
+  QVERIFY( !copy.intersects( inside ) );
+  QVERIFY( polygon.intersects( inside ) );
+
+  QCOMPARE( polygon.translate( 10, 0 ), QgsGeometry::Success );
+  polygon.prepare();
+  QVERIFY( !polygon.intersects( inside ) );
+  QVERIFY( polygon.intersects( outside ) );
+  QVERIFY( !polygon.intersects( inside ) );
+  QVERIFY( polygon.contains( outside ) );
+
+  polygon.set( new QgsPoint( 1, 1 ) );
+  QVERIFY( polygon.intersects( inside ) );
+  polygon.prepare();
+  QVERIFY( !polygon.intersects( outside ) );
+  QVERIFY( polygon.intersects( inside ) );
+}
+
 void TestQgsGeometry::unaryUnion()
 {
   //test QgsGeometry::unaryUnion with null geometry
@@ -16696,6 +16750,93 @@ void TestQgsGeometry::wkbInOut()
   QCOMPARE( badHeader.wkbType(), QgsWkbTypes::Unknown );
 }
 
+void TestQgsGeometry::lazyWkb()
+{
+  QgsGeometry source = QgsGeometry::fromWkt( QStringLiteral( "MultiPolygonZ(((0 0 1, 10 0 2, 10 5 3, 0 0 1)),((20 -3 1, 21 -3 1, 21 2 1, 20 -3 1)))" ) );
+  QByteArray wkb = source.asWkb();
+
+  QgsGeometry lazy;
+  lazy.fromWkb( wkb );
+  QVERIFY( !lazy.isNull() );
+  QCOMPARE( lazy.wkbType(), QgsWkbTypes::MultiPolygonZ );
+  QCOMPARE( lazy.type(), QgsWkbTypes::PolygonGeometry );
+  QVERIFY( lazy.isMultipart() );
+  QCOMPARE( lazy.asWkb(), wkb );
+  QCOMPARE( lazy.boundingBox(), QgsRectangle( 0, -3, 21, 5 ) );
+  QCOMPARE( lazy.asWkt(), source.asWkt() );
+  QVERIFY( lazy.constGet()->equals( *source.constGet() ) );
+
+  // the WKB is shared until the geometry is parsed, and released afterwards
+  lazy.fromWkb( wkb );
+  QVERIFY( lazy.asWkb().constData() == wkb.constData() );
+  QVERIFY( lazy.constGet() );
+  QVERIFY( lazy.asWkb().constData() != wkb.constData() );
+  QCOMPARE( lazy.asWkb(), wkb );
+  QCOMPARE( lazy.boundingBox(), QgsRectangle( 0, -3, 21, 5 ) );
+  QCOMPARE( lazy.wkbType(), QgsWkbTypes::MultiPolygonZ );
+
+  // modifying the geometry must not return the original WKB anymore
+  QgsGeometry copy = lazy;
+  QCOMPARE( copy.translate( 1, 2 ), QgsGeometry::Success );
+  QCOMPARE( copy.boundingBox(), QgsRectangle( 1, -1, 22, 7 ) );
+  QVERIFY( copy.asWkb() != wkb );
+  QCOMPARE( lazy.asWkb(), wkb );
+  QCOMPARE( lazy.boundingBox(), QgsRectangle( 0, -3, 21, 5 ) );
+
+  lazy.fromWkb( wkb );
+  QCOMPARE( lazy.translate( 1, 2 ), QgsGeometry::Success );
+  QCOMPARE( lazy.boundingBox(), QgsRectangle( 1, -1, 22, 7 ) );
+  QCOMPARE( lazy.asWkt(), copy.asWkt() );
+
+  // empty geometries
+  lazy.fromWkb( QgsGeometry::fromWkt( QStringLiteral( "LineString EMPTY" ) ).asWkb() );
+  QVERIFY( lazy.isEmpty() );
+  QVERIFY( lazy.boundingBox().isNull() );
+  lazy.fromWkb( QgsGeometry::fromWkt( QStringLiteral( "Point EMPTY" ) ).asWkb() );
+  QVERIFY( lazy.isEmpty() );
+
+  // curved geometries are parsed immediately
+  source = QgsGeometry::fromWkt( QStringLiteral( "CircularString(0 0, 1 1, 2 0)" ) );
+  lazy.fromWkb( source.asWkb() );
+  QCOMPARE( lazy.wkbType(), QgsWkbTypes::CircularString );
+  QCOMPARE( lazy.boundingBox(), source.boundingBox() );
+  QCOMPARE( lazy.asWkb(), source.asWkb() );
+
+  // truncated WKB is rejected as before
+  wkb = QgsGeometry::fromWkt( QStringLiteral( "LineString(0 0, 1 1, 2 2)" ) ).asWkb();
+  wkb.chop( 8 );
+  lazy.fromWkb( wkb );
+  QVERIFY( lazy.isNull() );
+  QCOMPARE( lazy.wkbType(), QgsWkbTypes::Unknown );
+  QVERIFY( lazy.boundingBox().isNull() );
+
+  // trailing bytes are dropped, as by the full parser
+  const QByteArray lineWkb = QgsGeometry::fromWkt( QStringLiteral( "LineString(0 0, 1 1, 2 2)" ) ).asWkb();
+  lazy.fromWkb( lineWkb + QByteArray( 4, '\0' ) );
+  QVERIFY( !lazy.isNull() );
+  QCOMPARE( lazy.asWkb(), lineWkb );
+
+  // a multi geometry with a part of another type is handled by the full parser
+  QByteArray mixedWkb;
+  mixedWkb.append( static_cast< char >( QgsApplication::endian() ) );
+  const quint32 multiPointType = QgsWkbTypes::MultiPoint;
+  mixedWkb.append( reinterpret_cast< const char * >( &multiPointType ), sizeof( quint32 ) );
+  const quint32 partCount = 1;
+  mixedWkb.append( reinterpret_cast< const char * >( &partCount ), sizeof( quint32 ) );
+  mixedWkb.append( lineWkb );
+  QgsConstWkbPtr mixedPtr( mixedWkb );
+  std::unique_ptr< QgsAbstractGeometry > parsed( QgsGeometryFactory::geomFromWkb( mixedPtr ) );
+  lazy.fromWkb( mixedWkb );
+  const bool mixedIsNull = lazy.isNull();
+  const QByteArray mixedAsWkb = lazy.asWkb();
+  QCOMPARE( mixedIsNull, !parsed );
+  QCOMPARE( mixedAsWkb, parsed ? parsed->asWkb() : QByteArray() );
+  // results are the same after the geometry has been accessed
+  lazy.constGet();
+  QCOMPARE( lazy.isNull(), mixedIsNull );
+  QCOMPARE( lazy.asWkb(), mixedAsWkb );
+}
+
 void TestQgsGeometry::directionNeutralSegmentation()
 {
   //Tests, if segmentation of a circularstring is the same in both directions
@@ -15,15 +15,21 @@
 #include "qgstest.h"
 
 #include <QObject>
+#include <QDomDocument>
 
 #include "qgsapplication.h"
 #include "qgsmarkersymbollayer.h"
 #include "qgspathresolver.h"
 #include "qgsproject.h"
+#include "qgsrasterlayer.h"
 #include "qgssinglesymbolrenderer.h"
 #include "qgssettings.h"
 #include "qgsunittypes.h"
 #include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayerjoininfo.h"
+#include "qgsmaplayerstylemanager.h"
+#include "qgsmaplayerlegend.h"
 #include "qgssymbollayerutils.h"
 
 class TestQgsProject : public QObject
@@ -41,6 +47,10 @@ class TestQgsProject : public QObject
     void testProjectUnits();
     void variablesChanged();
     void testLayerFlags();
+    void testDeferredLayerLoading();
+    void testDeferredLayerLoadingJoinAndStyles();
+    void testDeferredLayerStartEditing();
+    void testPreloadedProviders();
 };
 
 void TestQgsProject::init()
@@ -386,6 +396,217 @@ void TestQgsProject::testLayerFlags()
   QVERIFY( !layer->flags().testFlag( QgsMapLayer::Removable ) );
 }
 
+void TestQgsProject::testDeferredLayerLoading()
+{
+  QString dataDir( TEST_DATA_DIR ); //defined in CmakeLists.txt
+  QString layerPath = dataDir + "/points.shp";
+  QgsVectorLayer *layer1 = new QgsVectorLayer( layerPath, QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer1->isValid() );
+  const QString layerId = layer1->id();
+  const QgsFields fields = layer1->fields();
+  const QgsRectangle extent = layer1->extent();
+  const long count = layer1->featureCount();
+
+  QgsProject prj;
+  prj.addMapLayer( layer1 );
+
+  QTemporaryFile f;
+  QVERIFY( f.open() );
+  f.close();
+  prj.setFileName( f.fileName() );
+  QVERIFY( prj.write() );
+
+  QgsProject prj2;
+  prj2.setDeferredLayerLoading( true );
+  prj2.setFileName( f.fileName() );
+  QVERIFY( prj2.read() );
+
+  // the layer is created without its data provider
+  QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( prj2.mapLayer( layerId ) );
+  QVERIFY( layer );
+  QVERIFY( layer->isValid() );
+  QVERIFY( layer->isLoadingDeferred() );
+  QCOMPARE( layer->name(), QStringLiteral( "points" ) );
+  QCOMPARE( layer->wkbType(), QgsWkbTypes::Point );
+  QCOMPARE( layer->extent(), extent );
+
+  // accessing the data completes the loading
+  QSignalSpy spy( layer, &QgsMapLayer::deferredLoadingCompleted );
+  QCOMPARE( layer->fields(), fields );
+  QVERIFY( !layer->isLoadingDeferred() );
+  QCOMPARE( spy.count(), 1 );
+  QVERIFY( layer->dataProvider() );
+  QVERIFY( layer->isValid() );
+  QCOMPARE( layer->featureCount(), count );
+  QVERIFY( layer->renderer() );
+}
+
+void TestQgsProject::testDeferredLayerLoadingJoinAndStyles()
+{
+  QString dataDir( TEST_DATA_DIR ); //defined in CmakeLists.txt
+  QgsVectorLayer *points = new QgsVectorLayer( dataDir + "/points.shp", QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QgsVectorLayer *joined = new QgsVectorLayer( dataDir + "/points.shp", QStringLiteral( "joined" ), QStringLiteral( "ogr" ) );
+  QVERIFY( points->isValid() );
+  QVERIFY( joined->isValid() );
+  const QString pointsId = points->id();
+  const QString joinedId = joined->id();
+
+  QgsProject prj;
+  prj.addMapLayers( QList< QgsMapLayer * >() << points << joined );
+
+  QgsVectorLayerJoinInfo join;
+  join.setJoinLayer( joined );
+  join.setJoinFieldName( QStringLiteral( "Class" ) );
+  join.setTargetFieldName( QStringLiteral( "Class" ) );
+  join.setJoinFieldNamesSubset( new QStringList( QStringList() << QStringLiteral( "Pilots" ) ) );
+  join.setPrefix( QStringLiteral( "j_" ) );
+  QVERIFY( points->addJoin( join ) );
+  const QgsFields fields = points->fields();
+  QVERIFY( fields.lookupField( QStringLiteral( "j_Pilots" ) ) >= 0 );
+
+  QVERIFY( points->styleManager()->addStyleFromLayer( QStringLiteral( "second style" ) ) );
+  const QStringList styles = points->styleManager()->styles();
+  QCOMPARE( styles.count(), 2 );
+  points->setCustomProperty( QStringLiteral( "my property" ), QStringLiteral( "my value" ) );
+
+  QTemporaryFile f;
+  QVERIFY( f.open() );
+  f.close();
+  prj.setFileName( f.fileName() );
+  QVERIFY( prj.write() );
+
+  // not read into QgsProject::instance(), which does not know the joined layer
+  QgsProject prj2;
+  prj2.setDeferredLayerLoading( true );
+  prj2.setFileName( f.fileName() );
+  QVERIFY( prj2.read() );
+
+  QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( prj2.mapLayer( pointsId ) );
+  QVERIFY( layer );
+  QVERIFY( layer->isLoadingDeferred() );
+
+  // styles, legend and custom properties are available without completing the loading
+  QCOMPARE( layer->styleManager()->styles(), styles );
+  QCOMPARE( layer->customProperty( QStringLiteral( "my property" ) ).toString(), QStringLiteral( "my value" ) );
+  QVERIFY( layer->legend() );
+  QVERIFY( layer->isLoadingDeferred() );
+
+  // the join is resolved against the project the layer belongs to
+  QCOMPARE( layer->fields(), fields );
+  QVERIFY( !layer->isLoadingDeferred() );
+  QCOMPARE( layer->vectorJoins().count(), 1 );
+  QCOMPARE( layer->vectorJoins().at( 0 ).joinLayer(), qobject_cast< QgsVectorLayer * >( prj2.mapLayer( joinedId ) ) );
+  QCOMPARE( layer->styleManager()->styles(), styles );
+  QCOMPARE( layer->customProperty( QStringLiteral( "my property" ) ).toString(), QStringLiteral( "my value" ) );
+}
+
+void TestQgsProject::testDeferredLayerStartEditing()
+{
+  QString dataDir( TEST_DATA_DIR ); //defined in CmakeLists.txt
+  QgsVectorLayer *layer1 = new QgsVectorLayer( dataDir + "/points.shp", QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer1->isValid() );
+  const QString layerId = layer1->id();
+  const QString storageType = layer1->storageType();
+  const QgsVectorDataProvider::Capabilities capabilities = layer1->dataProvider()->capabilities();
+
+  QgsProject prj;
+  prj.addMapLayer( layer1 );
+
+  QTemporaryFile f;
+  QVERIFY( f.open() );
+  f.close();
+  prj.setFileName( f.fileName() );
+  QVERIFY( prj.write() );
+
+  QgsProject prj2;
+  prj2.setDeferredLayerLoading( true );
+  prj2.setFileName( f.fileName() );
+  QVERIFY( prj2.read() );
+
+  QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( prj2.mapLayer( layerId ) );
+  QVERIFY( layer );
+  QVERIFY( layer->isLoadingDeferred() );
+
+  // methods which only go through the data provider complete the loading too
+  QVERIFY( layer->startEditing() );
+  QVERIFY( !layer->isLoadingDeferred() );
+  QVERIFY( layer->isEditable() );
+  QCOMPARE( layer->storageType(), storageType );
+  QCOMPARE( layer->dataProvider()->capabilities(), capabilities );
+  QVERIFY( layer->rollBack() );
+}
+
+void TestQgsProject::testPreloadedProviders()
+{
+  QString dataDir( TEST_DATA_DIR ); //defined in CmakeLists.txt
+  QgsVectorLayer *points = new QgsVectorLayer( dataDir + "/points.shp", QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QgsVectorLayer *lines = new QgsVectorLayer( dataDir + "/lines.shp", QStringLiteral( "lines" ), QStringLiteral( "ogr" ) );
+  QgsRasterLayer *raster = new QgsRasterLayer( dataDir + "/landsat.tif", QStringLiteral( "landsat" ), QStringLiteral( "gdal" ) );
+  QVERIFY( points->isValid() );
+  QVERIFY( lines->isValid() );
+  QVERIFY( raster->isValid() );
+  const long pointCount = points->featureCount();
+  const long lineCount = lines->featureCount();
+  const int bandCount = raster->bandCount();
+
+  QgsProject prj;
+  prj.addMapLayers( QList<QgsMapLayer *>() << points << lines << raster );
+
+  QTemporaryFile f;
+  QVERIFY( f.open() );
+  f.close();
+  prj.setFileName( f.fileName() );
+  QVERIFY( prj.write() );
+
+  // the providers of the layers are instantiated concurrently
+  QgsProject prj2;
+  prj2.setFileName( f.fileName() );
+  QVERIFY( prj2.read() );
+
+  QgsVectorLayer *points2 = qobject_cast< QgsVectorLayer * >( prj2.mapLayer( points->id() ) );
+  QgsVectorLayer *lines2 = qobject_cast< QgsVectorLayer * >( prj2.mapLayer( lines->id() ) );
+  QgsRasterLayer *raster2 = qobject_cast< QgsRasterLayer * >( prj2.mapLayer( raster->id() ) );
+  QVERIFY( points2 && points2->isValid() );
+  QVERIFY( lines2 && lines2->isValid() );
+  QVERIFY( raster2 && raster2->isValid() );
+  QCOMPARE( points2->dataProvider()->thread(), points2->thread() );
+  QCOMPARE( points2->featureCount(), pointCount );
+  QCOMPARE( lines2->featureCount(), lineCount );
+  QCOMPARE( raster2->bandCount(), bandCount );
+
+  // the same steps as reading the project: the layers must take the preloaded providers
+  QFile projectFile( f.fileName() );
+  QVERIFY( projectFile.open( QIODevice::ReadOnly ) );
+  QDomDocument doc;
+  QVERIFY( doc.setContent( &projectFile ) );
+
+  QgsProject prj3;
+  prj3.setFileName( f.fileName() );
+  QVector<QDomNode> layerNodes;
+  QVector<QgsMapLayer *> layers;
+  const QDomElement projectLayers = doc.documentElement().firstChildElement( QStringLiteral( "projectlayers" ) );
+  for ( QDomElement element = projectLayers.firstChildElement( QStringLiteral( "maplayer" ) ); !element.isNull(); element = element.nextSiblingElement( QStringLiteral( "maplayer" ) ) )
+  {
+    layerNodes << element;
+    layers << prj3.createLayer( element );
+  }
+  QCOMPARE( layers.size(), 3 );
+  prj3.preloadDataProviders( layerNodes, layers );
+
+  QgsReadWriteContext context;
+  context.setPathResolver( prj3.pathResolver() );
+  for ( int i = 0; i < layers.size(); ++i )
+  {
+    QgsMapLayer *layer = layers.at( i );
+    QgsDataProvider *preloaded = layer->mPreloadedProvider.get();
+    QVERIFY( preloaded );
+    QList<QDomNode> brokenNodes;
+    QVERIFY( prj3.addLayer( layer, layerNodes.at( i ).toElement(), brokenNodes, context ) );
+    QCOMPARE( layer->dataProvider(), preloaded );
+    QVERIFY( !layer->mPreloadedProvider );
+  }
+}
+
 
 QGSTEST_MAIN( TestQgsProject )
 #include "testqgsproject.moc"
@@ -31,6 +31,10 @@
 #include <qgssinglesymbolrenderer.h>
 #include "qgsmarkersymbollayer.h"
 #include "qgsproperty.h"
+#include "qgsmaprenderersequentialjob.h"
+#include "qgsexpressioncontext.h"
+#include "qgsvectordataprovider.h"
+#include <QPainter>
 
 //qgis test includes
 #include "qgsrenderchecker.h"
@@ -61,11 +65,22 @@ class TestQgsSimpleMarkerSymbol : public QObject
     void boundsWithRotation();
     void boundsWithRotationAndOffset();
     void colors();
+    void spritesDataDefined();
+    void spritesShared();
+    void spritesSelection();
+    void spritesOverflow();
 
   private:
     bool mTestHasError =  false ;
 
     bool imageCheck( const QString &type );
+
+    //! Returns a layer with \a count points at pixel centers of a 400x400 pixels map, with a "value" field
+    static QgsVectorLayer *createSpriteLayer( int count );
+    //! Renders \a layer with sprites and as vectors, and checks that both images match up to antialiasing
+    bool spriteCheck( const QString &testType, QgsVectorLayer *layer, int allowedMismatch = 20 );
+    //! Draws the features of \a layer with \a symbol and returns the number of sprites used
+    static int spriteCount( QgsVectorLayer *layer, QgsMarkerSymbol *symbol );
     QgsMapSettings mMapSettings;
     QgsVectorLayer *mpPointsLayer = nullptr;
     QgsSimpleMarkerSymbolLayer *mSimpleMarkerLayer = nullptr;
@@ -267,6 +282,84 @@ void TestQgsSimpleMarkerSymbol::colors()
   QCOMPARE( marker.strokeColor(), QColor( 250, 250, 250 ) );
 }
 
+void TestQgsSimpleMarkerSymbol::spritesDataDefined()
+{
+  std::unique_ptr< QgsVectorLayer > layer( createSpriteLayer( 200 ) );
+
+  QgsSimpleMarkerSymbolLayer *marker = new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Square, 6 );
+  marker->setSizeUnit( QgsUnitTypes::RenderPixels );
+  marker->setStrokeColor( QColor( 0, 0, 0 ) );
+  marker->setStrokeWidth( 1 );
+  marker->setStrokeWidthUnit( QgsUnitTypes::RenderPixels );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertySize, QgsProperty::fromExpression( QStringLiteral( "4 + \"value\" % 5" ) ) );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertyFillColor, QgsProperty::fromExpression( QStringLiteral( "color_rgb( \"value\" * 10 % 256, 100, 50 )" ) ) );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertyAngle, QgsProperty::fromExpression( QStringLiteral( "\"value\" * 15 % 360" ) ) );
+  QgsMarkerSymbol *symbol = new QgsMarkerSymbol( QgsSymbolLayerList() << marker );
+  layer->setRenderer( new QgsSingleSymbolRenderer( symbol ) );
+
+  // one sprite per distinct combination of size, color and angle
+  QCOMPARE( spriteCount( layer.get(), symbol ), 200 );
+  QVERIFY( spriteCheck( QStringLiteral( "simplemarker_sprites_datadefined" ), layer.get() ) );
+}
+
+void TestQgsSimpleMarkerSymbol::spritesShared()
+{
+  std::unique_ptr< QgsVectorLayer > layer( createSpriteLayer( 200 ) );
+
+  // sizes and angles differing by less than 1/8 pixel and 1/4 degree share a sprite
+  QgsSimpleMarkerSymbolLayer *marker = new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Triangle, 6 );
+  marker->setSizeUnit( QgsUnitTypes::RenderPixels );
+  marker->setColor( QColor( 200, 100, 50 ) );
+  marker->setStrokeColor( QColor( 0, 0, 0 ) );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertySize, QgsProperty::fromExpression( QStringLiteral( "7 + ( \"value\" % 3 ) / 100.0" ) ) );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertyAngle, QgsProperty::fromExpression( QStringLiteral( "30 + ( \"value\" % 4 ) / 40.0" ) ) );
+  QgsMarkerSymbol *symbol = new QgsMarkerSymbol( QgsSymbolLayerList() << marker );
+  layer->setRenderer( new QgsSingleSymbolRenderer( symbol ) );
+
+  QCOMPARE( spriteCount( layer.get(), symbol ), 1 );
+  QVERIFY( spriteCheck( QStringLiteral( "simplemarker_sprites_shared" ), layer.get() ) );
+}
+
+void TestQgsSimpleMarkerSymbol::spritesSelection()
+{
+  std::unique_ptr< QgsVectorLayer > layer( createSpriteLayer( 200 ) );
+
+  QgsSimpleMarkerSymbolLayer *marker = new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Circle, 6 );
+  marker->setSizeUnit( QgsUnitTypes::RenderPixels );
+  marker->setStrokeColor( QColor( 0, 0, 0 ) );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertyFillColor, QgsProperty::fromExpression( QStringLiteral( "color_rgb( 0, \"value\" % 2 * 200, 200 )" ) ) );
+  QgsMarkerSymbol *symbol = new QgsMarkerSymbol( QgsSymbolLayerList() << marker );
+  layer->setRenderer( new QgsSingleSymbolRenderer( symbol ) );
+
+  // selected markers are drawn with the selection color, not from the sprites
+  QgsFeatureIds selected;
+  QgsFeature f;
+  QgsFeatureIterator it = layer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    if ( f.attribute( 0 ).toInt() % 3 == 0 )
+      selected << f.id();
+  }
+  layer->selectByIds( selected );
+  QVERIFY( spriteCheck( QStringLiteral( "simplemarker_sprites_selection" ), layer.get() ) );
+}
+
+void TestQgsSimpleMarkerSymbol::spritesOverflow()
+{
+  std::unique_ptr< QgsVectorLayer > layer( createSpriteLayer( 1100 ) );
+
+  // every marker has its own color, exceeding the number of sprites kept
+  QgsSimpleMarkerSymbolLayer *marker = new QgsSimpleMarkerSymbolLayer( QgsSimpleMarkerSymbolLayerBase::Diamond, 6 );
+  marker->setSizeUnit( QgsUnitTypes::RenderPixels );
+  marker->setStrokeColor( QColor( 0, 0, 0 ) );
+  marker->setDataDefinedProperty( QgsSymbolLayer::PropertyFillColor, QgsProperty::fromExpression( QStringLiteral( "color_rgb( \"value\" % 256, \"value\" // 256 * 50, 100 )" ) ) );
+  QgsMarkerSymbol *symbol = new QgsMarkerSymbol( QgsSymbolLayerList() << marker );
+  layer->setRenderer( new QgsSingleSymbolRenderer( symbol ) );
+
+  QCOMPARE( spriteCount( layer.get(), symbol ), static_cast< int >( QgsSimpleMarkerSymbolLayer::MAXIMUM_SPRITE_COUNT ) );
+  QVERIFY( spriteCheck( QStringLiteral( "simplemarker_sprites_overflow" ), layer.get() ) );
+}
+
 //
 // Private helper functions not called directly by CTest
 //
@@ -287,5 +380,90 @@ bool TestQgsSimpleMarkerSymbol::imageCheck( const QString &testType )
   return myResultFlag;
 }
 
+QgsVectorLayer *TestQgsSimpleMarkerSymbol::createSpriteLayer( int count )
+{
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=value:integer" ), QStringLiteral( "sprites" ), QStringLiteral( "memory" ) );
+
+  // map units are pixels, markers are centered on pixel centers
+  QgsFeatureList features;
+  for ( int i = 0; i < count; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 5.5 + 10 * ( i % 40 ), 394.5 - 10 * ( i / 40 ) ) ) );
+    features << f;
+  }
+  layer->dataProvider()->addFeatures( features );
+  return layer;
+}
+
+bool TestQgsSimpleMarkerSymbol::spriteCheck( const QString &testType, QgsVectorLayer *layer, int allowedMismatch )
+{
+  QgsMapSettings ms;
+  ms.setLayers( QList<QgsMapLayer *>() << layer );
+  ms.setExtent( QgsRectangle( 0, 0, 400, 400 ) );
+  ms.setOutputSize( QSize( 400, 400 ) );
+  ms.setOutputDpi( 96 );
+  ms.setBackgroundColor( QColor( 255, 255, 255 ) );
+  ms.setFlag( QgsMapSettings::Antialiasing, true );
+
+  QgsMapRendererSequentialJob spriteJob( ms );
+  spriteJob.start();
+  spriteJob.waitForFinished();
+  const QImage sprites = spriteJob.renderedImage();
+
+  // vector output draws every marker without sprites
+  ms.setFlag( QgsMapSettings::ForceVectorOutput, true );
+  QgsMapRendererSequentialJob vectorJob( ms );
+  vectorJob.start();
+  vectorJob.waitForFinished();
+  const QImage vectors = vectorJob.renderedImage();
+
+  int mismatchCount = 0;
+  for ( int y = 0; y < sprites.height(); ++y )
+  {
+    for ( int x = 0; x < sprites.width(); ++x )
+    {
+      const QRgb spritePixel = sprites.pixel( x, y );
+      const QRgb vectorPixel = vectors.pixel( x, y );
+      if ( std::abs( qRed( spritePixel ) - qRed( vectorPixel ) ) > 16 || std::abs( qGreen( spritePixel ) - qGreen( vectorPixel ) ) > 16
+           || std::abs( qBlue( spritePixel ) - qBlue( vectorPixel ) ) > 16 || std::abs( qAlpha( spritePixel ) - qAlpha( vectorPixel ) ) > 16 )
+        mismatchCount++;
+    }
+  }
+
+  mReport += QStringLiteral( "<h2>%1</h2>\n<p>%2 pixels differ between the sprite and vector renderings</p>\n" ).arg( testType ).arg( mismatchCount );
+  if ( mismatchCount > allowedMismatch )
+  {
+    sprites.save( QDir::tempPath() + '/' + testType + "_sprites.png" );
+    vectors.save( QDir::tempPath() + '/' + testType + "_vectors.png" );
+  }
+  return mismatchCount <= allowedMismatch;
+}
+
+int TestQgsSimpleMarkerSymbol::spriteCount( QgsVectorLayer *layer, QgsMarkerSymbol *symbol )
+{
+  QImage image( 400, 400, QImage::Format_ARGB32_Premultiplied );
+  image.fill( 0 );
+  QPainter painter( &image );
+  painter.setRenderHint( QPainter::Antialiasing );
+  QgsRenderContext context = QgsRenderContext::fromQPainter( &painter );
+  context.setExpressionContext( QgsExpressionContext( QgsExpressionContextUtils::globalProjectLayerScopes( layer ) ) );
+
+  symbol->startRender( context, layer->fields() );
+  QgsFeature f;
+  QgsFeatureIterator it = layer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    context.expressionContext().setFeature( f );
+    const QgsPointXY point = f.geometry().asPoint();
+    symbol->renderPoint( QPointF( point.x(), 400 - point.y() ), &f, context );
+  }
+  const int count = static_cast< QgsSimpleMarkerSymbolLayer * >( symbol->symbolLayer( 0 ) )->mSprites.size();
+  symbol->stopRender( context );
+  painter.end();
+  return count;
+}
+
 QGSTEST_MAIN( TestQgsSimpleMarkerSymbol )
 #include "testqgssimplemarker.moc"
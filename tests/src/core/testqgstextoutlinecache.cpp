@@ -0,0 +1,127 @@
+/***************************************************************************
+     testqgstextoutlinecache.cpp
+     ---------------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsfontutils.h"
+#include "qgstextoutlinecache.h"
+
+#include <QtConcurrentMap>
+
+class TestQgsTextOutlineCache : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void textPath();
+    void fontProperties();
+    void concurrentUse();
+};
+
+void TestQgsTextOutlineCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsTextOutlineCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsTextOutlineCache::init()
+{
+  QgsTextOutlineCache::clear();
+}
+
+void TestQgsTextOutlineCache::textPath()
+{
+  QFont font = QgsFontUtils::getStandardTestFont( QStringLiteral( "Bold" ), 20 );
+
+  QPainterPath expected;
+  expected.setFillRule( Qt::WindingFill );
+  expected.addText( 0, 0, font, QStringLiteral( "Label" ) );
+
+  QCOMPARE( QgsTextOutlineCache::count(), 0 );
+  QPainterPath path = QgsTextOutlineCache::textPath( font, QStringLiteral( "Label" ) );
+  QCOMPARE( path, expected );
+  QCOMPARE( QgsTextOutlineCache::count(), 1 );
+
+  // second request is served from the cache
+  path = QgsTextOutlineCache::textPath( font, QStringLiteral( "Label" ) );
+  QCOMPARE( path, expected );
+  QCOMPARE( QgsTextOutlineCache::count(), 1 );
+
+  path = QgsTextOutlineCache::textPath( font, QStringLiteral( "Other label" ) );
+  QVERIFY( path != expected );
+  QCOMPARE( QgsTextOutlineCache::count(), 2 );
+
+  QgsTextOutlineCache::clear();
+  QCOMPARE( QgsTextOutlineCache::count(), 0 );
+}
+
+void TestQgsTextOutlineCache::fontProperties()
+{
+  QFont font = QgsFontUtils::getStandardTestFont( QStringLiteral( "Bold" ), 20 );
+  QPainterPath path = QgsTextOutlineCache::textPath( font, QStringLiteral( "Label" ) );
+
+  // properties which are not part of QFont::key() must not share outlines
+  QFont spaced = font;
+  spaced.setLetterSpacing( QFont::AbsoluteSpacing, 5 );
+  QPainterPath expected;
+  expected.setFillRule( Qt::WindingFill );
+  expected.addText( 0, 0, spaced, QStringLiteral( "Label" ) );
+  QPainterPath spacedPath = QgsTextOutlineCache::textPath( spaced, QStringLiteral( "Label" ) );
+  QCOMPARE( spacedPath, expected );
+  QVERIFY( spacedPath != path );
+
+  QFont capitalized = font;
+  capitalized.setCapitalization( QFont::AllUppercase );
+  expected = QPainterPath();
+  expected.setFillRule( Qt::WindingFill );
+  expected.addText( 0, 0, capitalized, QStringLiteral( "Label" ) );
+  QCOMPARE( QgsTextOutlineCache::textPath( capitalized, QStringLiteral( "Label" ) ), expected );
+
+  QCOMPARE( QgsTextOutlineCache::count(), 3 );
+}
+
+void TestQgsTextOutlineCache::concurrentUse()
+{
+  QFont font = QgsFontUtils::getStandardTestFont( QStringLiteral( "Bold" ), 20 );
+  QPainterPath expected;
+  expected.setFillRule( Qt::WindingFill );
+  expected.addText( 0, 0, font, QStringLiteral( "Label" ) );
+
+  // outlines of the same text are used by several threads, each computing its lazy bounds
+  QVector< QRectF > bounds( 100 );
+  QtConcurrent::blockingMap( bounds, [&font]( QRectF & rect )
+  {
+    const QPainterPath path = QgsTextOutlineCache::textPath( font, QStringLiteral( "Label" ) );
+    rect = path.boundingRect().united( path.controlPointRect() );
+  } );
+
+  const QRectF expectedBounds = expected.boundingRect().united( expected.controlPointRect() );
+  for ( const QRectF &rect : qgis::as_const( bounds ) )
+    QCOMPARE( rect, expectedBounds );
+  QCOMPARE( QgsTextOutlineCache::count(), 1 );
+}
+
+QGSTEST_MAIN( TestQgsTextOutlineCache )
+#include "testqgstextoutlinecache.moc"
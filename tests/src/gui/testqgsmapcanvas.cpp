@@ -57,6 +57,7 @@ class TestQgsMapCanvas : public QObject
     void testScaleLockCanvasResize();
     void testZoomByWheel();
     void testShiftZoom();
+    void testMapUpdateOnLayerRepaint();
 
   private:
     QgsMapCanvas *mCanvas = nullptr;
@@ -424,5 +425,55 @@ void TestQgsMapCanvas::testShiftZoom()
   QGSCOMPARENEAR( mCanvas->extent().height(), originalHeight, 0.00001 );
 }
 
+void TestQgsMapCanvas::testMapUpdateOnLayerRepaint()
+{
+  QgsMapCanvas canvas;
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=EPSG:3857" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeature f;
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 5, 5 ) ) );
+  layer->dataProvider()->addFeatures( QgsFeatureList() << f );
+  QgsProject::instance()->addMapLayer( layer );
+
+  canvas.setDestinationCrs( layer->crs() );
+  canvas.setLayers( QList<QgsMapLayer *>() << layer );
+  canvas.setExtent( QgsRectangle( 0, 0, 10, 10 ) );
+  canvas.refresh();
+  canvas.waitWhileRendering();
+
+  // a layer repaint of the same view keeps showing the last complete map while rendering
+  layer->triggerRepaint();
+  QVERIFY( canvas.mRefreshScheduled );
+  canvas.mRefreshTimer->stop();
+  canvas.refreshMap();
+  QVERIFY( !canvas.mMapUpdateTimer.isActive() );
+  canvas.waitWhileRendering();
+
+  // other refresh requests show progressive updates
+  layer->triggerRepaint();
+  canvas.refresh();
+  canvas.mRefreshTimer->stop();
+  canvas.refreshMap();
+  QVERIFY( canvas.mMapUpdateTimer.isActive() );
+  canvas.waitWhileRendering();
+
+  canvas.refresh();
+  layer->triggerRepaint();
+  canvas.mRefreshTimer->stop();
+  canvas.refreshMap();
+  QVERIFY( canvas.mMapUpdateTimer.isActive() );
+  canvas.waitWhileRendering();
+
+  // and so do repaints of a changed view
+  canvas.setExtent( QgsRectangle( 0, 0, 20, 20 ) );
+  layer->triggerRepaint();
+  canvas.mRefreshTimer->stop();
+  canvas.refreshMap();
+  QVERIFY( canvas.mMapUpdateTimer.isActive() );
+  canvas.waitWhileRendering();
+
+  canvas.setLayers( QList<QgsMapLayer *>() );
+  QgsProject::instance()->removeMapLayer( layer );
+}
+
 QGSTEST_MAIN( TestQgsMapCanvas )
 #include "testqgsmapcanvas.moc"
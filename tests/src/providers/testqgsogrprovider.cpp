@@ -24,8 +24,12 @@
 #include <qgsproviderregistry.h>
 #include <qgsvectorlayer.h>
 #include <qgsnetworkaccessmanager.h>
+#include <qgsvectordataprovider.h>
+#include <qgsfeaturebatch.h>
 
 #include <QObject>
+#include <QFileInfo>
+#include <QTemporaryDir>
 
 #include <cpl_conv.h>
 
@@ -46,9 +50,12 @@ class TestQgsOgrProvider : public QObject
 
     void setupProxy();
     void decodeUri();
+    void nextBatch_data();
+    void nextBatch();
 
   private:
     QString mTestDataDir;
+    QTemporaryDir mTempDir;
     QString mReport;
   signals:
 
@@ -66,6 +73,20 @@ void TestQgsOgrProvider::initTestCase()
 
   mTestDataDir = QStringLiteral( TEST_DATA_DIR ) + '/'; //defined in CmakeLists.txt
   mReport = QStringLiteral( "<h1>OGR Provider Tests</h1>\n" );
+
+  // 3D GeoJSON geometries are read as 2.5D geometries by OGR
+  QVERIFY( mTempDir.isValid() );
+  QFile file( mTempDir.filePath( QStringLiteral( "polys25d.geojson" ) ) );
+  QVERIFY( file.open( QIODevice::WriteOnly ) );
+  file.write( "{ \"type\": \"FeatureCollection\", \"features\": [\n" );
+  for ( int i = 0; i < 20; ++i )
+  {
+    file.write( QStringLiteral( "%1{ \"type\": \"Feature\", \"properties\": { \"name\": \"poly%2\" }, "
+                                "\"geometry\": { \"type\": \"Polygon\", \"coordinates\": [ [ [ %2, 0, %3 ], [ %4, 0, %3 ], [ %4, 1, %3 ], [ %2, 0, %3 ] ] ] } }\n" )
+                .arg( i == 0 ? QString() : QStringLiteral( "," ) ).arg( i ).arg( i * 10 ).arg( i + 1 ).toUtf8() );
+  }
+  file.write( "] }\n" );
+  file.close();
 }
 
 //runs after all tests
@@ -130,6 +151,79 @@ void TestQgsOgrProvider::decodeUri()
   QCOMPARE( parts.value( QStringLiteral( "layerName" ) ).toString(), QString( "a_layer" ) );
 }
 
+void TestQgsOgrProvider::nextBatch_data()
+{
+  QTest::addColumn<QString>( "fileName" );
+  QTest::addColumn<bool>( "subsetOfAttributes" );
+  QTest::addColumn<bool>( "filterRect" );
+  QTest::addColumn<int>( "limit" );
+
+  QTest::newRow( "points" ) << QStringLiteral( "points.shp" ) << false << false << -1;
+  QTest::newRow( "polys" ) << QStringLiteral( "polys.shp" ) << false << false << -1;
+  QTest::newRow( "polys 2.5D" ) << mTempDir.filePath( QStringLiteral( "polys25d.geojson" ) ) << false << false << -1;
+  QTest::newRow( "points subset" ) << QStringLiteral( "points.shp" ) << true << false << -1;
+  QTest::newRow( "points rect" ) << QStringLiteral( "points.shp" ) << false << true << -1;
+  QTest::newRow( "points limit" ) << QStringLiteral( "points.shp" ) << false << false << 11;
+}
+
+void TestQgsOgrProvider::nextBatch()
+{
+  QFETCH( QString, fileName );
+  QFETCH( bool, subsetOfAttributes );
+  QFETCH( bool, filterRect );
+  QFETCH( int, limit );
+
+  QgsVectorLayer vl( QFileInfo( fileName ).isAbsolute() ? fileName : mTestDataDir + '/' + fileName, QStringLiteral( "test" ), QStringLiteral( "ogr" ) );
+  QVERIFY( vl.isValid() );
+  QgsVectorDataProvider *provider = vl.dataProvider();
+
+  QgsFeatureRequest request;
+  if ( subsetOfAttributes )
+    request.setSubsetOfAttributes( QgsAttributeList() << 0 );
+  if ( filterRect )
+  {
+    QgsRectangle extent = provider->extent();
+    extent.scale( 0.5 );
+    request.setFilterRect( extent );
+  }
+  request.setLimit( limit );
+
+  // features returned by batches must match the ones returned one by one
+  QgsFeatureList expected;
+  QgsFeatureIterator it = provider->getFeatures( request );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+    expected << f;
+  QVERIFY( !expected.isEmpty() );
+
+  QgsFeatureBatch batch( provider->fields() );
+  QgsFeatureList actual;
+  it = provider->getFeatures( request );
+  while ( it.nextBatch( batch, 7 ) )
+  {
+    QVERIFY( batch.size() <= 7 );
+    for ( int i = 0; i < batch.size(); ++i )
+      actual << batch.feature( i );
+  }
+
+  QCOMPARE( actual.count(), expected.count() );
+  for ( int i = 0; i < expected.count(); ++i )
+  {
+    QCOMPARE( actual.at( i ).id(), expected.at( i ).id() );
+    QCOMPARE( actual.at( i ).geometry().wkbType(), expected.at( i ).geometry().wkbType() );
+    QCOMPARE( actual.at( i ).geometry().asWkt(), expected.at( i ).geometry().asWkt() );
+    for ( int idx = 0; idx < provider->fields().count(); ++idx )
+    {
+      if ( subsetOfAttributes && idx != 0 )
+        continue;
+      const QVariant expectedValue = expected.at( i ).attribute( idx );
+      const QVariant actualValue = actual.at( i ).attribute( idx );
+      QCOMPARE( actualValue.isNull(), expectedValue.isNull() );
+      if ( !expectedValue.isNull() )
+        QCOMPARE( actualValue.toString(), expectedValue.toString() );
+    }
+  }
+}
 
 QGSTEST_MAIN( TestQgsOgrProvider )
 #include "testqgsogrprovider.moc"
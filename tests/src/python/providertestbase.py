@@ -920,7 +920,7 @@ class ProviderTestCase(FeatureSourceTestCase):
         """
         # Acquire the maximum amount of concurrent connections
         iterators = list()
-        for i in range(QgsApplication.instance().maxConcurrentConnectionsPerPool()):
+        for i in range(QgsApplication.maxConcurrentConnectionsPerPool()):
             iterators.append(self.vl.getFeatures())
 
         # Run an expression that will also do a request and should use a spare
@@ -123,6 +123,31 @@ class PyQgsOGRProvider(unittest.TestCase):
         self.assertEqual(len(vl.dataProvider().subLayers()), 1)
         self.assertEqual(vl.dataProvider().subLayers()[0], QgsDataProvider.SUBLAYER_SEPARATOR.join(['0', 'testMixOfPolygonCurvePolygon', '4', 'CurvePolygon', '']))
 
+    def testExactIntersectFilter(self):
+
+        datasource = os.path.join(self.basetestpath, 'testExactIntersectFilter.csv')
+        with open(datasource, 'wt') as f:
+            f.write('id,WKT\n')
+            # bounding box intersects the filter rectangle, but not the polygon
+            f.write('1,"POLYGON((0 0,10 0,10 1,1 1,1 10,0 10,0 0))"\n')
+            f.write('2,"POLYGON((4 4,6 4,6 6,4 6,4 4))"\n')
+            f.write('3,"POLYGON((6 6,9 6,9 9,6 9,6 6))"\n')
+            f.write('4,"POLYGON((20 20,21 20,21 21,20 21,20 20))"\n')
+
+        vl = QgsVectorLayer('{}|layerid=0'.format(datasource), 'test', 'ogr')
+        self.assertTrue(vl.isValid())
+
+        rect = QgsRectangle(3, 3, 7, 7)
+        request = QgsFeatureRequest().setFilterRect(rect)
+        # OGR may already drop feature 1 when GDAL is built with GEOS
+        self.assertIn(sorted([f['id'] for f in vl.getFeatures(request)]), (['1', '2', '3'], ['2', '3']))
+
+        # every feature is tested against the same prepared rectangle
+        request.setFlags(QgsFeatureRequest.ExactIntersect)
+        self.assertEqual(sorted([f['id'] for f in vl.getFeatures(request)]), ['2', '3'])
+        request.setFlags(QgsFeatureRequest.ExactIntersect | QgsFeatureRequest.NoGeometry)
+        self.assertEqual(sorted([f['id'] for f in vl.getFeatures(request)]), ['2', '3'])
+
     def testMixOfLineStringCompoundCurve(self):
 
         datasource = os.path.join(self.basetestpath, 'testMixOfLineStringCompoundCurve.csv')
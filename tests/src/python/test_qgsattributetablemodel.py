@@ -12,11 +12,13 @@ __copyright__ = 'Copyright 2015, The QGIS Project'
 # This will get replaced with a git SHA1 when you do a git archive
 __revision__ = '$Format:%H$'
 
+from qgis.PyQt.QtCore import Qt, QCoreApplication, QTimer
 from qgis.gui import (
     QgsAttributeTableModel,
     QgsGui
 )
 from qgis.core import (
+    QgsEditorWidgetSetup,
     QgsFeature,
     QgsGeometry,
     QgsPointXY,
@@ -120,6 +122,63 @@ class TestQgsAttributeTableModel(unittest.TestCase):
         # check that index from layer and model are sync
         self.assertEqual(feature.attribute(field_idx), feature_model.attribute(field_idx))
 
+    def testLoadInBatches(self):
+        am = QgsAttributeTableModel(self.cache)
+        am.setLoadingBatchSize(4)
+        self.assertEqual(am.loadingBatchSize(), 4)
+        am.loadLayer()
+        self.assertEqual(am.rowCount(), 4)
+        self.assertTrue(am.canFetchMore())
+
+        # each batch is inserted at once
+        inserted = []
+        am.rowsInserted.connect(lambda parent, first, last: inserted.append((first, last)))
+        am.fetchMore()
+        self.assertEqual(am.rowCount(), 8)
+        self.assertEqual(inserted, [(4, 7)])
+        am.fetchMore()
+        self.assertEqual(am.rowCount(), 10)
+        self.assertEqual(inserted, [(4, 7), (8, 9)])
+        self.assertFalse(am.canFetchMore())
+
+        # the first batch follows the loading order
+        am.setLoadingOrder('"fldint"', Qt.DescendingOrder)
+        self.assertEqual(am.rowCount(), 4)
+        self.assertEqual([am.feature(am.index(row, 0)).attribute(1) for row in range(4)], [9, 8, 7, 6])
+
+    def testResumeLoadingWhenIdle(self):
+        am = QgsAttributeTableModel(self.cache)
+        am.setLoadingBatchSize(4)
+        am.setLoadingOrder('"fldint"', Qt.DescendingOrder)
+        am.loadLayer()
+        self.assertEqual(am.rowCount(), 4)
+
+        # the feature iterator is closed when idle, and reopened after the features already read
+        timer = am.findChild(QTimer)
+        timer.setInterval(0)
+        am.fetchMore()
+        self.assertEqual(am.rowCount(), 8)
+        QCoreApplication.processEvents()
+        self.assertTrue(am.canFetchMore())
+        am.fetchMore()
+        self.assertEqual(am.rowCount(), 10)
+        self.assertFalse(am.canFetchMore())
+        self.assertEqual([am.feature(am.index(row, 0)).attribute(1) for row in range(10)], [9, 8, 7, 6, 5, 4, 3, 2, 1, 0])
+
+    def testCanLoadInSortOrder(self):
+        am = QgsAttributeTableModel(self.cache)
+        am.loadLayer()
+        am.prefetchSortData('"fldint"')
+        self.assertTrue(am.canLoadInSortOrder())
+
+        # value maps are sorted on their represented values, which the provider does not know
+        self.layer.setEditorWidgetSetup(1, QgsEditorWidgetSetup('ValueMap', {'map': {'nine': 9, 'zero': 0}}))
+        am.loadLayer()
+        am.prefetchSortData('"fldint"')
+        self.assertFalse(am.canLoadInSortOrder())
+        am.prefetchSortData('"fldint" * 2')
+        self.assertTrue(am.canLoadInSortOrder())
+
 
 if __name__ == '__main__':
     unittest.main()
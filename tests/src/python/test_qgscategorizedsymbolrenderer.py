@@ -235,6 +235,56 @@ class TestQgsCategorizedSymbolRenderer(unittest.TestCase):
 
         renderer.stopRender(context)
 
+    def testSymbolForNumericValue(self):
+        """Test symbolForValue with numeric values, which are matched with the string representation of categories"""
+        renderer = QgsCategorizedSymbolRenderer()
+        renderer.setClassAttribute('field')
+
+        symbol_1 = createMarkerSymbol()
+        symbol_1.setColor(QColor(255, 0, 0))
+        renderer.addCategory(QgsRendererCategory('1', symbol_1, '1'))
+        symbol_15 = createMarkerSymbol()
+        symbol_15.setColor(QColor(0, 255, 0))
+        renderer.addCategory(QgsRendererCategory(1.5, symbol_15, '1.5'))
+        symbol_0 = createMarkerSymbol()
+        symbol_0.setColor(QColor(0, 0, 255))
+        renderer.addCategory(QgsRendererCategory(0, symbol_0, '0'))
+        symbol_01 = createMarkerSymbol()
+        symbol_01.setColor(QColor(255, 255, 0))
+        renderer.addCategory(QgsRendererCategory('01', symbol_01, '01'))
+
+        context = QgsRenderContext()
+        renderer.startRender(context, QgsFields())
+
+        symbol, ok = renderer.symbolForValue2(1)
+        self.assertTrue(ok)
+        self.assertEqual(symbol.color(), QColor(255, 0, 0))
+        symbol, ok = renderer.symbolForValue2(1.0)
+        self.assertTrue(ok)
+        self.assertEqual(symbol.color(), QColor(255, 0, 0))
+        symbol, ok = renderer.symbolForValue2(1.5)
+        self.assertTrue(ok)
+        self.assertEqual(symbol.color(), QColor(0, 255, 0))
+        symbol, ok = renderer.symbolForValue2(0)
+        self.assertTrue(ok)
+        self.assertEqual(symbol.color(), QColor(0, 0, 255))
+        symbol, ok = renderer.symbolForValue2(0.0)
+        self.assertTrue(ok)
+        self.assertEqual(symbol.color(), QColor(0, 0, 255))
+        symbol, ok = renderer.symbolForValue2('01')
+        self.assertTrue(ok)
+        self.assertEqual(symbol.color(), QColor(255, 255, 0))
+
+        # no matching category
+        symbol, ok = renderer.symbolForValue2(2)
+        self.assertIsNone(symbol)
+        self.assertFalse(ok)
+        symbol, ok = renderer.symbolForValue2(1.25)
+        self.assertIsNone(symbol)
+        self.assertFalse(ok)
+
+        renderer.stopRender(context)
+
     def testOriginalSymbolForFeature(self):
         # test renderer with features
         fields = QgsFields()
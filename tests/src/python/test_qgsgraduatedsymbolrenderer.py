@@ -15,7 +15,8 @@ __revision__ = '$Format:%H$'
 import qgis  # NOQA
 
 from qgis.testing import unittest, start_app
-from qgis.core import (QgsGraduatedSymbolRenderer,
+from qgis.core import (NULL,
+                       QgsGraduatedSymbolRenderer,
                        QgsRendererRange,
                        QgsRendererRangeLabelFormat,
                        QgsMarkerSymbol,
@@ -25,9 +26,11 @@ from qgis.core import (QgsGraduatedSymbolRenderer,
                        QgsGeometry,
                        QgsPointXY,
                        QgsReadWriteContext,
-                       QgsRenderContext
+                       QgsRenderContext,
+                       QgsField,
+                       QgsFields
                        )
-from qgis.PyQt.QtCore import Qt
+from qgis.PyQt.QtCore import Qt, QVariant
 from qgis.PyQt.QtXml import QDomDocument
 from qgis.PyQt.QtGui import QColor
 
@@ -450,6 +453,65 @@ class TestQgsGraduatedSymbolRenderer(unittest.TestCase):
             '(0.5000-1.0000,1.0000-1.1000,1.1000-1.2000,1.2000-5.0000,)',
             'Quantile classification not correct')
 
+    def testSymbolForFeatureWithOverlappingRanges(self):
+        fields = QgsFields()
+        fields.append(QgsField('value', QVariant.Double))
+
+        renderer = QgsGraduatedSymbolRenderer('value')
+        colors = [QColor(255, 0, 0), QColor(0, 255, 0), QColor(0, 0, 255), QColor(255, 255, 0)]
+        symbols = []
+        for color in colors:
+            symbol = createMarkerSymbol()
+            symbol.setColor(color)
+            symbols.append(symbol)
+        # ranges are not sorted and overlap: the first range containing a value is used
+        renderer.addClassRange(QgsRendererRange(30, 40, symbols[2], 'c', False))
+        renderer.addClassRange(QgsRendererRange(0, 10, symbols[0], 'a'))
+        renderer.addClassRange(QgsRendererRange(5, 20, symbols[1], 'b'))
+        renderer.addClassRange(QgsRendererRange(-10, 50, symbols[3], 'd'))
+
+        context = QgsRenderContext()
+        renderer.startRender(context, fields)
+
+        def colorForValue(value):
+            f = QgsFeature(fields)
+            f.setAttributes([value])
+            symbol = renderer.originalSymbolForFeature(f, context)
+            return symbol.color() if symbol else None
+
+        self.assertEqual(colorForValue(0), colors[0])
+        self.assertEqual(colorForValue(5), colors[0])
+        self.assertEqual(colorForValue(10), colors[0])
+        self.assertEqual(colorForValue(10.5), colors[1])
+        self.assertEqual(colorForValue(20), colors[1])
+        self.assertEqual(colorForValue(25), colors[3])
+        self.assertEqual(colorForValue(-10), colors[3])
+        # disabled range
+        self.assertIsNone(colorForValue(35))
+        self.assertIsNone(colorForValue(-10.5))
+        self.assertIsNone(colorForValue(50.5))
+        self.assertIsNone(colorForValue(NULL))
+
+        # changing the ranges while rendering updates the lookup
+        renderer.updateRangeUpperValue(1, 25)
+        self.assertEqual(colorForValue(22), colors[0])
+        renderer.updateRangeLowerValue(3, 60)
+        self.assertIsNone(colorForValue(27))
+        renderer.moveClass(2, 1)
+        self.assertEqual(colorForValue(5), colors[1])
+        renderer.deleteClass(1)
+        self.assertEqual(colorForValue(15), colors[0])
+        symbol = createMarkerSymbol()
+        symbol.setColor(colors[1])
+        renderer.addClassRange(QgsRendererRange(10, 20, symbol, 'b'))
+        self.assertEqual(colorForValue(15), colors[0])
+        renderer.sortByValue(Qt.DescendingOrder)
+        self.assertEqual(colorForValue(15), colors[1])
+        renderer.sortByLabel()
+        self.assertEqual(colorForValue(15), colors[0])
+
+        renderer.stopRender(context)
+
     def testUsedAttributes(self):
         renderer = QgsGraduatedSymbolRenderer()
         ctx = QgsRenderContext()
@@ -163,6 +163,57 @@ class TestQgsMapRenderer(unittest.TestCase):
         self.assertTrue(cache.hasCacheImage('_labels_'))
         self.assertTrue(job.takeLabelingResults())
 
+    def checkRepaintLabeledLayerKeepsOtherLayerImages(self, job_type):
+        """ repainting a labeled layer should not rerender the images of other labeled layers, while still labeling them"""
+        layer = QgsVectorLayer("Point?field=fldtxt:string",
+                               "layer1", "memory")
+        layer2 = QgsVectorLayer("Point?field=fldtxt:string",
+                                "layer2", "memory")
+
+        labelSettings = QgsPalLayerSettings()
+        labelSettings.fieldName = "fldtxt"
+        for vl, x in ((layer, 10), (layer2, 20)):
+            vl.setLabeling(QgsVectorLayerSimpleLabeling(labelSettings))
+            vl.setLabelsEnabled(True)
+            f = QgsFeature(vl.fields())
+            f.setAttributes([vl.name()])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(x, 35)))
+            self.assertTrue(vl.dataProvider().addFeatures([f]))
+
+        settings = QgsMapSettings()
+        settings.setExtent(QgsRectangle(5, 25, 25, 45))
+        settings.setOutputSize(QSize(600, 400))
+        settings.setLayers([layer, layer2])
+
+        cache = QgsMapRendererCache()
+        job = job_type(settings)
+        job.setCache(cache)
+        job.start()
+        job.waitForFinished()
+        self.assertTrue(cache.hasCacheImage(layer.id()))
+        self.assertTrue(cache.hasCacheImage(layer2.id()))
+        self.assertTrue(cache.hasCacheImage('_labels_'))
+        layer2_image = cache.cacheImage(layer2.id())
+
+        layer.triggerRepaint()
+        self.assertFalse(cache.hasCacheImage(layer.id()))
+        self.assertTrue(cache.hasCacheImage(layer2.id()))
+        self.assertFalse(cache.hasCacheImage('_labels_'))
+
+        job = job_type(settings)
+        job.setCache(cache)
+        job.start()
+        job.waitForFinished()
+        self.assertFalse(job.usedCachedLabels())
+        self.assertTrue(cache.hasCacheImage(layer.id()))
+        self.assertEqual(cache.cacheImage(layer2.id()), layer2_image)
+        self.assertTrue(cache.hasCacheImage('_labels_'))
+        self.assertEqual(set(cache.dependentLayers('_labels_')), {layer, layer2})
+
+        # the features of the cached layer are still labeled
+        results = job.takeLabelingResults()
+        self.assertEqual(set(p.layerID for p in results.labelsWithinRect(settings.extent())), {layer.id(), layer2.id()})
+
     def checkAddingNewLabeledLayerInvalidatesLabelCache(self, job_type):
         """ adding a new labeled layer should invalidate any previous label caches"""
         layer = QgsVectorLayer("Point?field=fldtxt:string",
@@ -441,6 +492,7 @@ class TestQgsMapRenderer(unittest.TestCase):
         self.checkRendererUseCachedLabels(renderer)
         self.checkRepaintNonLabeledLayerDoesNotInvalidateLabelCache(renderer)
         self.checkRepaintLabeledLayerInvalidatesLabelCache(renderer)
+        self.checkRepaintLabeledLayerKeepsOtherLayerImages(renderer)
         self.checkAddingNewLabeledLayerInvalidatesLabelCache(renderer)
         self.checkRemovingLabeledLayerInvalidatesLabelCache(renderer)
         self.checkAddingNewNonLabeledLayerKeepsLabelCache(renderer)
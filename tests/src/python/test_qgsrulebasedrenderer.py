@@ -29,7 +29,9 @@ import os
 
 from qgis.PyQt.QtCore import QSize
 
-from qgis.core import (QgsVectorLayer,
+from qgis.core import (NULL,
+                       QgsVectorLayer,
+                       QgsFeature,
                        QgsMapSettings,
                        QgsProject,
                        QgsRectangle,
@@ -184,6 +186,68 @@ class TestQgsRulebasedRenderer(unittest.TestCase):
         cnt = counter.featureCount(elseRule.ruleKey())
         assert cnt == 1
 
+    def testRuleLookup(self):
+        # rules testing the same field are looked up by value instead of being evaluated for every feature
+        vl = QgsVectorLayer('Point?field=class:string&field=n:integer', 'lookup', 'memory')
+        colors = ['#000001', '#000002', '#000003', '#000004', '#000005']
+        symbols = [QgsMarkerSymbol.createSimple({'color': c}) for c in colors]
+
+        rootrule = QgsRuleBasedRenderer.Rule(None)
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[0], 0, 0, '"class" = \'a\''))
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[1], 0, 0, '"class" IN (\'b\', \'c\') AND "n" > 2'))
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[2], 0, 0, '"class" = \'12\' OR "class" = \'x\''))
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[3], 0, 0, '"n" = 5'))
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[4], 0, 0, 'ELSE'))
+        renderer = QgsRuleBasedRenderer(rootrule)
+
+        ctx = QgsRenderContext.fromMapSettings(self.mapsettings)
+        renderer.startRender(ctx, vl.fields())
+
+        def colorsForFeature(attributes):
+            f = QgsFeature(vl.fields())
+            f.setAttributes(attributes)
+            ctx.expressionContext().setFeature(f)
+            return [s.color().name() for s in renderer.symbolsForFeature(f, ctx)]
+
+        self.assertEqual(colorsForFeature(['a', 1]), ['#000001', '#000005'])
+        self.assertEqual(colorsForFeature(['b', 3]), ['#000002', '#000005'])
+        self.assertEqual(colorsForFeature(['b', 1]), ['#000005'])
+        self.assertEqual(colorsForFeature(['c', 5]), ['#000002', '#000004', '#000005'])
+        self.assertEqual(colorsForFeature(['x', 0]), ['#000003', '#000005'])
+        self.assertEqual(colorsForFeature(['12', 0]), ['#000003', '#000005'])
+        # strings are compared as strings by the = operator
+        self.assertEqual(colorsForFeature(['012', 0]), ['#000005'])
+        self.assertEqual(colorsForFeature([NULL, 5]), ['#000004', '#000005'])
+        renderer.stopRender(ctx)
+
+    def testRuleLookupLargeIntegers(self):
+        # values beyond the lookup range are not looked up, so rules testing them must be evaluated
+        vl = QgsVectorLayer('Point?field=id:long', 'lookup', 'memory')
+        colors = ['#000001', '#000002', '#000003']
+        symbols = [QgsMarkerSymbol.createSimple({'color': c}) for c in colors]
+
+        rootrule = QgsRuleBasedRenderer.Rule(None)
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[0], 0, 0, '"id" = 1000000000000000'))
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[1], 0, 0, '"id" = 5'))
+        rootrule.appendChild(QgsRuleBasedRenderer.Rule(symbols[2], 0, 0, '"id" IN (6, -1000000000000001)'))
+        renderer = QgsRuleBasedRenderer(rootrule)
+
+        ctx = QgsRenderContext.fromMapSettings(self.mapsettings)
+        renderer.startRender(ctx, vl.fields())
+
+        def colorsForFeature(attributes):
+            f = QgsFeature(vl.fields())
+            f.setAttributes(attributes)
+            ctx.expressionContext().setFeature(f)
+            return [s.color().name() for s in renderer.symbolsForFeature(f, ctx)]
+
+        self.assertEqual(colorsForFeature([1000000000000000]), ['#000001'])
+        self.assertEqual(colorsForFeature([-1000000000000001]), ['#000003'])
+        self.assertEqual(colorsForFeature([5]), ['#000002'])
+        self.assertEqual(colorsForFeature([6]), ['#000003'])
+        self.assertEqual(colorsForFeature([7]), [])
+        renderer.stopRender(ctx)
+
     def testRefineWithCategories(self):
         # Test refining rule with categories (refs #10815)
 
@@ -125,6 +125,16 @@ class TestQgsServerSettings(unittest.TestCase):
         self.assertEqual(self.settings.cacheSize(), 1024)
         os.environ.pop(env)
 
+    def test_env_streaming_buffer_size(self):
+        env = "QGIS_SERVER_STREAMING_BUFFER_SIZE"
+
+        self.assertEqual(self.settings.streamingBufferSize(), 64 * 1024)
+
+        os.environ[env] = "0"
+        self.settings.load()
+        self.assertEqual(self.settings.streamingBufferSize(), 0)
+        os.environ.pop(env)
+
     def test_env_cache_directory(self):
         env = "QGIS_SERVER_CACHE_DIRECTORY"
 
@@ -30,6 +30,7 @@ from qgis.server import QgsServerRequest
 
 from qgis.testing import unittest
 from qgis.PyQt.QtCore import QSize
+from qgis.PyQt.QtXml import QDomDocument
 
 import osgeo.gdal  # NOQA
 
@@ -117,6 +118,47 @@ class TestQgsServerWFS(QgsServerTestBase):
         for id, req in tests:
             self.wfs_getfeature_compare(id, req)
 
+    def wfs_getfeature_streamed(self, extra_query_string, buffer_size):
+        """Returns the response to a GetFeature request streamed with the given buffer size"""
+        project = self.testdata_path + "test_project_wfs.qgs"
+        query_string = '?MAP=%s&SERVICE=WFS&REQUEST=GetFeature&%s' % (urllib.parse.quote(project), extra_query_string)
+
+        self.server.putenv('QGIS_SERVER_STREAMING_BUFFER_SIZE', str(buffer_size))
+        try:
+            return self._execute_request(query_string)
+        finally:
+            self.server.putenv('QGIS_SERVER_STREAMING_BUFFER_SIZE', '')
+
+    def test_getfeature_streaming(self):
+        """Check that streamed GetFeature responses are the same as buffered ones"""
+        for output_format in ('GML2', 'GML3', 'GeoJSON'):
+            extra_query_string = 'TYPENAME=testlayer&OUTPUTFORMAT=%s' % output_format
+            buffered_header, buffered_body = self.wfs_getfeature_streamed(extra_query_string, 0)
+            # a one byte buffer sends every write on its own
+            streamed_header, streamed_body = self.wfs_getfeature_streamed(extra_query_string, 1)
+            self.assertTrue(buffered_body)
+            self.assertEqual(streamed_body, buffered_body, output_format)
+
+    def test_getfeature_gml_dom_serialization(self):
+        """Check that the feature members are written as QDom serializes them"""
+        for output_format in ('GML2', 'GML3'):
+            header, body = self.wfs_getfeature_streamed('TYPENAME=testlayer&OUTPUTFORMAT=%s' % output_format, 1)
+            members = re.findall(b'<gml:featureMember>.*?</gml:featureMember>\n', body, re.DOTALL)
+            self.assertTrue(members, output_format)
+
+            for member in members:
+                doc = QDomDocument()
+                self.assertTrue(doc.setContent(member, False)[0], member)
+
+                # attribute elements always hold a text node, even an empty one
+                child = doc.documentElement().firstChildElement().firstChildElement()
+                while not child.isNull():
+                    if not child.hasChildNodes():
+                        child.appendChild(doc.createTextNode(''))
+                    child = child.nextSiblingElement()
+
+                self.assertEqual(bytes(doc.toByteArray()), member, output_format)
+
     def test_wfs_getcapabilities_100_url(self):
         """Check that URL in GetCapabilities response is complete"""
         # empty url in project
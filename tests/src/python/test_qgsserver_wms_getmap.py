@@ -185,6 +185,35 @@ class TestQgsServerWMSGetMap(QgsServerTestBase):
         r, h = self._result(self._execute_request(qs))
         self._img_diff_error(r, h, "WMS_GetMap_Basic4")
 
+    def test_wms_getmap_dxf_streaming(self):
+        """Check that streamed DXF exports are the same as buffered ones"""
+        qs = "?" + "&".join(["%s=%s" % i for i in list({
+            "MAP": urllib.parse.quote(self.projectPath),
+            "SERVICE": "WMS",
+            "VERSION": "1.1.1",
+            "REQUEST": "GetMap",
+            "LAYERS": "Country",
+            "STYLES": "",
+            "FORMAT": "application/dxf",
+            "BBOX": "-16817707,-4710778,5696513,14587125",
+            "HEIGHT": "500",
+            "WIDTH": "500",
+            "CRS": "EPSG:3857"
+        }.items())])
+
+        self.server.putenv('QGIS_SERVER_STREAMING_BUFFER_SIZE', '0')
+        buffered_header, buffered_body = self._execute_request(qs)
+        # a small buffer sends the export in many chunks
+        self.server.putenv('QGIS_SERVER_STREAMING_BUFFER_SIZE', '1024')
+        streamed_header, streamed_body = self._execute_request(qs)
+        self.server.putenv('QGIS_SERVER_STREAMING_BUFFER_SIZE', '')
+
+        self.assertIn(b'Content-Length', buffered_header)
+        self.assertNotIn(b'Content-Length', streamed_header)
+        self.assertGreater(len(buffered_body), 1024)
+        self.assertTrue(buffered_body.endswith(b'EOF\n'))
+        self.assertEqual(streamed_body, buffered_body)
+
     def test_wms_getmap_complex_labeling(self):
         qs = "?" + "&".join(["%s=%s" % i for i in list({
             "MAP": urllib.parse.quote(self.projectPath),
@@ -266,6 +266,77 @@ class TestQgsVectorFileWriter(unittest.TestCase):
         for f in features:
             self.assertTrue(f.geometry().intersects(options.filterExtent))
 
+    def testWriteManyFeaturesWithReprojection(self):
+        """Check writing features in several batches, with reprojection."""
+        ml = QgsVectorLayer('Point?crs=epsg:4326&field=id:integer&field=name:string', 'test', 'memory')
+        self.assertTrue(ml.isValid())
+
+        features = []
+        for i in range(2500):
+            f = QgsFeature(ml.fields())
+            f.setAttributes([i, 'feature {}'.format(i)])
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i / 100.0, 45)))
+            features.append(f)
+        self.assertTrue(ml.dataProvider().addFeatures(features)[0])
+
+        options = QgsVectorFileWriter.SaveVectorOptions()
+        options.driverName = 'GPKG'
+        options.ct = QgsCoordinateTransform(ml.crs(), QgsCoordinateReferenceSystem.fromEpsgId(3857), QgsProject.instance())
+
+        dest_file_name = os.path.join(str(QDir.tempPath()), 'many_features_transform.gpkg')
+        write_result, error_message = QgsVectorFileWriter.writeAsVectorFormat(
+            ml,
+            dest_file_name,
+            options)
+        self.assertEqual(write_result, QgsVectorFileWriter.NoError, error_message)
+
+        # features are written in order, with their reprojected geometries
+        created_layer = QgsVectorLayer(dest_file_name, 'test', 'ogr')
+        self.assertTrue(created_layer.isValid())
+        self.assertEqual(created_layer.crs().authid(), 'EPSG:3857')
+        created_features = [f for f in created_layer.getFeatures()]
+        self.assertEqual(len(created_features), 2500)
+        self.assertEqual([f['id'] for f in created_features], list(range(2500)))
+        self.assertEqual(created_features[1234]['name'], 'feature 1234')
+        self.assertAlmostEqual(created_features[100].geometry().asPoint().x(), 111319.49, 1)
+
+        del created_layer
+        os.unlink(dest_file_name)
+
+    def testWriteManyFeaturesWithReprojectionError(self):
+        """Check that writing in several batches stops at the first feature which cannot be reprojected."""
+        ml = QgsVectorLayer('Point?crs=epsg:4326&field=id:integer', 'test', 'memory')
+        self.assertTrue(ml.isValid())
+
+        features = []
+        for i in range(2500):
+            f = QgsFeature(ml.fields())
+            f.setAttributes([i])
+            # the latitude of feature 1500, in the second batch, is out of range
+            f.setGeometry(QgsGeometry.fromPointXY(QgsPointXY(i / 100.0, 100 if i == 1500 else 45)))
+            features.append(f)
+        self.assertTrue(ml.dataProvider().addFeatures(features)[0])
+
+        options = QgsVectorFileWriter.SaveVectorOptions()
+        options.driverName = 'GPKG'
+        options.ct = QgsCoordinateTransform(ml.crs(), QgsCoordinateReferenceSystem.fromEpsgId(3857), QgsProject.instance())
+
+        dest_file_name = os.path.join(str(QDir.tempPath()), 'many_features_transform_error.gpkg')
+        write_result, error_message = QgsVectorFileWriter.writeAsVectorFormat(
+            ml,
+            dest_file_name,
+            options)
+        self.assertEqual(write_result, QgsVectorFileWriter.ErrProjection)
+        self.assertIn('Failed to transform', error_message)
+
+        # the features preceding the failing one are written, in order
+        created_layer = QgsVectorLayer(dest_file_name, 'test', 'ogr')
+        self.assertTrue(created_layer.isValid())
+        self.assertEqual([f['id'] for f in created_layer.getFeatures()], list(range(1500)))
+
+        del created_layer
+        os.unlink(dest_file_name)
+
     def testDateTimeWriteTabfile(self):
         """Check writing date and time fields to an MapInfo tabfile."""
         ml = QgsVectorLayer(
@@ -0,0 +1,219 @@
+/***************************************************************************
+     testqgsserverstreamingdevice.cpp
+     --------------------------------
+    Date                 : October 2018
+    Copyright            : (C) 2018 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QBuffer>
+#include <QTextStream>
+#include <algorithm>
+
+#include "qgsbufferserverresponse.h"
+#include "qgsserverstreamingdevice.h"
+
+/**
+ * Buffer response keeping track of its flushes, and which may lose its output device.
+ */
+class TestServerResponse : public QgsBufferServerResponse
+{
+  public:
+
+    QIODevice *io() override
+    {
+      if ( mBroken )
+        return nullptr;
+      if ( mReadOnly )
+        return &mReadOnlyBuffer;
+      return QgsBufferServerResponse::io();
+    }
+
+    void flush() override
+    {
+      mFlushes++;
+      mMaxFlushedSize = std::max( mMaxFlushedSize, QgsBufferServerResponse::io()->size() );
+      QgsBufferServerResponse::flush();
+    }
+
+    int mFlushes = 0;
+    qint64 mMaxFlushedSize = 0;
+    bool mBroken = false;
+    bool mReadOnly = false;
+    QBuffer mReadOnlyBuffer;
+};
+
+class TestQgsServerStreamingDevice : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void boundedBuffer();
+    void backPressure();
+    void unbounded();
+    void close();
+    void error();
+};
+
+void TestQgsServerStreamingDevice::boundedBuffer()
+{
+  TestServerResponse response;
+  QgsServerStreamingDevice device( response, 16 );
+  QVERIFY( device.isOpen() );
+  QVERIFY( device.isWritable() );
+  QVERIFY( !device.isReadable() );
+  QVERIFY( device.isSequential() );
+
+  // below the buffer size, the data is left in the response
+  QCOMPARE( device.write( "0123456789" ), qint64( 10 ) );
+  QCOMPARE( response.mFlushes, 0 );
+  QVERIFY( !response.headersSent() );
+  QCOMPARE( response.io()->size(), qint64( 10 ) );
+  QVERIFY( response.body().isEmpty() );
+
+  // reaching it sends the buffered data
+  QCOMPARE( device.write( "abcdef" ), qint64( 6 ) );
+  QCOMPARE( response.mFlushes, 1 );
+  QVERIFY( response.headersSent() );
+  QCOMPARE( response.io()->size(), qint64( 0 ) );
+  QCOMPARE( response.body(), QByteArray( "0123456789abcdef" ) );
+
+  QCOMPARE( device.write( "ghij" ), qint64( 4 ) );
+  QCOMPARE( response.mFlushes, 1 );
+  QCOMPARE( response.io()->size(), qint64( 4 ) );
+
+  response.finish();
+  QCOMPARE( response.body(), QByteArray( "0123456789abcdefghij" ) );
+}
+
+void TestQgsServerStreamingDevice::backPressure()
+{
+  // a producer writing through a text stream never has more than one chunk pending
+  TestServerResponse response;
+  const qint64 bufferSize = 1024;
+  QgsServerStreamingDevice device( response, bufferSize );
+
+  QByteArray expected;
+  QTextStream stream( &device );
+  for ( int i = 0; i < 10000; ++i )
+  {
+    const QString line = QStringLiteral( "<feature id=\"%1\"/>\n" ).arg( i );
+    stream << line;
+    expected.append( line.toUtf8() );
+    if ( i % 100 == 0 )
+    {
+      stream.flush();
+      QVERIFY( response.io()->size() < bufferSize );
+    }
+  }
+  stream.flush();
+  QCOMPARE( stream.status(), QTextStream::Ok );
+
+  // the text stream writes its own buffer at once, so a flush holds at most the buffer size and one write
+  QVERIFY( response.mFlushes >= expected.size() / ( 4 * bufferSize ) );
+  QVERIFY( response.mMaxFlushedSize < bufferSize + 16 * 1024 );
+
+  device.close();
+  QCOMPARE( response.io()->size(), qint64( 0 ) );
+  response.finish();
+  QCOMPARE( response.body(), expected );
+  QVERIFY( response.header( QStringLiteral( "Content-Length" ) ).isEmpty() );
+}
+
+void TestQgsServerStreamingDevice::unbounded()
+{
+  TestServerResponse response;
+  QgsServerStreamingDevice device( response, 0 );
+
+  const QByteArray data( 256 * 1024, 'x' );
+  QCOMPARE( device.write( data ), qint64( data.size() ) );
+  QCOMPARE( device.write( data ), qint64( data.size() ) );
+  device.close();
+
+  // nothing is sent before the response is finished, with its content length
+  QCOMPARE( response.mFlushes, 0 );
+  QVERIFY( !response.headersSent() );
+  response.finish();
+  QCOMPARE( response.header( QStringLiteral( "Content-Length" ) ), QString::number( 2 * data.size() ) );
+  QCOMPARE( response.body(), data + data );
+}
+
+void TestQgsServerStreamingDevice::close()
+{
+  // small outputs stay in the response, to be sent with a content length
+  {
+    TestServerResponse response;
+    {
+      QgsServerStreamingDevice device( response, 16 );
+      device.write( "0123" );
+      device.close();
+      QVERIFY( !device.isOpen() );
+      QCOMPARE( response.mFlushes, 0 );
+      QCOMPARE( response.io()->size(), qint64( 4 ) );
+
+      // writing to a closed device fails
+      QTest::ignoreMessage( QtWarningMsg, "QIODevice::write (QIODevice): device not open" );
+      QCOMPARE( device.write( "4567" ), qint64( -1 ) );
+      QCOMPARE( response.io()->size(), qint64( 4 ) );
+    }
+    response.finish();
+    QCOMPARE( response.header( QStringLiteral( "Content-Length" ) ), QStringLiteral( "4" ) );
+    QCOMPARE( response.body(), QByteArray( "0123" ) );
+  }
+
+  // once streamed, the tail is sent when the device is closed
+  {
+    TestServerResponse response;
+    {
+      QgsServerStreamingDevice device( response, 16 );
+      device.write( "0123456789abcdef" );
+      device.write( "ghij" );
+      QCOMPARE( response.mFlushes, 1 );
+    }
+    QCOMPARE( response.mFlushes, 2 );
+    QCOMPARE( response.io()->size(), qint64( 0 ) );
+    QCOMPARE( response.body(), QByteArray( "0123456789abcdefghij" ) );
+  }
+}
+
+void TestQgsServerStreamingDevice::error()
+{
+  // response without output device
+  {
+    TestServerResponse response;
+    QgsServerStreamingDevice device( response, 16 );
+    response.mBroken = true;
+    QCOMPARE( device.write( "0123" ), qint64( -1 ) );
+    QCOMPARE( device.errorString(), QStringLiteral( "The server response has no output device" ) );
+    QCOMPARE( response.mFlushes, 0 );
+
+    // and the failure is reported to text streams
+    QTextStream stream( &device );
+    stream << "0123";
+    stream.flush();
+    QCOMPARE( stream.status(), QTextStream::WriteFailed );
+  }
+
+  // response device refusing the data
+  {
+    TestServerResponse response;
+    response.mReadOnlyBuffer.open( QIODevice::ReadOnly );
+    response.mReadOnly = true;
+    QgsServerStreamingDevice device( response, 16 );
+    QTest::ignoreMessage( QtWarningMsg, "QIODevice::write (QBuffer): ReadOnly device" );
+    QCOMPARE( device.write( "0123" ), qint64( -1 ) );
+    QVERIFY( device.errorString().startsWith( QStringLiteral( "Unable to write to the server response" ) ) );
+    QCOMPARE( response.mFlushes, 0 );
+  }
+}
+
+QGSTEST_MAIN( TestQgsServerStreamingDevice )
+#include "testqgsserverstreamingdevice.moc"